@@ -0,0 +1,186 @@
+#include "BenchmarkScript.h"
+#include "GpuProfiler.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Nearest-rank percentile of sorted values
+    double percentile(const std::vector<double>& sorted, double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+        return sorted[std::min(std::max(rank, static_cast<size_t>(1)), sorted.size()) - 1];
+    }
+
+    std::string jsonString(const std::string& text) {
+        std::string quoted = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                quoted += '\\';
+            }
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+}
+
+BenchmarkScript::BenchmarkScript()
+    : frames(600)
+    , warmupFrames(60)
+    , deltaTime(1.0f / 60.0f)
+{
+}
+
+bool BenchmarkScript::load(const std::string& scriptPath) {
+    std::ifstream file(scriptPath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open benchmark script " << scriptPath << std::endl;
+        return false;
+    }
+    path = scriptPath;
+    name = scriptPath;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream tokens(line);
+        std::string keyword;
+        if (!(tokens >> keyword)) {
+            continue;
+        }
+
+        bool valid = true;
+        if (keyword == "name") {
+            std::getline(tokens >> std::ws, name);
+            name.erase(name.find_last_not_of(" \t\r") + 1);
+        } else if (keyword == "mode") {
+            valid = static_cast<bool>(tokens >> renderMode);
+        } else if (keyword == "frames") {
+            valid = (tokens >> frames) && frames > 0;
+        } else if (keyword == "warmup") {
+            valid = (tokens >> warmupFrames) && warmupFrames >= 0;
+        } else if (keyword == "delta_time") {
+            valid = (tokens >> deltaTime) && deltaTime > 0.0f;
+        } else if (keyword == "camera") {
+            BenchmarkCameraKey key;
+            valid = static_cast<bool>(tokens >> key.time >> key.position.x >> key.position.y >> key.position.z
+                                             >> key.yaw >> key.pitch);
+            if (valid && !cameraKeys.empty() && key.time <= cameraKeys.back().time) {
+                std::cerr << scriptPath << ":" << lineNumber << ": camera keys must have increasing times" << std::endl;
+                return false;
+            }
+            cameraKeys.push_back(key);
+        } else if (keyword == "spawn" || keyword == "shoot" || keyword == "material") {
+            BenchmarkEvent event;
+            event.type = keyword == "spawn" ? BenchmarkEventType::SpawnCube
+                       : keyword == "shoot" ? BenchmarkEventType::Shoot
+                       : BenchmarkEventType::CycleMaterial;
+            valid = static_cast<bool>(tokens >> event.time);
+            events.push_back(event);
+        } else {
+            std::cerr << scriptPath << ":" << lineNumber << ": unknown keyword '" << keyword << "'" << std::endl;
+            return false;
+        }
+
+        if (!valid) {
+            std::cerr << scriptPath << ":" << lineNumber << ": invalid arguments for '" << keyword << "'" << std::endl;
+            return false;
+        }
+    }
+
+    std::stable_sort(events.begin(), events.end(),
+                     [](const BenchmarkEvent& a, const BenchmarkEvent& b) { return a.time < b.time; });
+
+    std::cout << "Benchmark '" << name << "': " << warmupFrames << " warmup + " << frames << " frames at "
+              << deltaTime * 1000.0f << " ms, " << cameraKeys.size() << " camera keys, "
+              << events.size() << " events" << std::endl;
+    return true;
+}
+
+bool BenchmarkScript::sampleCamera(float time, glm::vec3& position, float& yaw, float& pitch) const {
+    if (cameraKeys.empty()) {
+        return false;
+    }
+
+    auto next = std::upper_bound(cameraKeys.begin(), cameraKeys.end(), time,
+                                 [](float t, const BenchmarkCameraKey& key) { return t < key.time; });
+    if (next == cameraKeys.begin() || next == cameraKeys.end()) {
+        const BenchmarkCameraKey& key = next == cameraKeys.begin() ? cameraKeys.front() : cameraKeys.back();
+        position = key.position;
+        yaw = key.yaw;
+        pitch = key.pitch;
+        return true;
+    }
+
+    const BenchmarkCameraKey& a = *(next - 1);
+    const BenchmarkCameraKey& b = *next;
+    float t = (time - a.time) / (b.time - a.time);
+    position = glm::mix(a.position, b.position, t);
+    yaw = a.yaw + (b.yaw - a.yaw) * t;
+    pitch = a.pitch + (b.pitch - a.pitch) * t;
+    return true;
+}
+
+void BenchmarkScript::collectEvents(float from, float to, std::vector<BenchmarkEventType>& out) const {
+    for (const BenchmarkEvent& event : events) {
+        if (event.time >= from && event.time < to) {
+            out.push_back(event.type);
+        }
+    }
+}
+
+FrameTimeSummary BenchmarkScript::summarize(std::vector<double> frameTimesMs) {
+    FrameTimeSummary summary;
+    if (frameTimesMs.empty()) {
+        return summary;
+    }
+
+    std::sort(frameTimesMs.begin(), frameTimesMs.end());
+    double total = 0.0;
+    for (double ms : frameTimesMs) {
+        total += ms;
+    }
+    summary.average = total / frameTimesMs.size();
+    summary.p50 = percentile(frameTimesMs, 50.0);
+    summary.p95 = percentile(frameTimesMs, 95.0);
+    summary.p99 = percentile(frameTimesMs, 99.0);
+    summary.max = frameTimesMs.back();
+    return summary;
+}
+
+std::string BenchmarkScript::formatResults(const FrameTimeSummary& summary, size_t measuredFrames,
+                                           const GpuProfiler& profiler, const std::string& activeMode,
+                                           bool headless) const {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(4);
+    json << "{\n";
+    json << "  \"benchmark\": " << jsonString(name) << ",\n";
+    json << "  \"script\": " << jsonString(path) << ",\n";
+    json << "  \"render_mode\": " << jsonString(activeMode.empty() ? "default" : activeMode) << ",\n";
+    json << "  \"headless\": " << (headless ? "true" : "false") << ",\n";
+    json << "  \"frames\": " << measuredFrames << ",\n";
+    json << "  \"warmup_frames\": " << warmupFrames << ",\n";
+    json << "  \"delta_time_ms\": " << deltaTime * 1000.0f << ",\n";
+    json << "  \"frame_time_ms\": {\"average\": " << summary.average << ", \"p50\": " << summary.p50
+         << ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max << "},\n";
+
+    // Mean GPU time per resolved frame; a pass absent from some frames counts zero for them
+    uint32_t gpuFrames = profiler.getTotalFrames();
+    json << "  \"gpu_frames\": " << gpuFrames << ",\n";
+    json << "  \"gpu_frame_ms\": " << (gpuFrames ? profiler.getFrameTotalMs() / gpuFrames : 0.0) << ",\n";
+    json << "  \"gpu_passes_ms\": [";
+    const std::vector<GpuScopeTiming>& timings = profiler.getTimings();
+    for (size_t i = 0; i < timings.size(); i++) {
+        const GpuScopeTiming& timing = timings[i];
+        json << (i ? "," : "") << "\n    {\"name\": " << jsonString(timing.name)
+             << ", \"parent\": " << (timing.parent >= 0 ? jsonString(timings[timing.parent].name) : "null")
+             << ", \"average\": " << (gpuFrames ? timing.totalMs / gpuFrames : 0.0) << "}";
+    }
+    json << (timings.empty() ? "" : "\n  ") << "]\n";
+    json << "}\n";
+    return json.str();
+}
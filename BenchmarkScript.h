@@ -0,0 +1,79 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+class GpuProfiler;
+
+// Scripted actions, fired once when scene time reaches them
+enum class BenchmarkEventType {
+    SpawnCube,
+    Shoot,
+    CycleMaterial
+};
+
+struct BenchmarkEvent {
+    float time;
+    BenchmarkEventType type;
+};
+
+// Camera keyframe; position, yaw and pitch (degrees) are interpolated linearly between keys
+struct BenchmarkCameraKey {
+    float time;
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+};
+
+// Frame-time distribution of the measured frames, in milliseconds
+struct FrameTimeSummary {
+    double average = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// Deterministic run for "--benchmark <script>". Every frame advances the scene by the same
+// deltaTime, the camera follows the keyframes and events fire at fixed scene times, so only the
+// measured frame times differ between runs. Script lines ('#' starts a comment):
+//   name <text>                        mode raytracing|forward|forward-plus
+//   frames <count>                     warmup <count>        delta_time <seconds>
+//   camera <time> <x> <y> <z> <yaw> <pitch>
+//   spawn <time>    shoot <time>    material <time>
+class BenchmarkScript {
+public:
+    BenchmarkScript();
+
+    bool load(const std::string& path);
+
+    const std::string& getPath() const { return path; }
+    const std::string& getName() const { return name; }
+    const std::string& getRenderMode() const { return renderMode; }    // empty keeps the default
+    int getFrames() const { return frames; }
+    int getWarmupFrames() const { return warmupFrames; }
+    float getDeltaTime() const { return deltaTime; }
+
+    // Camera pose at a scene time (held before the first and after the last key); false without keys
+    bool sampleCamera(float time, glm::vec3& position, float& yaw, float& pitch) const;
+    // Appends the events with from <= time < to, in time order
+    void collectEvents(float from, float to, std::vector<BenchmarkEventType>& out) const;
+
+    static FrameTimeSummary summarize(std::vector<double> frameTimesMs);
+
+    // JSON report: frame-time summary plus the mean GPU time of every profiled pass.
+    // activeMode is the mode actually rendered ("--render-mode" overrides the script)
+    std::string formatResults(const FrameTimeSummary& summary, size_t measuredFrames,
+                              const GpuProfiler& profiler, const std::string& activeMode, bool headless) const;
+
+private:
+    std::string path;
+    std::string name;
+    std::string renderMode;
+    int frames;
+    int warmupFrames;
+    float deltaTime;
+    std::vector<BenchmarkCameraKey> cameraKeys;
+    std::vector<BenchmarkEvent> events;
+};
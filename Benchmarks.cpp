@@ -0,0 +1,360 @@
+#include "Benchmarks.h"
+#include "GraphicsManager.h"
+#include "MeshOptimizer.h"
+#include "FrustumCuller.h"
+#include "RenderQueue.h"
+#include "CpuProfiler.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <array>
+#include <thread>
+#include <atomic>
+
+namespace {
+    double elapsedMs(std::chrono::high_resolution_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    // Triangles rotated to start at their smallest index (winding kept), sorted: equal for two
+    // index buffers that draw the same triangles in any order
+    std::vector<std::array<unsigned int, 3>> triangleSet(const std::vector<unsigned int>& indices) {
+        std::vector<std::array<unsigned int, 3>> triangles;
+        triangles.reserve(indices.size() / 3);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            std::array<unsigned int, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            triangles.push_back(triangle);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // Vertex data of every corner in index order: unchanged by a correct vertex fetch remap
+    std::vector<float> cornerData(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+                                  size_t vertexStride) {
+        std::vector<float> corners;
+        corners.reserve(indices.size() * vertexStride);
+        for (unsigned int index : indices) {
+            corners.insert(corners.end(), vertices.begin() + index * vertexStride,
+                           vertices.begin() + (index + 1) * vertexStride);
+        }
+        return corners;
+    }
+}
+
+bool Benchmarks::run(const std::string& name) {
+    bool all = (name == "all");
+    bool found = false;
+
+    bool passed = true;
+
+    if (all || name == "mesh") {
+        passed = runMeshOptimizer() && passed;
+        found = true;
+    }
+
+    if (all || name == "culling") {
+        passed = runFrustumCulling() && passed;
+        found = true;
+    }
+
+    if (all || name == "renderqueue") {
+        passed = runRenderQueueSort() && passed;
+        found = true;
+    }
+
+    if (all || name == "profiler") {
+        runCpuProfiler();
+        found = true;
+    }
+
+    if (!found) {
+        std::cerr << "Unknown micro-benchmark: " << name << " (available: mesh, culling, renderqueue, profiler, all)" << std::endl;
+    }
+    return found && passed;
+}
+
+bool Benchmarks::runMeshOptimizer() {
+    std::cout << "=== Mesh optimizer (sphere meshes, FIFO cache of 16) ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    const size_t stride = 8;
+    const float overdrawThreshold = 1.05f;
+    const int segmentCounts[] = { 16, 32, 64, 128, 256 };
+    bool passed = true;
+    // Each tessellation as generated, then with its triangles shuffled (no cache locality)
+    for (int shuffled = 0; shuffled < 2; shuffled++) {
+        for (int segments : segmentCounts) {
+            std::vector<float> vertices;
+            std::vector<unsigned int> indices;
+            GraphicsManager::createSphereMesh(vertices, indices, 0.5f, segments);
+            size_t vertexCount = vertices.size() / stride;
+            if (shuffled) {
+                std::vector<size_t> order(indices.size() / 3);
+                for (size_t t = 0; t < order.size(); t++) {
+                    order[t] = t;
+                }
+                std::shuffle(order.begin(), order.end(), std::mt19937(segments));
+                const std::vector<unsigned int> generated = indices;
+                for (size_t t = 0; t < order.size(); t++) {
+                    std::copy_n(generated.begin() + order[t] * 3, 3, indices.begin() + t * 3);
+                }
+            }
+            const std::vector<std::array<unsigned int, 3>> originalTriangles = triangleSet(indices);
+
+            VertexCacheStats before = MeshOptimizer::analyzeVertexCache(indices, vertexCount);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            MeshOptimizer::optimizeVertexCache(indices, vertexCount);
+            double cacheMs = elapsedMs(start);
+            VertexCacheStats afterCache = MeshOptimizer::analyzeVertexCache(indices, vertexCount);
+            bool cacheKeepsTriangles = triangleSet(indices) == originalTriangles;
+
+            start = std::chrono::high_resolution_clock::now();
+            MeshOptimizer::optimizeOverdraw(indices, vertices, stride, overdrawThreshold);
+            double overdrawMs = elapsedMs(start);
+            VertexCacheStats afterOverdraw = MeshOptimizer::analyzeVertexCache(indices, vertexCount);
+            bool overdrawKeepsTriangles = triangleSet(indices) == originalTriangles;
+
+            const std::vector<float> corners = cornerData(vertices, indices, stride);
+            start = std::chrono::high_resolution_clock::now();
+            MeshOptimizer::optimizeVertexFetch(vertices, indices, stride);
+            double fetchMs = elapsedMs(start);
+            VertexCacheStats after = MeshOptimizer::analyzeVertexCache(indices, vertexCount);
+            bool fetchKeepsCorners = vertices.size() == vertexCount * stride && cornerData(vertices, indices, stride) == corners;
+
+            std::cout << (shuffled ? "shuffled " : "segments ") << std::setw(3) << segments
+                      << " | tris " << std::setw(6) << before.triangleCount
+                      << " | ACMR " << before.acmr << " -> " << afterCache.acmr << " -> " << after.acmr
+                      << " | ATVR " << before.atvr << " -> " << after.atvr
+                      << " | cache " << cacheMs << "ms, overdraw " << overdrawMs << "ms, fetch " << fetchMs << "ms";
+
+            std::vector<const char*> failures;
+            if (!cacheKeepsTriangles) {
+                failures.push_back("vertex cache order changed the triangles");
+            }
+            if (!overdrawKeepsTriangles) {
+                failures.push_back("overdraw order changed the triangles");
+            }
+            if (!fetchKeepsCorners) {
+                failures.push_back("vertex fetch remap moved a corner to other vertex data");
+            }
+            if (afterCache.acmr > before.acmr) {
+                failures.push_back("vertex cache order raised ACMR");
+            }
+            // The overdraw pass may trade cache hits up to its threshold, and only against the
+            // cache-optimized order
+            if (afterOverdraw.acmr > afterCache.acmr * overdrawThreshold + 1e-4f) {
+                failures.push_back("overdraw order raised ACMR past its threshold");
+            }
+            if (after.acmr > before.acmr) {
+                failures.push_back("ACMR worse than before optimization");
+            }
+            std::cout << (failures.empty() ? " - OK" : " - FAILED") << std::endl;
+            for (const char* failure : failures) {
+                std::cerr << "  " << failure << std::endl;
+            }
+            passed = passed && failures.empty();
+        }
+    }
+    std::cout << (passed ? "Mesh optimizer checks passed" : "Mesh optimizer checks FAILED") << std::endl;
+    return passed;
+}
+
+bool Benchmarks::runFrustumCulling() {
+    std::cout << "=== Frustum culling (bounding spheres, SoA layout) ===" << std::endl;
+    std::cout << "Best available path: " << FrustumCuller::pathName(FrustumCuller::bestPath()) << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    // Camera at the origin looking down -Z; objects fill a cube around it so about 5% are
+    // visible and most SIMD batches take the early-out for fully culled lanes
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1920.0f / 1080.0f, 0.1f, 150.0f);
+    Frustum frustum = FrustumCuller::extractFrustum(projection * view);
+
+    const CullingPath paths[] = { CullingPath::Scalar, CullingPath::SSE, CullingPath::AVX2 };
+    const size_t counts[] = { 10000, 100000, 1000000 };
+    bool passed = true;
+
+    for (size_t count : counts) {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> radius(0.05f, 1.0f);
+
+        SphereBounds bounds;
+        bounds.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            bounds.add(glm::vec3(position(rng), position(rng), position(rng)), radius(rng));
+        }
+
+        // Repeat small sets so each measurement covers a few million sphere tests
+        int iterations = static_cast<int>(std::max<size_t>(1, 4000000 / count));
+
+        std::vector<uint32_t> reference;
+        FrustumCuller::cullSpheres(frustum, bounds, reference, CullingPath::Scalar);
+
+        for (CullingPath path : paths) {
+            if (!FrustumCuller::isPathSupported(path)) {
+                std::cout << std::setw(7) << count << " spheres | " << std::setw(6) << FrustumCuller::pathName(path)
+                          << " | not supported on this CPU" << std::endl;
+                continue;
+            }
+
+            std::vector<uint32_t> visible;
+            visible.reserve(count);
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++) {
+                FrustumCuller::cullSpheres(frustum, bounds, visible, path);
+            }
+            double ms = elapsedMs(start) / iterations;
+
+            std::cout << std::setw(7) << count << " spheres | " << std::setw(6) << FrustumCuller::pathName(path)
+                      << " | " << std::setw(8) << ms << "ms"
+                      << " | " << std::setw(6) << (ms * 1.0e6 / count) << "ns/sphere"
+                      << " | visible " << visible.size()
+                      << (visible == reference ? "" : " (MISMATCH vs scalar)")
+                      << std::endl;
+            passed = passed && visible == reference;
+        }
+    }
+    std::cout << (passed ? "Frustum culling checks passed" : "Frustum culling checks FAILED") << std::endl;
+    return passed;
+}
+
+bool Benchmarks::runRenderQueueSort() {
+    std::cout << "=== Render queue sort (64-bit keys: pass, program, material, depth) ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    const size_t counts[] = { 1000, 10000, 100000, 1000000 };
+    bool passed = true;
+    for (size_t count : counts) {
+        // A handful of programs/materials and random depths, as in a typical frame
+        std::mt19937 rng(99);
+        std::uniform_int_distribution<uint32_t> program(0, 3);
+        std::uniform_int_distribution<uint32_t> material(0, 31);
+        std::uniform_real_distribution<float> depth(0.1f, 100.0f);
+
+        RenderQueue queue;
+        queue.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            queue.push(RenderQueue::makeKey(RenderPass::Opaque, program(rng), material(rng), depth(rng), 100.0f),
+                       static_cast<uint32_t>(i));
+        }
+        std::vector<DrawPacket> unsorted = queue.getPackets();
+
+        uint32_t unsortedPrograms = 0, unsortedMaterials = 0;
+        queue.countStateChanges(unsortedPrograms, unsortedMaterials);
+
+        int iterations = static_cast<int>(std::max<size_t>(1, 2000000 / count));
+        double radixMs = 0.0;
+        for (int i = 0; i < iterations; i++) {
+            queue.clear();
+            for (const DrawPacket& packet : unsorted) {
+                queue.push(packet.key, packet.objectIndex);
+            }
+            auto start = std::chrono::high_resolution_clock::now();
+            queue.sort();
+            radixMs += elapsedMs(start);
+        }
+        radixMs /= iterations;
+
+        double stdMs = 0.0;
+        std::vector<DrawPacket> reference;
+        for (int i = 0; i < iterations; i++) {
+            reference = unsorted;
+            auto start = std::chrono::high_resolution_clock::now();
+            std::stable_sort(reference.begin(), reference.end(),
+                             [](const DrawPacket& a, const DrawPacket& b) { return a.key < b.key; });
+            stdMs += elapsedMs(start);
+        }
+        stdMs /= iterations;
+
+        bool matches = queue.getPackets().size() == reference.size();
+        for (size_t i = 0; i < count && matches; i++) {
+            matches = queue.getPackets()[i].key == reference[i].key
+                   && queue.getPackets()[i].objectIndex == reference[i].objectIndex;
+        }
+
+        uint32_t sortedPrograms = 0, sortedMaterials = 0;
+        queue.countStateChanges(sortedPrograms, sortedMaterials);
+
+        std::cout << std::setw(7) << count << " packets | radix " << std::setw(8) << radixMs << "ms"
+                  << " | std::stable_sort " << std::setw(8) << stdMs << "ms"
+                  << " | program switches " << unsortedPrograms << " -> " << sortedPrograms
+                  << " | material switches " << unsortedMaterials << " -> " << sortedMaterials
+                  << (matches ? "" : " (MISMATCH vs std::stable_sort)") << std::endl;
+        passed = passed && matches;
+    }
+    std::cout << (passed ? "Render queue sort checks passed" : "Render queue sort checks FAILED") << std::endl;
+    return passed;
+}
+
+void Benchmarks::runCpuProfiler() {
+    std::cout << "=== CPU profiler (cost per CPU_PROFILE_SCOPE, ring of " << CpuProfiler::EVENTS_PER_THREAD
+              << " events per thread) ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    const int iterations = 4000000;
+    volatile int sink = 0;
+    bool wasEnabled = CpuProfiler::isEnabled();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        sink = sink + 1;
+    }
+    double baselineNs = elapsedMs(start) * 1e6 / iterations;
+
+    CpuProfiler::setEnabled(false);
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        CpuProfileScope scope("Disabled scope");
+        sink = sink + 1;
+    }
+    double disabledNs = elapsedMs(start) * 1e6 / iterations - baselineNs;
+
+    CpuProfiler::setEnabled(true);
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        CpuProfileScope scope("Enabled scope");
+        sink = sink + 1;
+    }
+    double enabledNs = elapsedMs(start) * 1e6 / iterations - baselineNs;
+
+    std::cout << "Runtime disabled: " << std::setw(6) << disabledNs << " ns/scope | enabled: "
+              << std::setw(6) << enabledNs << " ns/scope (loop overhead " << baselineNs << " ns removed)" << std::endl;
+
+    // Export while writer threads are still recording: the exporter must only see intact events
+    const int threadCount = 4;
+    const int scopesPerThread = 200000;
+    std::atomic<int> startedWriters(0);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threadCount; t++) {
+        writers.emplace_back([&startedWriters]() {
+            CpuProfiler::setThreadName("Benchmark writer");
+            startedWriters++;
+            for (int i = 0; i < scopesPerThread; i++) {
+                CpuProfileScope outer("Writer outer");
+                CpuProfileScope inner("Writer inner");
+            }
+        });
+    }
+    while (startedWriters < threadCount) {
+        std::this_thread::yield();
+    }
+    start = std::chrono::high_resolution_clock::now();
+    bool exported = CpuProfiler::exportChromeTrace("microbench_trace.json");
+    double exportMs = elapsedMs(start);
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+
+    std::cout << "Concurrent export with " << threadCount << " recording threads: " << exportMs << "ms"
+              << (exported ? "" : " (FAILED)") << std::endl;
+
+    CpuProfiler::setEnabled(wasEnabled);
+}
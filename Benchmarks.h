@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+// CPU micro-benchmarks, selected with "--microbench <name>" on the command line.
+// They run before any window or OpenGL context is created.
+class Benchmarks {
+public:
+    // Runs the named benchmark ("all" runs every benchmark); returns false for unknown names
+    // and when a benchmark's correctness checks fail
+    static bool run(const std::string& name);
+
+private:
+    // Also checks that every stage keeps the mesh and that ACMR never gets worse
+    static bool runMeshOptimizer();
+    // Also checks that the SSE and AVX2 paths find the scalar path's visible set
+    static bool runFrustumCulling();
+    // Also checks that the radix sort gives std::stable_sort's order
+    static bool runRenderQueueSort();
+    static void runCpuProfiler();
+};
@@ -0,0 +1,176 @@
+#include "BlueNoise.h"
+#include "GLStateCache.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+    // Gaussian energy filter of void-and-cluster; sigma 1.5 as in the original paper
+    const float FILTER_SIGMA = 1.5f;
+    // Share of the cells in the initial binary pattern
+    const float INITIAL_DENSITY = 0.1f;
+
+    // Filtered density of the set cells, wrapped around the tile
+    class EnergyField {
+    public:
+        explicit EnergyField(int size)
+            : size(size)
+            , kernel(size * size)
+            , energy(size * size, 0.0f)
+        {
+            for (int dy = 0; dy < size; dy++) {
+                for (int dx = 0; dx < size; dx++) {
+                    float x = static_cast<float>(std::min(dx, size - dx));
+                    float y = static_cast<float>(std::min(dy, size - dy));
+                    kernel[dy * size + dx] = std::exp(-(x * x + y * y) / (2.0f * FILTER_SIGMA * FILTER_SIGMA));
+                }
+            }
+        }
+
+        void splat(int cell, float weight) {
+            int cx = cell % size;
+            int cy = cell / size;
+            for (int y = 0; y < size; y++) {
+                const float* row = &kernel[((y - cy + size) % size) * size];
+                for (int x = 0; x < size; x++) {
+                    energy[y * size + x] += weight * row[(x - cx + size) % size];
+                }
+            }
+        }
+
+        // Set cell with the most energy, or unset cell with the least; -1 if there is none
+        int tightestCluster(const std::vector<char>& pattern) const { return extreme(pattern, 1, 1.0f); }
+        int largestVoid(const std::vector<char>& pattern) const { return extreme(pattern, 0, -1.0f); }
+
+    private:
+        int extreme(const std::vector<char>& pattern, char state, float sign) const {
+            int best = -1;
+            float bestEnergy = 0.0f;
+            for (int cell = 0; cell < size * size; cell++) {
+                if (pattern[cell] == state && (best < 0 || sign * energy[cell] > bestEnergy)) {
+                    best = cell;
+                    bestEnergy = sign * energy[cell];
+                }
+            }
+            return best;
+        }
+
+        int size;
+        std::vector<float> kernel;
+        std::vector<float> energy;
+    };
+}
+
+BlueNoiseTexture::BlueNoiseTexture()
+    : texture(0)
+{
+}
+
+bool BlueNoiseTexture::initialize(GLStateCache& glState) {
+    std::vector<float> values;
+    generate(SIZE, values);
+
+    glGenTextures(1, &texture);
+    glState.bindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, SIZE, SIZE, 0, GL_RED, GL_FLOAT, values.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glState.bindTexture(GL_TEXTURE_2D, 0);
+
+    if (glGetError() != GL_NO_ERROR) {
+        std::cerr << "Failed to create the blue noise texture" << std::endl;
+        cleanup();
+        return false;
+    }
+    std::cout << "Blue noise: " << SIZE << "x" << SIZE << " void-and-cluster tile" << std::endl;
+    return true;
+}
+
+void BlueNoiseTexture::cleanup() {
+    if (texture) {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+}
+
+void BlueNoiseTexture::bindTexture(GLStateCache& glState, GLenum unit) const {
+    glState.activeTexture(unit);
+    glState.bindTexture(GL_TEXTURE_2D, texture);
+}
+
+void BlueNoiseTexture::generate(int size, std::vector<float>& values) {
+    const int cellCount = size * size;
+    std::vector<char> pattern(cellCount, 0);
+    EnergyField field(size);
+
+    // Fixed seed: the same tile on every run
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> anyCell(0, cellCount - 1);
+    int initialCount = std::max(static_cast<int>(cellCount * INITIAL_DENSITY), 1);
+    for (int placed = 0; placed < initialCount; ) {
+        int cell = anyCell(rng);
+        if (!pattern[cell]) {
+            pattern[cell] = 1;
+            field.splat(cell, 1.0f);
+            placed++;
+        }
+    }
+
+    // Spread the initial points: move the tightest cluster into the largest void until the
+    // point taken out is the one that would go back in
+    for (;;) {
+        int cluster = field.tightestCluster(pattern);
+        if (cluster < 0) {
+            break;
+        }
+        pattern[cluster] = 0;
+        field.splat(cluster, -1.0f);
+        // Never -1: the cell just cleared is a void
+        int gap = field.largestVoid(pattern);
+        if (gap < 0) {
+            break;
+        }
+        pattern[gap] = 1;
+        field.splat(gap, 1.0f);
+        if (gap == cluster) {
+            break;
+        }
+    }
+
+    std::vector<int> ranks(cellCount, 0);
+    const std::vector<char> prototype = pattern;
+    const EnergyField prototypeField = field;
+
+    // Initial points: ranked down by taking out the tightest cluster each time
+    for (int rank = initialCount - 1; rank >= 0; rank--) {
+        int cluster = field.tightestCluster(pattern);
+        if (cluster < 0) {
+            break;
+        }
+        pattern[cluster] = 0;
+        field.splat(cluster, -1.0f);
+        ranks[cluster] = rank;
+    }
+
+    // The rest: ranked up by filling the largest void each time, past half density as well
+    // instead of the paper's third phase on the inverted pattern (a little less even there)
+    pattern = prototype;
+    field = prototypeField;
+    for (int rank = initialCount; rank < cellCount; rank++) {
+        int gap = field.largestVoid(pattern);
+        if (gap < 0) {
+            break;
+        }
+        pattern[gap] = 1;
+        field.splat(gap, 1.0f);
+        ranks[gap] = rank;
+    }
+
+    values.resize(cellCount);
+    for (int cell = 0; cell < cellCount; cell++) {
+        values[cell] = (ranks[cell] + 0.5f) / cellCount;
+    }
+}
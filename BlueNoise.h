@@ -0,0 +1,28 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+
+class GLStateCache;
+
+// Tiled blue noise for the path tracer's blue-noise sampler: a SIZE x SIZE toroidal pattern of
+// ranks, spread evenly over [0, 1). Any threshold of it gives evenly spaced points with no low
+// frequencies, so neighbouring pixels get well separated random numbers and the error shows up
+// as fine grain instead of clumps.
+class BlueNoiseTexture {
+public:
+    static const int SIZE = 64;    // BLUE_NOISE_SIZE in sampler.glsl
+
+    BlueNoiseTexture();
+
+    bool initialize(GLStateCache& glState);
+    void cleanup();
+    bool isInitialized() const { return texture != 0; }
+    void bindTexture(GLStateCache& glState, GLenum unit) const;
+
+    // Void-and-cluster (Ulichney 1993): size x size values, rank / (size * size), row by row
+    static void generate(int size, std::vector<float>& values);
+
+private:
+    GLuint texture;
+};
@@ -0,0 +1,268 @@
+#include "CascadedShadowMaps.h"
+#include "GLStateCache.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+    // Shadows end here even if the camera sees further; the cascades split this range
+    const float SHADOW_DISTANCE = 40.0f;
+    // Blend between uniform (0) and logarithmic (1) split distances
+    const float SPLIT_LAMBDA = 0.75f;
+    // Casters this far beyond a cascade's bounds, towards the light, still cast into it
+    const float CASTER_RANGE = 20.0f;
+    // Cascade c is due every UPDATE_INTERVALS[c] frames, offset by UPDATE_PHASES[c] so that
+    // cascades 1 and 2 never fall on the same frame
+    const uint64_t UPDATE_INTERVALS[CascadedShadowMaps::CASCADE_COUNT] = { 1, 2, 4 };
+    const uint64_t UPDATE_PHASES[CascadedShadowMaps::CASCADE_COUNT] = { 0, 1, 2 };
+    // The snap step is this fraction of a cascade's extent: 64 texels at 1024, and the extent
+    // leaves enough margin around the slice for the snapped center to be off by half a step
+    const int SNAP_DIVISIONS = 16;
+    const float EXTENT_MARGIN = 1.125f;
+}
+
+CascadedShadowMaps::CascadedShadowMaps()
+    : shadowTexture(0)
+    , staticTexture(0)
+    , shadowFBOs{}
+    , staticFBOs{}
+    , lightDirection(0.0f)
+    , frameIndex(0)
+{
+}
+
+bool CascadedShadowMaps::initialize(GLStateCache& glState) {
+    // Sampled map: hardware depth compare with bilinear filtering gives 2x2 PCF per tap
+    glGenTextures(1, &shadowTexture);
+    glState.bindTexture(GL_TEXTURE_2D_ARRAY, shadowTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, MAP_SIZE, MAP_SIZE, CASCADE_COUNT, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+    // Cached static layers are only ever blitted, never sampled
+    glGenTextures(1, &staticTexture);
+    glState.bindTexture(GL_TEXTURE_2D_ARRAY, staticTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, MAP_SIZE, MAP_SIZE, CASCADE_COUNT, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glState.bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    glGenFramebuffers(CASCADE_COUNT, shadowFBOs);
+    glGenFramebuffers(CASCADE_COUNT, staticFBOs);
+    bool complete = true;
+    for (int cascade = 0; cascade < CASCADE_COUNT && complete; cascade++) {
+        GLuint framebuffers[2] = { shadowFBOs[cascade], staticFBOs[cascade] };
+        GLuint textures[2] = { shadowTexture, staticTexture };
+        for (int i = 0; i < 2; i++) {
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[i]);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, textures[i], 0, cascade);
+            glDrawBuffer(GL_NONE);
+            glReadBuffer(GL_NONE);
+            GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+            if (status != GL_FRAMEBUFFER_COMPLETE) {
+                std::cerr << "Shadow cascade framebuffer incomplete: " << status << std::endl;
+                complete = false;
+                break;
+            }
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete) {
+        cleanup();
+        return false;
+    }
+
+    std::cout << "Cascaded shadow maps: " << CASCADE_COUNT << " x " << MAP_SIZE << "x" << MAP_SIZE
+              << " cascades up to " << SHADOW_DISTANCE << " units, static layers cached" << std::endl;
+    return true;
+}
+
+void CascadedShadowMaps::cleanup() {
+    if (shadowFBOs[0]) {
+        glDeleteFramebuffers(CASCADE_COUNT, shadowFBOs);
+        glDeleteFramebuffers(CASCADE_COUNT, staticFBOs);
+        for (int cascade = 0; cascade < CASCADE_COUNT; cascade++) {
+            shadowFBOs[cascade] = 0;
+            staticFBOs[cascade] = 0;
+        }
+    }
+    if (shadowTexture) {
+        glDeleteTextures(1, &shadowTexture);
+        glDeleteTextures(1, &staticTexture);
+        shadowTexture = 0;
+        staticTexture = 0;
+    }
+    for (Cascade& cascade : cascades) {
+        cascade = Cascade();
+    }
+}
+
+void CascadedShadowMaps::invalidateStatic() {
+    for (Cascade& cascade : cascades) {
+        cascade.staticValid = false;
+    }
+}
+
+void CascadedShadowMaps::fitSlice(const glm::mat4& inverseViewProjection, float nearPlane, float farPlane,
+                                  float sliceNear, float sliceFar, glm::vec3& center, float& radius) {
+    // View depth is linear along each corner ray from the near to the far plane
+    glm::vec3 corners[8];
+    int index = 0;
+    for (int y = -1; y <= 1; y += 2) {
+        for (int x = -1; x <= 1; x += 2) {
+            glm::vec4 nearCorner = inverseViewProjection * glm::vec4(float(x), float(y), -1.0f, 1.0f);
+            glm::vec4 farCorner = inverseViewProjection * glm::vec4(float(x), float(y), 1.0f, 1.0f);
+            glm::vec3 rayStart = glm::vec3(nearCorner) / nearCorner.w;
+            glm::vec3 rayEnd = glm::vec3(farCorner) / farCorner.w;
+            corners[index++] = glm::mix(rayStart, rayEnd, (sliceNear - nearPlane) / (farPlane - nearPlane));
+            corners[index++] = glm::mix(rayStart, rayEnd, (sliceFar - nearPlane) / (farPlane - nearPlane));
+        }
+    }
+
+    center = glm::vec3(0.0f);
+    for (const glm::vec3& corner : corners) {
+        center += corner;
+    }
+    center /= 8.0f;
+    radius = 0.0f;
+    for (const glm::vec3& corner : corners) {
+        radius = std::max(radius, glm::length(corner - center));
+    }
+    // Rounded up so rotating the camera never changes the extent through float noise
+    radius = std::ceil(radius * 16.0f) / 16.0f;
+}
+
+void CascadedShadowMaps::scheduleUpdates(const glm::mat4& view, const glm::mat4& projection,
+                                         const glm::vec3& direction, std::vector<ShadowCascadeUpdate>& updates) {
+    updates.clear();
+    if (!isInitialized()) {
+        return;
+    }
+
+    if (glm::dot(direction, lightDirection) < 0.99999f) {
+        lightDirection = direction;
+        invalidateStatic();
+    }
+
+    // Near and far planes of a GL perspective projection
+    float nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+    float farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+    float shadowFar = std::min(farPlane, SHADOW_DISTANCE);
+    glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+
+    glm::vec3 up = std::abs(lightDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), -lightDirection, up);
+
+    float sliceNear = nearPlane;
+    for (int c = 0; c < CASCADE_COUNT; c++) {
+        Cascade& cascade = cascades[c];
+        float t = float(c + 1) / CASCADE_COUNT;
+        float logSplit = nearPlane * std::pow(shadowFar / nearPlane, t);
+        float uniformSplit = nearPlane + (shadowFar - nearPlane) * t;
+        float sliceFar = SPLIT_LAMBDA * logSplit + (1.0f - SPLIT_LAMBDA) * uniformSplit;
+
+        bool due = !cascade.rendered || frameIndex % UPDATE_INTERVALS[c] == UPDATE_PHASES[c];
+        if (!due) {
+            sliceNear = sliceFar;
+            continue;
+        }
+
+        glm::vec3 center;
+        float radius;
+        fitSlice(inverseViewProjection, nearPlane, farPlane, sliceNear, sliceFar, center, radius);
+        sliceNear = sliceFar;
+
+        float halfExtent = radius * EXTENT_MARGIN;
+        float snapStep = 2.0f * halfExtent / SNAP_DIVISIONS;
+        glm::vec3 lightCenter = glm::vec3(lightRotation * glm::vec4(center, 1.0f));
+        glm::vec3 snapped = glm::floor(lightCenter / snapStep + 0.5f) * snapStep;
+
+        if (snapped != cascade.snappedCenter || halfExtent != cascade.halfExtent) {
+            cascade.snappedCenter = snapped;
+            cascade.halfExtent = halfExtent;
+            cascade.staticValid = false;
+        }
+
+        ShadowCascadeUpdate update;
+        update.cascade = c;
+        update.lightView = lightRotation;
+        // The light looks down -z: casters towards the light have smaller distances
+        update.lightProjection = glm::ortho(snapped.x - halfExtent, snapped.x + halfExtent,
+                                            snapped.y - halfExtent, snapped.y + halfExtent,
+                                            -snapped.z - halfExtent - CASTER_RANGE, -snapped.z + halfExtent);
+        update.rebuildStatic = !cascade.staticValid;
+        updates.push_back(update);
+    }
+}
+
+void CascadedShadowMaps::beginStaticLayer(GLStateCache& glState, const ShadowCascadeUpdate& update) {
+    glBindFramebuffer(GL_FRAMEBUFFER, staticFBOs[update.cascade]);
+    glViewport(0, 0, MAP_SIZE, MAP_SIZE);
+    glState.depthMask(true);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    cascades[update.cascade].staticValid = true;
+    stats.staticRebuilds++;
+}
+
+bool CascadedShadowMaps::beginCascade(GLStateCache& glState, const ShadowCascadeUpdate& update, uint32_t dynamicCasters) {
+    Cascade& cascade = cascades[update.cascade];
+
+    // Same static layer, same projection and no dynamic casters now or then: the map is exact
+    if (cascade.rendered && !update.rebuildStatic && dynamicCasters == 0 && cascade.lastDynamicCasters == 0) {
+        stats.cascadesReused++;
+        return false;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, staticFBOs[update.cascade]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, shadowFBOs[update.cascade]);
+    glBlitFramebuffer(0, 0, MAP_SIZE, MAP_SIZE, 0, 0, MAP_SIZE, MAP_SIZE, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, shadowFBOs[update.cascade]);
+    glViewport(0, 0, MAP_SIZE, MAP_SIZE);
+    glState.depthMask(true);
+
+    // Clip space to [0,1] texture coordinates and depth
+    const glm::mat4 bias = glm::translate(glm::mat4(1.0f), glm::vec3(0.5f)) * glm::scale(glm::mat4(1.0f), glm::vec3(0.5f));
+    cascade.shadowMatrix = bias * update.lightProjection * update.lightView;
+    cascade.texelSize = 2.0f * cascade.halfExtent / MAP_SIZE;
+    cascade.lastDynamicCasters = dynamicCasters;
+    cascade.rendered = true;
+    stats.cascadesRendered++;
+    return true;
+}
+
+void CascadedShadowMaps::setUniforms(GLuint program, GLint textureUnit, bool enabled) const {
+    glUniform1i(glGetUniformLocation(program, "shadowMap"), textureUnit);
+    bool ready = enabled && isInitialized() && cascades[CASCADE_COUNT - 1].rendered;
+    glUniform1i(glGetUniformLocation(program, "shadowCascadeCount"), ready ? CASCADE_COUNT : 0);
+    if (!ready) {
+        return;
+    }
+
+    glm::mat4 matrices[CASCADE_COUNT];
+    float texelSizes[CASCADE_COUNT];
+    for (int c = 0; c < CASCADE_COUNT; c++) {
+        matrices[c] = cascades[c].shadowMatrix;
+        texelSizes[c] = cascades[c].texelSize;
+    }
+    glUniformMatrix4fv(glGetUniformLocation(program, "shadowMatrices"), CASCADE_COUNT, GL_FALSE, &matrices[0][0][0]);
+    glUniform1fv(glGetUniformLocation(program, "shadowTexelSizes"), CASCADE_COUNT, texelSizes);
+}
+
+void CascadedShadowMaps::bindTexture(GLStateCache& glState, GLenum unit) const {
+    glState.activeTexture(unit);
+    glState.bindTexture(GL_TEXTURE_2D_ARRAY, shadowTexture);
+}
+
+void CascadedShadowMaps::endFrame() {
+    lastStats = stats;
+    stats = ShadowStats();
+    frameIndex++;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class GLStateCache;
+
+// What the last frame's shadow pass did
+struct ShadowStats {
+    uint32_t cascadesRendered = 0;    // cascades whose map was recomposed this frame
+    uint32_t cascadesReused = 0;      // due cascades left as they were (nothing changed)
+    uint32_t staticRebuilds = 0;      // cached static layers re-rendered
+    uint32_t casterDraws = 0;         // dynamic caster draw calls
+};
+
+// One cascade the renderer has to draw into this frame
+struct ShadowCascadeUpdate {
+    int cascade = 0;
+    glm::mat4 lightView = glm::mat4(1.0f);
+    glm::mat4 lightProjection = glm::mat4(1.0f);
+    bool rebuildStatic = false;    // the cached static layer is stale and must be re-rendered first
+};
+
+// Cascaded shadow maps for the main light with a static cache. Each cascade keeps two depth
+// layers: static geometry rendered once into a cached layer, and the sampled layer, which is
+// the cached layer copied over and the dynamic casters drawn on top. Cascades are fitted to
+// bounding spheres of the view frustum slices and snapped to a grid of whole texels in light
+// space, so the cached layer stays valid until the camera moves a full snap step. Far
+// cascades update less often (every 1, 2, 4 frames, staggered), so no more than two cascades
+// are drawn in any frame after the first.
+class CascadedShadowMaps {
+public:
+    static const int CASCADE_COUNT = 3;
+    static const int MAP_SIZE = 1024;
+
+    CascadedShadowMaps();
+
+    bool initialize(GLStateCache& glState);
+    void cleanup();
+    bool isInitialized() const { return shadowTexture != 0; }
+
+    // Marks every cached static layer stale (light moved, static geometry changed)
+    void invalidateStatic();
+
+    // Picks the cascades due this frame and refits them to the camera; view and projection are
+    // the camera's, lightDirection points from the scene towards the light
+    void scheduleUpdates(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& lightDirection,
+                         std::vector<ShadowCascadeUpdate>& updates);
+
+    // Render targets; both set the viewport and clear what they own
+    void beginStaticLayer(GLStateCache& glState, const ShadowCascadeUpdate& update);
+    // Copies the cached static layer into the sampled map. dynamicCasters is the number of
+    // casters about to be drawn; returns false if the map from the last update is still exact
+    bool beginCascade(GLStateCache& glState, const ShadowCascadeUpdate& update, uint32_t dynamicCasters);
+
+    // Sampler unit, matrices and texel sizes for a receiving program (currently bound); with
+    // enabled false the program gets a cascade count of 0 and stays unshadowed
+    void setUniforms(GLuint program, GLint textureUnit, bool enabled) const;
+    void bindTexture(GLStateCache& glState, GLenum unit) const;
+
+    ShadowStats& frameStats() { return stats; }
+    const ShadowStats& getStats() const { return lastStats; }
+    void endFrame();
+
+private:
+    struct Cascade {
+        glm::vec3 snappedCenter = glm::vec3(0.0f);    // light space
+        float halfExtent = 0.0f;
+        glm::mat4 shadowMatrix = glm::mat4(1.0f);     // world to [0,1] map coordinates, as last rendered
+        float texelSize = 0.0f;                       // world units per texel, for the normal offset
+        bool rendered = false;
+        bool staticValid = false;
+        uint32_t lastDynamicCasters = 0;
+    };
+
+    // Bounding sphere of the camera frustum between two view distances
+    static void fitSlice(const glm::mat4& inverseViewProjection, float nearPlane, float farPlane,
+                         float sliceNear, float sliceFar, glm::vec3& center, float& radius);
+
+    GLuint shadowTexture;    // sampled depth array, compare mode
+    GLuint staticTexture;    // cached static layers
+    GLuint shadowFBOs[CASCADE_COUNT];
+    GLuint staticFBOs[CASCADE_COUNT];
+    Cascade cascades[CASCADE_COUNT];
+    glm::vec3 lightDirection;
+    uint64_t frameIndex;
+
+    ShadowStats stats;
+    ShadowStats lastStats;
+};
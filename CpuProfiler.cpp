@@ -0,0 +1,127 @@
+#include "CpuProfiler.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> CpuProfiler::enabledFlag(true);
+
+namespace {
+    const std::chrono::steady_clock::time_point profilerEpoch = std::chrono::steady_clock::now();
+
+    // Written only by its owning thread; writeCount is published with release so an exporting
+    // thread that acquires it sees every event below it
+    struct ThreadBuffer {
+        uint32_t threadId = 0;
+        std::atomic<const char*> threadName{nullptr};
+        std::atomic<uint64_t> writeCount{0};
+        CpuTraceEvent events[CpuProfiler::EVENTS_PER_THREAD];
+    };
+
+    // Buffers live until exit so traces still include threads that have finished
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>>& registry() {
+        static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        return buffers;
+    }
+
+    ThreadBuffer& threadBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            registry().push_back(std::make_unique<ThreadBuffer>());
+            buffer = registry().back().get();
+            buffer->threadId = static_cast<uint32_t>(registry().size());
+        }
+        return *buffer;
+    }
+
+    void writeJsonString(std::ostream& out, const char* text) {
+        out << '"';
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                out << '\\';
+            }
+            out << *c;
+        }
+        out << '"';
+    }
+}
+
+int64_t CpuProfiler::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - profilerEpoch).count();
+}
+
+void CpuProfiler::record(const char* name, int64_t startNs, int64_t endNs) {
+    ThreadBuffer& buffer = threadBuffer();
+    uint64_t index = buffer.writeCount.load(std::memory_order_relaxed);
+    buffer.events[index & (EVENTS_PER_THREAD - 1)] = {name, startNs, endNs - startNs};
+    buffer.writeCount.store(index + 1, std::memory_order_release);
+}
+
+void CpuProfiler::setThreadName(const char* name) {
+    threadBuffer().threadName.store(name, std::memory_order_relaxed);
+}
+
+bool CpuProfiler::exportChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open trace file " << path << std::endl;
+        return false;
+    }
+
+    std::vector<ThreadBuffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& buffer : registry()) {
+            buffers.push_back(buffer.get());
+        }
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    size_t eventCount = 0;
+    std::vector<CpuTraceEvent> snapshot;
+
+    for (ThreadBuffer* buffer : buffers) {
+        // Copy the ring, then drop the entries the writer may have overwritten during the copy
+        uint64_t end = buffer->writeCount.load(std::memory_order_acquire);
+        uint64_t begin = end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+        snapshot.clear();
+        for (uint64_t i = begin; i < end; i++) {
+            snapshot.push_back(buffer->events[i & (EVENTS_PER_THREAD - 1)]);
+        }
+        // Keeps the copy's reads ahead of the second count load
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t endAfterCopy = buffer->writeCount.load(std::memory_order_relaxed);
+        // The writer may be halfway through event endAfterCopy, whose slot is counted in the ring
+        uint64_t firstIntact = endAfterCopy + 1 > EVENTS_PER_THREAD ? endAfterCopy + 1 - EVENTS_PER_THREAD : 0;
+        size_t skip = firstIntact > begin ? static_cast<size_t>(firstIntact - begin) : 0;
+
+        const char* threadName = buffer->threadName.load(std::memory_order_relaxed);
+        if (threadName) {
+            out << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"args\":{\"name\":";
+            writeJsonString(out, threadName);
+            out << "}}";
+            first = false;
+        }
+
+        for (size_t i = skip; i < snapshot.size(); i++) {
+            const CpuTraceEvent& event = snapshot[i];
+            out << (first ? "" : ",") << "\n{\"ph\":\"X\",\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << event.startNs / 1000 << "." << (event.startNs % 1000) / 100
+                << ",\"dur\":" << event.durationNs / 1000 << "." << (event.durationNs % 1000) / 100 << "}";
+            first = false;
+            eventCount++;
+        }
+    }
+    out << "\n]}\n";
+
+    std::cout << "Wrote " << eventCount << " CPU trace events from " << buffers.size() << " thread(s) to " << path << std::endl;
+    return out.good();
+}
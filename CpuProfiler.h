@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// One completed CPU scope
+struct CpuTraceEvent {
+    const char* name;
+    int64_t startNs;
+    int64_t durationNs;
+};
+
+// Scoped CPU instrumentation. Every thread records into its own fixed-size ring buffer
+// (single writer, no locks after the thread's first event), oldest events are overwritten.
+// exportChromeTrace() writes the buffered events as Chrome trace-event JSON
+// (chrome://tracing, ui.perfetto.dev).
+class CpuProfiler {
+public:
+    static const uint32_t EVENTS_PER_THREAD = 1u << 16;
+
+    static void setEnabled(bool enabled) { enabledFlag.store(enabled, std::memory_order_relaxed); }
+    static bool isEnabled() { return enabledFlag.load(std::memory_order_relaxed); }
+
+    // Nanoseconds since the profiler's epoch (steady clock)
+    static int64_t nowNs();
+
+    // Appends to the calling thread's ring buffer; names must outlive the profiler (string literals)
+    static void record(const char* name, int64_t startNs, int64_t endNs);
+
+    // Names the calling thread in exported traces
+    static void setThreadName(const char* name);
+
+    // Writes every buffered event of every thread; safe while other threads keep recording
+    static bool exportChromeTrace(const std::string& path);
+
+private:
+    static std::atomic<bool> enabledFlag;
+};
+
+// Records the enclosing block when profiling is enabled at runtime
+class CpuProfileScope {
+public:
+    explicit CpuProfileScope(const char* name)
+        : name(name), startNs(CpuProfiler::isEnabled() ? CpuProfiler::nowNs() : -1) {}
+    ~CpuProfileScope() {
+        if (startNs >= 0) {
+            CpuProfiler::record(name, startNs, CpuProfiler::nowNs());
+        }
+    }
+    CpuProfileScope(const CpuProfileScope&) = delete;
+    CpuProfileScope& operator=(const CpuProfileScope&) = delete;
+
+private:
+    const char* name;
+    int64_t startNs;
+};
+
+// CPU_PROFILE_SCOPE("name") times the rest of the block; it compiles to nothing unless the
+// build defines VIBE3D_PROFILING (CMake option of the same name)
+#define CPU_PROFILE_CONCAT_INNER(a, b) a##b
+#define CPU_PROFILE_CONCAT(a, b) CPU_PROFILE_CONCAT_INNER(a, b)
+#ifdef VIBE3D_PROFILING
+#define CPU_PROFILE_SCOPE(name) CpuProfileScope CPU_PROFILE_CONCAT(cpuProfileScope, __LINE__)(name)
+#else
+#define CPU_PROFILE_SCOPE(name) ((void)0)
+#endif
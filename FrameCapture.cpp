@@ -0,0 +1,252 @@
+#include "FrameCapture.h"
+#include "GLStateCache.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    // Generous bound for a fence that is RING_SIZE frames old
+    const GLuint64 FENCE_TIMEOUT_NS = 1000000000ull;
+
+    bool endsWith(const std::string& text, const std::string& suffix) {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+}
+
+FrameCapture::FrameCapture()
+    : active(false)
+    , y4m(false)
+    , width(0), height(0)
+    , frameBytes(0)
+    , nextSlot(0)
+    , stopping(false)
+{
+}
+
+FrameCapture::~FrameCapture() {
+    // GL objects need stop(); without it only the writer is shut down
+    joinWriter();
+}
+
+bool FrameCapture::start(GLStateCache& glState, const std::string& capturePath, unsigned int captureWidth,
+                         unsigned int captureHeight, int frameRate) {
+    if (active) {
+        stop(glState);
+    }
+
+    path = capturePath;
+    y4m = endsWith(path, ".y4m");
+    width = captureWidth;
+    height = captureHeight;
+    frameBytes = static_cast<size_t>(width) * height * 4;
+    stats = FrameCaptureStats();
+
+    if (y4m) {
+        stream.open(path, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            std::cerr << "Failed to open capture file " << path << std::endl;
+            return false;
+        }
+        // Full-resolution chroma keeps the conversion a per-pixel operation
+        stream << "YUV4MPEG2 W" << width << " H" << height << " F" << frameRate << ":1 Ip A1:1 C444\n";
+    }
+
+    for (RingSlot& slot : slots) {
+        glGenBuffers(1, &slot.buffer);
+        glState.bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, nullptr, GL_STREAM_READ);
+        slot.fence = nullptr;
+    }
+    glState.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    nextSlot = 0;
+
+    stopping = false;
+    writer = std::thread(&FrameCapture::writerLoop, this);
+    active = true;
+
+    std::cout << "Capturing " << width << "x" << height << " frames to "
+              << (y4m ? path : path + "_#####.ppm") << std::endl;
+    return true;
+}
+
+void FrameCapture::captureFrame(GLStateCache& glState, GLuint framebuffer) {
+    if (!active) {
+        return;
+    }
+
+    // The slot's previous frame was read RING_SIZE frames ago and is normally complete by now
+    RingSlot& slot = slots[nextSlot];
+    if (slot.fence) {
+        retrieveSlot(glState, slot);
+    }
+
+    // RGBA8 rows need no pack alignment padding and match the native framebuffer layout
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glState.bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glState.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frameIndex = stats.capturedFrames++;
+
+    nextSlot = (nextSlot + 1) % RING_SIZE;
+}
+
+void FrameCapture::retrieveSlot(GLStateCache& glState, RingSlot& slot) {
+    GLenum status = glClientWaitSync(slot.fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        stats.fenceWaits++;
+        status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS);
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) {
+        std::cerr << "Frame capture: readback of frame " << slot.frameIndex << " did not complete, dropped" << std::endl;
+        return;
+    }
+
+    // A recycled vector, or a new one while the writer still holds fewer than MAX_QUEUED_FRAMES
+    QueuedFrame frame;
+    frame.frameIndex = slot.frameIndex;
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        if (queue.size() >= MAX_QUEUED_FRAMES) {
+            stats.writerWaits++;
+            queueChanged.wait(lock, [this] { return queue.size() < MAX_QUEUED_FRAMES; });
+        }
+        if (!freeBuffers.empty()) {
+            frame.pixels = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+        }
+    }
+    frame.pixels.resize(frameBytes);
+
+    glState.bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameBytes, GL_MAP_READ_BIT);
+    if (mapped) {
+        std::memcpy(frame.pixels.data(), mapped, frameBytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glState.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!mapped) {
+        std::cerr << "Frame capture: failed to map readback buffer, frame " << slot.frameIndex << " dropped" << std::endl;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(std::move(frame));
+    }
+    queueChanged.notify_all();
+}
+
+void FrameCapture::stop(GLStateCache& glState) {
+    if (!active) {
+        return;
+    }
+
+    // Oldest slot first so frames reach the writer in order
+    for (int i = 0; i < RING_SIZE; i++) {
+        RingSlot& slot = slots[(nextSlot + i) % RING_SIZE];
+        if (slot.fence) {
+            retrieveSlot(glState, slot);
+        }
+    }
+    joinWriter();
+
+    for (RingSlot& slot : slots) {
+        glDeleteBuffers(1, &slot.buffer);
+        slot.buffer = 0;
+    }
+    if (stream.is_open()) {
+        stream.close();
+    }
+    freeBuffers.clear();
+    active = false;
+
+    std::cout << "Frame capture: " << stats.writtenFrames << " of " << stats.capturedFrames << " frames written to "
+              << (y4m ? path : path + "_#####.ppm") << " (" << stats.fenceWaits << " fence waits, "
+              << stats.writerWaits << " writer waits)" << std::endl;
+}
+
+void FrameCapture::joinWriter() {
+    if (!writer.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueChanged.notify_all();
+    writer.join();
+}
+
+void FrameCapture::writerLoop() {
+    for (;;) {
+        QueuedFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueChanged.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            frame = std::move(queue.front());
+            queue.pop_front();
+        }
+        queueChanged.notify_all();
+
+        bool written = writeFrame(frame);
+
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (written) {
+            stats.writtenFrames++;
+        }
+        freeBuffers.push_back(std::move(frame.pixels));
+    }
+}
+
+bool FrameCapture::writeFrame(const QueuedFrame& frame) {
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    const uint8_t* pixels = frame.pixels.data();
+
+    if (y4m) {
+        // BT.601 limited range; planes are top row first, GL rows bottom row first
+        convertedRows.resize(pixelCount * 3);
+        uint8_t* planeY = convertedRows.data();
+        uint8_t* planeU = planeY + pixelCount;
+        uint8_t* planeV = planeU + pixelCount;
+        for (unsigned int row = 0; row < height; row++) {
+            const uint8_t* source = pixels + static_cast<size_t>(height - 1 - row) * width * 4;
+            size_t offset = static_cast<size_t>(row) * width;
+            for (unsigned int x = 0; x < width; x++, source += 4) {
+                int r = source[0], g = source[1], b = source[2];
+                planeY[offset + x] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+                planeU[offset + x] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+                planeV[offset + x] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+            }
+        }
+        stream << "FRAME\n";
+        stream.write(reinterpret_cast<const char*>(convertedRows.data()), convertedRows.size());
+        return stream.good();
+    }
+
+    char framePath[32];
+    std::snprintf(framePath, sizeof(framePath), "_%05u.ppm", frame.frameIndex);
+    std::ofstream out(path + framePath, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open capture file " << path + framePath << std::endl;
+        return false;
+    }
+    convertedRows.resize(pixelCount * 3);
+    for (unsigned int row = 0; row < height; row++) {
+        const uint8_t* source = pixels + static_cast<size_t>(height - 1 - row) * width * 4;
+        uint8_t* destination = convertedRows.data() + static_cast<size_t>(row) * width * 3;
+        for (unsigned int x = 0; x < width; x++) {
+            destination[x * 3 + 0] = source[x * 4 + 0];
+            destination[x * 3 + 1] = source[x * 4 + 1];
+            destination[x * 3 + 2] = source[x * 4 + 2];
+        }
+    }
+    out << "P6\n" << width << " " << height << "\n255\n";
+    out.write(reinterpret_cast<const char*>(convertedRows.data()), convertedRows.size());
+    return out.good();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class GLStateCache;
+
+// Counters of one capture session
+struct FrameCaptureStats {
+    uint32_t capturedFrames = 0;    // readbacks issued
+    uint32_t writtenFrames = 0;     // frames on disk
+    uint32_t fenceWaits = 0;        // ring slots reused before the GPU finished them
+    uint32_t writerWaits = 0;       // frames that waited for the writer thread to catch up
+};
+
+// Continuous framebuffer capture without pipeline stalls. Each frame's glReadPixels goes into
+// one of RING_SIZE pixel-pack buffers behind a fence; the buffer is only mapped when the ring
+// comes back to it, RING_SIZE frames later, by which time the copy has long finished. Mapped
+// pixels are handed to a writer thread that converts and writes them, so the render thread
+// only pays for one memcpy per frame. Output is a 4:4:4 Y4M stream for paths ending in ".y4m",
+// otherwise numbered binary PPM files "<path>_00000.ppm", ...
+class FrameCapture {
+public:
+    static const int RING_SIZE = 3;
+    static const size_t MAX_QUEUED_FRAMES = 8;
+
+    FrameCapture();
+    ~FrameCapture();
+
+    bool start(GLStateCache& glState, const std::string& path, unsigned int width, unsigned int height, int frameRate);
+    // Drains the ring and the writer; every captured frame is on disk when it returns
+    void stop(GLStateCache& glState);
+    bool isActive() const { return active; }
+
+    // Queues a readback of the framebuffer's first color attachment
+    void captureFrame(GLStateCache& glState, GLuint framebuffer);
+
+    const FrameCaptureStats& getStats() const { return stats; }
+
+private:
+    struct RingSlot {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+        uint32_t frameIndex = 0;
+    };
+    struct QueuedFrame {
+        uint32_t frameIndex;
+        std::vector<uint8_t> pixels;    // RGBA8, bottom row first
+    };
+
+    // Maps a slot's buffer once its fence has signaled and hands the pixels to the writer
+    void retrieveSlot(GLStateCache& glState, RingSlot& slot);
+    void writerLoop();
+    void joinWriter();
+    bool writeFrame(const QueuedFrame& frame);
+
+    bool active;
+    std::string path;
+    bool y4m;
+    unsigned int width, height;
+    size_t frameBytes;
+
+    RingSlot slots[RING_SIZE];
+    int nextSlot;
+
+    std::thread writer;
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::deque<QueuedFrame> queue;
+    std::vector<std::vector<uint8_t>> freeBuffers;    // recycled pixel vectors
+    bool stopping;
+
+    std::ofstream stream;                      // the Y4M file
+    std::vector<uint8_t> convertedRows;        // writer-thread scratch: YUV planes or PPM rows
+    FrameCaptureStats stats;
+};
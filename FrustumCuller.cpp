@@ -0,0 +1,263 @@
+#include "FrustumCuller.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define VIBE3D_CULL_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define VIBE3D_TARGET_AVX2
+#else
+#define VIBE3D_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define VIBE3D_CULL_X86 0
+#endif
+
+void SphereBounds::clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
+}
+
+void SphereBounds::reserve(size_t count) {
+    centerX.reserve(count);
+    centerY.reserve(count);
+    centerZ.reserve(count);
+    radius.reserve(count);
+}
+
+void SphereBounds::add(const glm::vec3& center, float sphereRadius) {
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    radius.push_back(sphereRadius);
+}
+
+Frustum FrustumCuller::extractFrustum(const glm::mat4& viewProjection) {
+    // Rows of the matrix (GLM is column-major)
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++) {
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    }
+
+    Frustum frustum;
+    frustum.planes[0] = rows[3] + rows[0]; // Left
+    frustum.planes[1] = rows[3] - rows[0]; // Right
+    frustum.planes[2] = rows[3] + rows[1]; // Bottom
+    frustum.planes[3] = rows[3] - rows[1]; // Top
+    frustum.planes[4] = rows[3] + rows[2]; // Near
+    frustum.planes[5] = rows[3] - rows[2]; // Far
+
+    // Normalize so plane distances are in world units
+    for (auto& plane : frustum.planes) {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) {
+            plane = plane / length;
+        }
+    }
+
+    return frustum;
+}
+
+bool FrustumCuller::isSphereVisible(const Frustum& frustum, const glm::vec3& center, float radius) {
+    for (const auto& plane : frustum.planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace {
+    // Scalar loop over [begin, end); also handles the tail of the SIMD paths.
+    // The index is written unconditionally and the output cursor advanced only for
+    // visible spheres, which keeps the loop free of unpredictable branches.
+    size_t cullRangeScalar(const Frustum& frustum, const SphereBounds& bounds, size_t begin, size_t end,
+                           uint32_t* out, size_t count) {
+        const float* centerX = bounds.centerX.data();
+        const float* centerY = bounds.centerY.data();
+        const float* centerZ = bounds.centerZ.data();
+        const float* radius = bounds.radius.data();
+
+        for (size_t i = begin; i < end; i++) {
+            bool visible = true;
+            for (const auto& plane : frustum.planes) {
+                float distance = plane.x * centerX[i] + plane.y * centerY[i] + plane.z * centerZ[i] + plane.w;
+                visible &= distance >= -radius[i];
+            }
+            out[count] = static_cast<uint32_t>(i);
+            count += visible ? 1 : 0;
+        }
+        return count;
+    }
+
+#if VIBE3D_CULL_X86
+    size_t cullSSE(const Frustum& frustum, const SphereBounds& bounds, uint32_t* out) {
+        const size_t size = bounds.size();
+        const size_t simdEnd = size & ~size_t(3);
+
+        __m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+        for (int p = 0; p < 6; p++) {
+            planeX[p] = _mm_set1_ps(frustum.planes[p].x);
+            planeY[p] = _mm_set1_ps(frustum.planes[p].y);
+            planeZ[p] = _mm_set1_ps(frustum.planes[p].z);
+            planeW[p] = _mm_set1_ps(frustum.planes[p].w);
+        }
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        size_t count = 0;
+        for (size_t i = 0; i < simdEnd; i += 4) {
+            __m128 cx = _mm_loadu_ps(&bounds.centerX[i]);
+            __m128 cy = _mm_loadu_ps(&bounds.centerY[i]);
+            __m128 cz = _mm_loadu_ps(&bounds.centerZ[i]);
+            __m128 negRadius = _mm_xor_ps(_mm_loadu_ps(&bounds.radius[i]), signMask);
+
+            __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < 6; p++) {
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], cx), _mm_mul_ps(planeY[p], cy)),
+                                                        _mm_mul_ps(planeZ[p], cz)), planeW[p]);
+                visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, negRadius));
+            }
+
+            int mask = _mm_movemask_ps(visible);
+            if (mask == 0) {
+                continue;
+            }
+            for (int lane = 0; lane < 4; lane++) {
+                out[count] = static_cast<uint32_t>(i + lane);
+                count += (mask >> lane) & 1;
+            }
+        }
+
+        return cullRangeScalar(frustum, bounds, simdEnd, size, out, count);
+    }
+
+    VIBE3D_TARGET_AVX2
+    size_t cullAVX2(const Frustum& frustum, const SphereBounds& bounds, uint32_t* out) {
+        const size_t size = bounds.size();
+        const size_t simdEnd = size & ~size_t(7);
+
+        __m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+        for (int p = 0; p < 6; p++) {
+            planeX[p] = _mm256_set1_ps(frustum.planes[p].x);
+            planeY[p] = _mm256_set1_ps(frustum.planes[p].y);
+            planeZ[p] = _mm256_set1_ps(frustum.planes[p].z);
+            planeW[p] = _mm256_set1_ps(frustum.planes[p].w);
+        }
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+        size_t count = 0;
+        for (size_t i = 0; i < simdEnd; i += 8) {
+            __m256 cx = _mm256_loadu_ps(&bounds.centerX[i]);
+            __m256 cy = _mm256_loadu_ps(&bounds.centerY[i]);
+            __m256 cz = _mm256_loadu_ps(&bounds.centerZ[i]);
+            __m256 negRadius = _mm256_xor_ps(_mm256_loadu_ps(&bounds.radius[i]), signMask);
+
+            // Separate multiply/add (no FMA) so results match the scalar path bit for bit
+            __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int p = 0; p < 6; p++) {
+                __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], cx), _mm256_mul_ps(planeY[p], cy)),
+                                                              _mm256_mul_ps(planeZ[p], cz)), planeW[p]);
+                visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+            }
+
+            int mask = _mm256_movemask_ps(visible);
+            if (mask == 0) {
+                continue;
+            }
+            for (int lane = 0; lane < 8; lane++) {
+                out[count] = static_cast<uint32_t>(i + lane);
+                count += (mask >> lane) & 1;
+            }
+        }
+
+        return cullRangeScalar(frustum, bounds, simdEnd, size, out, count);
+    }
+
+    bool detectAVX2() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+}
+
+bool FrustumCuller::isPathSupported(CullingPath path) {
+    switch (path) {
+    case CullingPath::Scalar:
+        return true;
+#if VIBE3D_CULL_X86
+    case CullingPath::SSE:
+        return true;
+    case CullingPath::AVX2: {
+        static const bool supported = detectAVX2();
+        return supported;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+CullingPath FrustumCuller::bestPath() {
+    if (isPathSupported(CullingPath::AVX2)) return CullingPath::AVX2;
+    if (isPathSupported(CullingPath::SSE)) return CullingPath::SSE;
+    return CullingPath::Scalar;
+}
+
+const char* FrustumCuller::pathName(CullingPath path) {
+    switch (path) {
+    case CullingPath::SSE: return "SSE";
+    case CullingPath::AVX2: return "AVX2";
+    default: return "scalar";
+    }
+}
+
+void FrustumCuller::cullSpheres(const Frustum& frustum, const SphereBounds& bounds, std::vector<uint32_t>& visibleIndices) {
+    static const CullingPath path = bestPath();
+    cullSpheres(frustum, bounds, visibleIndices, path);
+}
+
+void FrustumCuller::cullSpheres(const Frustum& frustum, const SphereBounds& bounds, std::vector<uint32_t>& visibleIndices,
+                                CullingPath path) {
+    // Every sphere may be visible; size for the worst case and shrink afterwards
+    visibleIndices.resize(bounds.size());
+    uint32_t* out = visibleIndices.data();
+    size_t count = 0;
+
+    if (!isPathSupported(path)) {
+        path = CullingPath::Scalar;
+    }
+
+    switch (path) {
+#if VIBE3D_CULL_X86
+    case CullingPath::AVX2:
+        count = cullAVX2(frustum, bounds, out);
+        break;
+    case CullingPath::SSE:
+        count = cullSSE(frustum, bounds, out);
+        break;
+#endif
+    default:
+        count = cullRangeScalar(frustum, bounds, 0, bounds.size(), out, 0);
+        break;
+    }
+
+    visibleIndices.resize(count);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// View frustum as six inward-facing planes (xyz = normal, w = distance)
+struct Frustum {
+    glm::vec4 planes[6]; // left, right, bottom, top, near, far
+};
+
+// Bounding spheres in structure-of-arrays layout so the culler can load
+// eight centers/radii per register without shuffling
+struct SphereBounds {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+
+    void clear();
+    void reserve(size_t count);
+    void add(const glm::vec3& center, float sphereRadius);
+    size_t size() const { return radius.size(); }
+};
+
+enum class CullingPath {
+    Scalar,
+    SSE,
+    AVX2
+};
+
+class FrustumCuller {
+public:
+    // Extract normalized planes from a combined projection * view matrix (Gribb/Hartmann)
+    static Frustum extractFrustum(const glm::mat4& viewProjection);
+
+    // Conservative sphere test: true unless the sphere is fully outside one plane
+    static bool isSphereVisible(const Frustum& frustum, const glm::vec3& center, float radius);
+
+    // Test all bounds and write the indices of visible spheres, in ascending order, to visibleIndices.
+    // Uses the widest SIMD path supported by the running CPU.
+    static void cullSpheres(const Frustum& frustum, const SphereBounds& bounds, std::vector<uint32_t>& visibleIndices);
+
+    // Same as cullSpheres with an explicit code path; falls back to scalar if the path is unavailable
+    static void cullSpheres(const Frustum& frustum, const SphereBounds& bounds, std::vector<uint32_t>& visibleIndices,
+                            CullingPath path);
+
+    static bool isPathSupported(CullingPath path);
+    static CullingPath bestPath();
+    static const char* pathName(CullingPath path);
+};
@@ -0,0 +1,211 @@
+#include "GLStateCache.h"
+
+namespace {
+    // GL 4.x buffer targets (GLAD only loads GL 3.3)
+    const GLenum GL_SHADER_STORAGE_BUFFER_LOCAL = 0x90D2;
+    const GLenum GL_DRAW_INDIRECT_BUFFER_LOCAL = 0x8F3F;
+    const GLenum GL_PARAMETER_BUFFER_LOCAL = 0x80EE;
+}
+
+GLStateCache::GLStateCache() {
+    invalidate();
+}
+
+void GLStateCache::invalidate() {
+    program = UNKNOWN;
+    vertexArray = UNKNOWN;
+    for (GLuint& buffer : buffers) {
+        buffer = UNKNOWN;
+    }
+    activeUnit = UNKNOWN;
+    for (GLuint& texture : textures2D) {
+        texture = UNKNOWN;
+    }
+    blend = depthTest = cullFaceEnabled = Tristate::Unknown;
+    for (GLenum& factor : blendState) {
+        factor = UNKNOWN;
+    }
+    depthWrite = Tristate::Unknown;
+    depthFunction = UNKNOWN;
+    cullFaceMode = UNKNOWN;
+}
+
+int GLStateCache::bufferTargetSlot(GLenum target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER: return 0;
+    case GL_ELEMENT_ARRAY_BUFFER: return 1;
+    case GL_COPY_READ_BUFFER: return 2;
+    case GL_COPY_WRITE_BUFFER: return 3;
+    case GL_UNIFORM_BUFFER: return 4;
+    case GL_SHADER_STORAGE_BUFFER_LOCAL: return 5;
+    case GL_DRAW_INDIRECT_BUFFER_LOCAL: return 6;
+    case GL_PARAMETER_BUFFER_LOCAL: return 7;
+    default: return -1;
+    }
+}
+
+GLStateCache::Tristate* GLStateCache::capabilityShadow(GLenum capability) {
+    switch (capability) {
+    case GL_BLEND: return &blend;
+    case GL_DEPTH_TEST: return &depthTest;
+    case GL_CULL_FACE: return &cullFaceEnabled;
+    default: return nullptr;
+    }
+}
+
+void GLStateCache::useProgram(GLuint newProgram) {
+    if (filter(program == newProgram)) {
+        return;
+    }
+    glUseProgram(newProgram);
+    program = newProgram;
+}
+
+void GLStateCache::bindVertexArray(GLuint newVertexArray) {
+    if (filter(vertexArray == newVertexArray)) {
+        return;
+    }
+    glBindVertexArray(newVertexArray);
+    vertexArray = newVertexArray;
+
+    // The element array binding is part of the vertex array object
+    buffers[bufferTargetSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+}
+
+void GLStateCache::bindBuffer(GLenum target, GLuint buffer) {
+    int slot = bufferTargetSlot(target);
+    if (filter(slot >= 0 && buffers[slot] == buffer)) {
+        return;
+    }
+    glBindBuffer(target, buffer);
+    if (slot >= 0) {
+        buffers[slot] = buffer;
+    }
+}
+
+void GLStateCache::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    // Indexed bindings are not shadowed, but the call also replaces the generic binding
+    filter(false);
+    glBindBufferBase(target, index, buffer);
+    int slot = bufferTargetSlot(target);
+    if (slot >= 0) {
+        buffers[slot] = buffer;
+    }
+}
+
+void GLStateCache::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    // Same generic-binding side effect as bindBufferBase
+    filter(false);
+    glBindBufferRange(target, index, buffer, offset, size);
+    int slot = bufferTargetSlot(target);
+    if (slot >= 0) {
+        buffers[slot] = buffer;
+    }
+}
+
+void GLStateCache::activeTexture(GLenum unit) {
+    if (filter(activeUnit == unit)) {
+        return;
+    }
+    glActiveTexture(unit);
+    activeUnit = unit;
+}
+
+void GLStateCache::bindTexture(GLenum target, GLuint texture) {
+    GLuint unitIndex = activeUnit - GL_TEXTURE0;
+    bool shadowed = target == GL_TEXTURE_2D && activeUnit != UNKNOWN && unitIndex < MAX_TEXTURE_UNITS;
+    if (filter(shadowed && textures2D[unitIndex] == texture)) {
+        return;
+    }
+    glBindTexture(target, texture);
+    if (shadowed) {
+        textures2D[unitIndex] = texture;
+    } else if (target == GL_TEXTURE_2D && activeUnit == UNKNOWN) {
+        // Bound on a unit we can't name: none of the shadowed units can be trusted
+        for (GLuint& unitTexture : textures2D) {
+            unitTexture = UNKNOWN;
+        }
+    }
+}
+
+void GLStateCache::setEnabled(GLenum capability, bool enabled) {
+    Tristate* shadow = capabilityShadow(capability);
+
+    Tristate wanted = enabled ? Tristate::On : Tristate::Off;
+    if (filter(shadow && *shadow == wanted)) {
+        return;
+    }
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+    if (shadow) {
+        *shadow = wanted;
+    }
+}
+
+bool GLStateCache::isEnabled(GLenum capability) {
+    Tristate* shadow = capabilityShadow(capability);
+
+    // Only query the driver (a round trip on most implementations) when the shadow can't answer
+    if (shadow && *shadow != Tristate::Unknown) {
+        return *shadow == Tristate::On;
+    }
+    bool enabled = glIsEnabled(capability) == GL_TRUE;
+    if (shadow) {
+        *shadow = enabled ? Tristate::On : Tristate::Off;
+    }
+    return enabled;
+}
+
+void GLStateCache::blendFuncSeparate(GLenum sourceRGB, GLenum destinationRGB, GLenum sourceAlpha, GLenum destinationAlpha) {
+    if (filter(blendState[0] == sourceRGB && blendState[1] == destinationRGB &&
+               blendState[2] == sourceAlpha && blendState[3] == destinationAlpha)) {
+        return;
+    }
+    glBlendFuncSeparate(sourceRGB, destinationRGB, sourceAlpha, destinationAlpha);
+    blendState[0] = sourceRGB;
+    blendState[1] = destinationRGB;
+    blendState[2] = sourceAlpha;
+    blendState[3] = destinationAlpha;
+}
+
+void GLStateCache::depthMask(bool enabled) {
+    Tristate wanted = enabled ? Tristate::On : Tristate::Off;
+    if (filter(depthWrite == wanted)) {
+        return;
+    }
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    depthWrite = wanted;
+}
+
+void GLStateCache::depthFunc(GLenum function) {
+    if (filter(depthFunction == function)) {
+        return;
+    }
+    glDepthFunc(function);
+    depthFunction = function;
+}
+
+void GLStateCache::cullFace(GLenum mode) {
+    if (filter(cullFaceMode == mode)) {
+        return;
+    }
+    glCullFace(mode);
+    cullFaceMode = mode;
+}
+
+GLuint GLStateCache::getProgram() {
+    if (program == UNKNOWN) {
+        GLint current = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+        program = static_cast<GLuint>(current);
+    }
+    return program;
+}
+
+void GLStateCache::endFrame() {
+    frameStats = currentStats;
+    currentStats = GLStateCacheStats();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+
+// Calls made through the cache during one frame
+struct GLStateCacheStats {
+    uint32_t issuedCalls = 0;    // reached the driver
+    uint32_t filteredCalls = 0;  // dropped because the state was already set
+};
+
+// Shadow copy of the GL binding and fixed-function state so redundant calls never reach the driver.
+// Every state change in the renderer must go through it, otherwise the shadow goes stale;
+// call invalidate() after deleting bound objects or running code that bypasses the cache.
+class GLStateCache {
+public:
+    static const int MAX_TEXTURE_UNITS = 16;
+
+    GLStateCache();
+
+    // Forget all shadowed state: the next call of each kind always reaches the driver
+    void invalidate();
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vertexArray);
+    void bindBuffer(GLenum target, GLuint buffer);
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    // Texture bindings are per unit; bindTexture binds on the active unit like glBindTexture
+    void activeTexture(GLenum unit);
+    void bindTexture(GLenum target, GLuint texture);
+
+    // GL_BLEND, GL_DEPTH_TEST and GL_CULL_FACE are shadowed; other capabilities pass through
+    void enable(GLenum capability) { setEnabled(capability, true); }
+    void disable(GLenum capability) { setEnabled(capability, false); }
+    void setEnabled(GLenum capability, bool enabled);
+    bool isEnabled(GLenum capability);
+
+    void blendFunc(GLenum source, GLenum destination) { blendFuncSeparate(source, destination, source, destination); }
+    void blendFuncSeparate(GLenum sourceRGB, GLenum destinationRGB, GLenum sourceAlpha, GLenum destinationAlpha);
+    void depthMask(bool enabled);
+    void depthFunc(GLenum function);
+    void cullFace(GLenum mode);
+
+    GLuint getProgram();
+
+    // Closes the frame: its counts become getFrameStats() and counting restarts
+    void endFrame();
+    const GLStateCacheStats& getFrameStats() const { return frameStats; }
+
+private:
+    // Buffer targets whose generic binding is shadowed (GL 4.x enums as in GraphicsManager)
+    static const int BUFFER_TARGET_COUNT = 8;
+    static int bufferTargetSlot(GLenum target);
+
+    // Unknown is distinct from every valid GL name and value
+    static const GLuint UNKNOWN = 0xFFFFFFFFu;
+    enum class Tristate : uint8_t { Unknown, Off, On };
+    Tristate* capabilityShadow(GLenum capability);
+
+    bool filter(bool redundant) {
+        if (redundant) {
+            currentStats.filteredCalls++;
+        } else {
+            currentStats.issuedCalls++;
+        }
+        return redundant;
+    }
+
+    GLuint program;
+    GLuint vertexArray;
+    GLuint buffers[BUFFER_TARGET_COUNT];
+    GLenum activeUnit;
+    GLuint textures2D[MAX_TEXTURE_UNITS];
+    Tristate blend, depthTest, cullFaceEnabled;
+    GLenum blendState[4];
+    Tristate depthWrite;
+    GLenum depthFunction;
+    GLenum cullFaceMode;
+
+    GLStateCacheStats currentStats;
+    GLStateCacheStats frameStats;
+};
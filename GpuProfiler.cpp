@@ -0,0 +1,192 @@
+#include "GpuProfiler.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+GpuProfiler::GpuProfiler()
+    : supported(false)
+    , slots{}
+    , currentSlot(0)
+    , frameWindowSumMs(0.0)
+    , frameAverageMs(0.0)
+    , windowFrames(0)
+    , droppedFrames(0)
+    , totalFrames(0)
+    , frameTotalMs(0.0)
+{
+}
+
+bool GpuProfiler::initialize() {
+    // Timestamp queries are core in GL 3.3 but a driver may report a zero-bit counter
+    GLint counterBits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &counterBits);
+    if (counterBits == 0) {
+        std::cerr << "GL_TIMESTAMP queries not supported - GPU profiling disabled" << std::endl;
+        return false;
+    }
+
+    for (FrameSlot& slot : slots) {
+        glGenQueries(MAX_SCOPES_PER_FRAME * 2, slot.queries);
+        slot.recordCount = 0;
+        slot.queryCount = 0;
+        slot.pending = false;
+    }
+    supported = true;
+
+    std::cout << "GPU profiler initialized (" << counterBits << "-bit timestamps, "
+              << FRAME_LATENCY << " frames in flight)" << std::endl;
+    return true;
+}
+
+void GpuProfiler::cleanup() {
+    if (!supported) {
+        return;
+    }
+    for (FrameSlot& slot : slots) {
+        glDeleteQueries(MAX_SCOPES_PER_FRAME * 2, slot.queries);
+    }
+    supported = false;
+}
+
+int GpuProfiler::findOrAddTiming(const char* name, int parent) {
+    for (size_t i = 0; i < timings.size(); i++) {
+        if (timings[i].parent == parent && std::strcmp(timings[i].name, name) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+    int depth = parent >= 0 ? timings[parent].depth + 1 : 0;
+    timings.push_back({name, parent, depth, 0.0, 0.0});
+    windowSumsMs.push_back(0.0);
+    return static_cast<int>(timings.size()) - 1;
+}
+
+void GpuProfiler::beginScope(const char* name) {
+    if (!supported) {
+        return;
+    }
+
+    FrameSlot& slot = slots[currentSlot];
+    if (slot.recordCount == MAX_SCOPES_PER_FRAME) {
+        // Out of queries this frame: keep nesting balanced but don't time it
+        openScopes.push_back(-1);
+        return;
+    }
+
+    int parent = -1;
+    for (auto it = openScopes.rbegin(); it != openScopes.rend(); ++it) {
+        if (*it >= 0) {
+            parent = slot.records[*it].timing;
+            break;
+        }
+    }
+
+    ScopeRecord& record = slot.records[slot.recordCount];
+    record.timing = findOrAddTiming(name, parent);
+    record.beginQuery = slot.queryCount++;
+    record.endQuery = -1;
+    glQueryCounter(slot.queries[record.beginQuery], GL_TIMESTAMP);
+
+    openScopes.push_back(slot.recordCount++);
+}
+
+void GpuProfiler::endScope() {
+    if (!supported || openScopes.empty()) {
+        return;
+    }
+
+    int recordIndex = openScopes.back();
+    openScopes.pop_back();
+    if (recordIndex < 0) {
+        return;
+    }
+
+    FrameSlot& slot = slots[currentSlot];
+    ScopeRecord& record = slot.records[recordIndex];
+    record.endQuery = slot.queryCount++;
+    glQueryCounter(slot.queries[record.endQuery], GL_TIMESTAMP);
+}
+
+void GpuProfiler::endFrame() {
+    if (!supported) {
+        return;
+    }
+
+    // Scopes left open are closed at the frame boundary
+    while (!openScopes.empty()) {
+        endScope();
+    }
+
+    slots[currentSlot].pending = slots[currentSlot].recordCount > 0;
+    currentSlot = (currentSlot + 1) % FRAME_LATENCY;
+
+    // The next slot was submitted FRAME_LATENCY - 1 frames ago; read it only if the GPU is done
+    FrameSlot& oldest = slots[currentSlot];
+    if (oldest.pending) {
+        GLint available = 0;
+        glGetQueryObjectiv(oldest.queries[oldest.queryCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            resolveSlot(oldest);
+        } else {
+            droppedFrames++;
+        }
+    }
+    oldest.recordCount = 0;
+    oldest.queryCount = 0;
+    oldest.pending = false;
+}
+
+void GpuProfiler::resolveSlot(FrameSlot& slot) {
+    GLuint64 timestamps[MAX_SCOPES_PER_FRAME * 2];
+    for (int i = 0; i < slot.queryCount; i++) {
+        glGetQueryObjectui64v(slot.queries[i], GL_QUERY_RESULT, &timestamps[i]);
+    }
+
+    GLuint64 frameBegin = timestamps[0];
+    GLuint64 frameEnd = timestamps[0];
+    for (int i = 0; i < slot.recordCount; i++) {
+        const ScopeRecord& record = slot.records[i];
+        GLuint64 begin = timestamps[record.beginQuery];
+        GLuint64 end = timestamps[record.endQuery];
+        double scopeMs = static_cast<double>(end - begin) * 1e-6;
+        windowSumsMs[record.timing] += scopeMs;
+        timings[record.timing].totalMs += scopeMs;
+        frameBegin = std::min(frameBegin, begin);
+        frameEnd = std::max(frameEnd, end);
+    }
+    double frameMs = static_cast<double>(frameEnd - frameBegin) * 1e-6;
+    frameWindowSumMs += frameMs;
+    frameTotalMs += frameMs;
+    totalFrames++;
+
+    // Publish window averages; a scope absent from some frames averages in zero for them
+    if (++windowFrames == AVERAGE_FRAMES) {
+        for (size_t i = 0; i < timings.size(); i++) {
+            timings[i].averageMs = windowSumsMs[i] / AVERAGE_FRAMES;
+            windowSumsMs[i] = 0.0;
+        }
+        frameAverageMs = frameWindowSumMs / AVERAGE_FRAMES;
+        frameWindowSumMs = 0.0;
+        windowFrames = 0;
+    }
+}
+
+void GpuProfiler::resetTotals() {
+    for (GpuScopeTiming& timing : timings) {
+        timing.totalMs = 0.0;
+    }
+    totalFrames = 0;
+    frameTotalMs = 0.0;
+}
+
+std::string GpuProfiler::formatTimings() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "GPU: " << frameAverageMs << " ms profiled per frame";
+    for (const GpuScopeTiming& timing : timings) {
+        out << "\n  " << std::string(timing.depth * 2, ' ') << std::left << std::setw(24 - timing.depth * 2)
+            << timing.name << std::right << std::setw(8) << timing.averageMs << " ms";
+    }
+    return out.str();
+}
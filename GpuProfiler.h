@@ -0,0 +1,92 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Rolling GPU time of one named scope
+struct GpuScopeTiming {
+    const char* name;
+    int parent;           // index into the timing list, -1 for top-level scopes
+    int depth;
+    double averageMs;     // mean over the last completed averaging window
+    double totalMs;       // sum over every frame resolved since resetTotals()
+};
+
+// GPU pass timings from GL_TIMESTAMP queries. Each frame records into one slot of a ring of
+// FRAME_LATENCY slots and a slot is only read back when it comes around again, so results are
+// FRAME_LATENCY - 1 frames old and reading them never waits for the GPU.
+class GpuProfiler {
+public:
+    static const int FRAME_LATENCY = 4;
+    static const int MAX_SCOPES_PER_FRAME = 32;
+    static const int AVERAGE_FRAMES = 32;
+
+    GpuProfiler();
+
+    bool initialize();
+    void cleanup();
+    bool isSupported() const { return supported; }
+
+    // Scopes nest; names must outlive the profiler (string literals)
+    void beginScope(const char* name);
+    void endScope();
+
+    // Closes the frame's slot and reads back the oldest slot if the GPU has finished it
+    void endFrame();
+
+    // Scopes in first-seen order (parents before children)
+    const std::vector<GpuScopeTiming>& getTimings() const { return timings; }
+    double getFrameAverageMs() const { return frameAverageMs; }
+    uint32_t getDroppedFrames() const { return droppedFrames; }
+    
+    // Whole-run sums for benchmarks: totalMs of each scope and of the profiled frame
+    void resetTotals();
+    uint32_t getTotalFrames() const { return totalFrames; }
+    double getFrameTotalMs() const { return frameTotalMs; }
+    std::string formatTimings() const;
+
+private:
+    struct ScopeRecord {
+        int timing;
+        int beginQuery;
+        int endQuery;
+    };
+    struct FrameSlot {
+        GLuint queries[MAX_SCOPES_PER_FRAME * 2];
+        ScopeRecord records[MAX_SCOPES_PER_FRAME];
+        int recordCount;
+        int queryCount;
+        bool pending;
+    };
+
+    int findOrAddTiming(const char* name, int parent);
+    void resolveSlot(FrameSlot& slot);
+
+    bool supported;
+    FrameSlot slots[FRAME_LATENCY];
+    int currentSlot;
+    std::vector<int> openScopes; // record indices of scopes begun but not yet ended
+
+    std::vector<GpuScopeTiming> timings;
+    std::vector<double> windowSumsMs;
+    double frameWindowSumMs;
+    double frameAverageMs;
+    int windowFrames;
+    uint32_t droppedFrames;
+    uint32_t totalFrames;
+    double frameTotalMs;
+};
+
+// Times the enclosing block
+class GpuProfileScope {
+public:
+    GpuProfileScope(GpuProfiler& profiler, const char* name) : profiler(profiler) { profiler.beginScope(name); }
+    ~GpuProfileScope() { profiler.endScope(); }
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    GpuProfiler& profiler;
+};
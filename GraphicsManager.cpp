@@ -1,14 +1,102 @@
 #include "GraphicsManager.h"
 #include "MaterialSystem.h"
 #include "PhysicsManager.h"
+#include "MeshOptimizer.h"
+#include "RenderQueue.h"
+#include "CpuProfiler.h"
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include <random>
+#include <chrono>
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <set>
+
+// GL 4.x enums not in the GL 3.3 GLAD header
+namespace {
+    const GLenum GL_SHADER_STORAGE_BUFFER_LOCAL = 0x90D2;
+    const GLenum GL_DRAW_INDIRECT_BUFFER_LOCAL = 0x8F3F;
+    const GLenum GL_PARAMETER_BUFFER_LOCAL = 0x80EE;
+    const GLenum GL_DISPATCH_INDIRECT_BUFFER_LOCAL = 0x90EE;
+    const GLbitfield GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT_LOCAL = 0x00000001;
+    const GLbitfield GL_SHADER_STORAGE_BARRIER_BIT_LOCAL = 0x00002000;
+    const GLbitfield GL_COMMAND_BARRIER_BIT_LOCAL = 0x00000040;
+    const GLbitfield GL_BUFFER_UPDATE_BARRIER_BIT_LOCAL = 0x00000200;
+    const GLbitfield GL_TEXTURE_FETCH_BARRIER_BIT_LOCAL = 0x00000008;
+    const GLbitfield GL_SHADER_IMAGE_ACCESS_BARRIER_BIT_LOCAL = 0x00000020;
+    const GLbitfield GL_TEXTURE_UPDATE_BARRIER_BIT_LOCAL = 0x00000100;
+    const GLenum GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT_LOCAL = 0x90DF;
+
+    // Splices each #include "file" line in with the file's text (one level, paths relative to
+    // the working directory like the shaders themselves); #line keeps compiler messages on the
+    // including file's line numbers
+    bool expandShaderIncludes(std::string& source) {
+        std::istringstream input(source);
+        std::ostringstream output;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(input, line)) {
+            lineNumber++;
+            if (line.compare(0, 9, "#include ") != 0) {
+                output << line << '\n';
+                continue;
+            }
+            size_t open = line.find('"');
+            size_t close = line.rfind('"');
+            if (open == std::string::npos || close <= open) {
+                std::cerr << "Malformed shader include: " << line << std::endl;
+                return false;
+            }
+            std::string path = line.substr(open + 1, close - open - 1);
+            std::ifstream included(path, std::ios::in);
+            if (!included.is_open()) {
+                std::cerr << "Impossible to open included shader " << path << std::endl;
+                return false;
+            }
+            output << included.rdbuf() << '\n' << "#line " << lineNumber + 1 << '\n';
+        }
+        source = output.str();
+        return true;
+    }
+
+    // Spreads the low 16 bits of v over the even bits
+    uint32_t spreadBits(uint32_t v) {
+        v &= 0xffff;
+        v = (v | (v << 8)) & 0x00ff00ff;
+        v = (v | (v << 4)) & 0x0f0f0f0f;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    }
+
+    uint32_t mortonCode(uint32_t x, uint32_t y) {
+        return spreadBits(x) | (spreadBits(y) << 1);
+    }
+
+    // Sphere of the raytracing benchmarks' fixed scenes; type 0 diffuse, 1 metal, 2 glass
+    RTSphere makeBenchSphere(const glm::vec3& center, float radius, const glm::vec3& albedo, const glm::vec3& specular,
+                             float shininess, int type) {
+        RTSphere sphere;
+        sphere.center = center;
+        sphere.radius = radius;
+        sphere.material.albedo = albedo;
+        sphere.material.specular = specular;
+        sphere.material.shininess = shininess;
+        sphere.material.metallic = type == 1 ? 0.8f : 0.0f;
+        sphere.material.roughness = 1.0f / std::sqrt(shininess);
+        sphere.material.ior = 1.5f;
+        sphere.material.type = type;
+        return sphere;
+    }
+}
+
+GLADloadproc GraphicsManager::procAddressLoader = (GLADloadproc)glfwGetProcAddress;
 
 GraphicsManager::GraphicsManager() 
     : sphereVAO(0), sphereVBO(0), sphereEBO(0)
@@ -22,22 +110,64 @@ GraphicsManager::GraphicsManager()
     , currentLightPos(1.2f, 1.0f, 2.0f)
     , currentLightColor(1.0f, 1.0f, 1.0f)
     , pglDispatchCompute(nullptr)
+    , pglDispatchComputeIndirect(nullptr)
     , pglBindImageTexture(nullptr)
     , pglMemoryBarrier(nullptr)
-    , fpsShaderProgram(0)
-    , fpsVAO(0), fpsVBO(0)
-    , fpsDisplayInitialized(false)
+    , pglMultiDrawElementsIndirect(nullptr)
+    , pglMultiDrawElementsIndirectCount(nullptr)
+    , pglClearBufferData(nullptr)
     , depthPrepassShader(0)
     , lightCullingComputeShader(0)
     , tiledForwardShader(0)
     , depthTexture(0)
     , lightListBuffer(0)
     , visibleLightIndicesBuffer(0)
-    , lightDataBuffer(0)
     , forwardPlusSupported(false)
+    , outputFramebuffer(0)
+    , impostorShader(0)
+    , impostorVAO(0), impostorQuadVBO(0)
+    , sphereImpostorsEnabled(false)
+    , gpuCullingComputeShader(0)
+    , gpuDrivenShader(0)
+    , gpuDrivenVAO(0)
+    , drawCommandBuffer(0), drawCountBuffer(0)
+    , cullObjectCapacity(0)
+    , gpuCullingSupported(false)
+    , gpuCullingEnabled(false)
+    , hiZDownsampleShader(0)
+    , occlusionDepthFBO(0), occlusionDepthTexture(0)
+    , hiZTexture(0)
+    , hiZWidth(0), hiZHeight(0), hiZLevels(0)
+    , hiZSupported(false)
+    , hiZOcclusionEnabled(false)
+    , hiZReady(false)
+    , statsReadbackBuffers{}
+    , statsFences{}
+    , statsObjectCounts{}
+    , statsFrameIndex(0)
+    , oitAccumulateShader(0), oitCompositeShader(0)
+    , oitFBO(0), oitAccumulationTexture(0), oitWeightTexture(0), oitDepthRenderbuffer(0)
+    , oitVAO(0), oitCompositeVAO(0)
+    , oitSupported(false)
+    , oitDepthCopyVerified(false), oitDepthCopySupported(true)
     , numTilesX(0), numTilesY(0)
     , maxLightsPerTile(1024)
+    , shadowsEnabled(true)
+    , lastMainObjectPos(0.0f)
+    , mainSphereStatic(false)
+    , pointShadowsInitAttempted(false)
+    , pointShadowRecords(0)
+    , storageBufferAlignment(256)
     , useVulkanRenderer(false)
+    , raytracingFrameIndex(0)
+    , raytracingSampler(RaytracingSampler::Sobol)
+    , denoiseShader(0)
+    , denoiseIterations(4)
+    , adaptiveTileBuffer(0)
+    , adaptiveErrorThreshold(0.01f)
+    , tileQueueBuffer(0)
+    , tileQueueWidth(0), tileQueueHeight(0)
+    , persistentWorkGroups(0)
 {
 }
 
@@ -91,6 +221,15 @@ bool GraphicsManager::initialize(unsigned int width, unsigned int height) {
                 raytracingSupported = false;
             } else {
                 createFullscreenQuad();
+                if (!blueNoise.initialize(glState)) {
+                    std::cerr << "Blue noise sampling unavailable" << std::endl;
+                }
+                if (!initDenoiser()) {
+                    std::cerr << "Raytracing denoiser unavailable" << std::endl;
+                }
+                if (!initAdaptiveSampling()) {
+                    std::cerr << "Adaptive sampling unavailable" << std::endl;
+                }
                 std::cout << "Raytracing initialized successfully!" << std::endl;
             }
         }
@@ -100,16 +239,76 @@ bool GraphicsManager::initialize(unsigned int width, unsigned int height) {
     std::vector<float> sphereVertices;
     std::vector<unsigned int> sphereIndices;
     createSphereMesh(sphereVertices, sphereIndices, 0.5f, 32);
+    optimizeMesh("Sphere", sphereVertices, sphereIndices, 8);
     setupSphereBuffers(sphereVertices, sphereIndices);
     
     // Create floor mesh
     std::vector<float> floorVertices;
     std::vector<unsigned int> floorIndices;
     createFloorMesh(floorVertices, floorIndices);
+    optimizeMesh("Floor", floorVertices, floorIndices, 9);
     setupFloorBuffers(floorVertices, floorIndices);
     
-    // Initialize FPS display
-    initFPSDisplay();
+    // Per-frame dynamic data (instances, lights, overlay vertices) streams through one fenced
+    // ring; persistent mapping needs GL 4.4 or ARB_buffer_storage
+    int glMajor = 0, glMinor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &glMajor);
+    glGetIntegerv(GL_MINOR_VERSION, &glMinor);
+    PFNGLBUFFERSTORAGEPROC_LOCAL bufferStorage = nullptr;
+    if (glMajor > 4 || (glMajor == 4 && glMinor >= 4) || hasExtension("GL_ARB_buffer_storage")) {
+        bufferStorage = (PFNGLBUFFERSTORAGEPROC_LOCAL)procAddressLoader("glBufferStorage");
+    }
+    if (!streamingBuffer.initialize(glState, STREAMING_REGION_SIZE, bufferStorage)) {
+        return false;
+    }
+    // Streamed SSBO ranges (lights, culling objects) must start at this alignment
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT_LOCAL, &storageBufferAlignment);
+    if (glGetError() != GL_NO_ERROR || storageBufferAlignment <= 0) {
+        storageBufferAlignment = 256;
+    }
+    
+    // Main light shadows for the raster paths
+    if (!initShadowMaps()) {
+        std::cout << "Shadow maps unavailable - raster paths render unshadowed" << std::endl;
+    }
+    
+    // Stats overlay (one batched draw per frame)
+    if (!textOverlay.initialize(loadShaders("text_overlay_vertex.glsl", "text_overlay_fragment.glsl"), glState)) {
+        std::cout << "Stats overlay unavailable" << std::endl;
+    }
+    
+    // GPU pass timings for the overlay and console
+    if (!gpuProfiler.initialize()) {
+        std::cout << "GPU profiler unavailable - overlay shows CPU frame time only" << std::endl;
+    }
+    
+    // Initialize ray-cast sphere impostors
+    if (!initSphereImpostors()) {
+        std::cout << "Sphere impostors unavailable - using sphere meshes" << std::endl;
+    }
+    
+    // Initialize weighted blended order-independent transparency
+    oitSupported = initOIT();
+    if (!oitSupported) {
+        std::cout << "Order-independent transparency unavailable - glass spheres drawn opaque" << std::endl;
+    }
+    
+    // Initialize GPU-driven culling (requires compute shaders)
+    if (raytracingSupported) {
+        gpuCullingSupported = initGpuCulling();
+        if (!gpuCullingSupported) {
+            std::cout << "GPU-driven culling unavailable - submitting objects from the CPU" << std::endl;
+        }
+    }
+    
+    // Hi-Z occlusion culling extends the GPU culling pass
+    if (gpuCullingSupported) {
+        hiZSupported = initHiZ();
+        hiZOcclusionEnabled = hiZSupported;
+        if (!hiZSupported) {
+            std::cout << "Hi-Z occlusion culling unavailable - frustum culling only" << std::endl;
+        }
+    }
     
     // Initialize Forward+ rendering if supported
     if (raytracingSupported) { // Forward+ requires compute shader support
@@ -129,6 +328,8 @@ bool GraphicsManager::initialize(unsigned int width, unsigned int height) {
 }
 
 void GraphicsManager::cleanup() {
+    frameCapture.stop(glState);
+    
     if (sphereVAO) {
         glDeleteVertexArrays(1, &sphereVAO);
         glDeleteBuffers(1, &sphereVBO);
@@ -153,15 +354,35 @@ void GraphicsManager::cleanup() {
     if (floorShaderProgram) glDeleteProgram(floorShaderProgram);
     if (computeShader) glDeleteProgram(computeShader);
     if (fullscreenShader) glDeleteProgram(fullscreenShader);
-    if (fpsShaderProgram) glDeleteProgram(fpsShaderProgram);
+    textOverlay.cleanup();
+    streamingBuffer.cleanup();
+    shadowMaps.cleanup();
+    pointShadows.cleanup();
+    blueNoise.cleanup();
+    cleanupDenoiser();
+    if (adaptiveTileBuffer) {
+        glDeleteBuffers(1, &adaptiveTileBuffer);
+        adaptiveTileBuffer = 0;
+    }
+    if (tileQueueBuffer) {
+        glDeleteBuffers(1, &tileQueueBuffer);
+        tileQueueBuffer = 0;
+        tileQueueWidth = tileQueueHeight = 0;
+    }
     
-    if (fpsVAO) {
-        glDeleteVertexArrays(1, &fpsVAO);
-        glDeleteBuffers(1, &fpsVBO);
+    if (impostorVAO) {
+        glDeleteVertexArrays(1, &impostorVAO);
+        glDeleteBuffers(1, &impostorQuadVBO);
     }
+    if (impostorShader) glDeleteProgram(impostorShader);
+    
+    cleanupHiZ();
+    cleanupOIT();
+    gpuProfiler.cleanup();
     
     // Cleanup Forward+ resources
     cleanupForwardPlus();
+    cleanupGpuCulling();
 }
 
 GLuint GraphicsManager::loadShaders(const char* vertex_file_path, const char* fragment_file_path) {
@@ -269,6 +490,9 @@ GLuint GraphicsManager::loadComputeShader(const char* compute_file_path) {
         std::cerr << "Impossible to open " << compute_file_path << std::endl;
         return 0;
     }
+    if (!expandShaderIncludes(ComputeShaderCode)) {
+        return 0;
+    }
 
     GLint Result = GL_FALSE;
     int InfoLogLength;
@@ -370,32 +594,42 @@ void GraphicsManager::createFloorMesh(std::vector<float>& vertices, std::vector<
     };
 }
 
+void GraphicsManager::optimizeMesh(const char* name, std::vector<float>& vertices, std::vector<unsigned int>& indices, size_t vertexStride) {
+    MeshOptimizationReport report = MeshOptimizer::optimize(vertices, indices, vertexStride);
+    
+    std::cout << name << " mesh optimized (" << report.after.triangleCount << " triangles): ACMR "
+              << std::fixed << std::setprecision(3) << report.before.acmr << " -> " << report.after.acmr
+              << ", ATVR " << report.before.atvr << " -> " << report.after.atvr << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+}
+
 void GraphicsManager::beginFrame() {
     // Clear framebuffer for forward rendering
     glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
     // Enable depth testing for proper forward rendering
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
+    glState.enable(GL_DEPTH_TEST);
+    glState.depthFunc(GL_LESS);
     
     // Enable alpha blending for transparent objects
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glState.enable(GL_BLEND);
+    glState.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 void GraphicsManager::endFrame() {
-    // Nothing specific needed here for now
+    // Fence this frame's streaming region, then close the redundant-state statistics and GPU timing slot
+    streamingBuffer.endFrame(glState);
+    shadowMaps.endFrame();
+    pointShadows.endFrame();
+    glState.endFrame();
+    gpuProfiler.endFrame();
 }
 
 void GraphicsManager::renderSphere(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection, 
                                   const Material& material, bool useEnhancedFeatures) {
-    // Bind main shader program (optimized - only bind if different)
-    static GLuint lastProgram = 0;
-    if (lastProgram != mainShaderProgram) {
-        glUseProgram(mainShaderProgram);
-        lastProgram = mainShaderProgram;
-    }
+    // Redundant binds are filtered by the state cache
+    glState.useProgram(mainShaderProgram);
     
     // Set matrices
     glUniformMatrix4fv(glGetUniformLocation(mainShaderProgram, "model"), 1, GL_FALSE, &model[0][0]);
@@ -415,17 +649,13 @@ void GraphicsManager::renderSphere(const glm::mat4& model, const glm::mat4& view
     // Set material
     setMaterialUniforms(mainShaderProgram, material, useEnhancedFeatures);
     
-    glBindVertexArray(sphereVAO);
+    glState.bindVertexArray(sphereVAO);
     glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
 }
 
 void GraphicsManager::renderFloor(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) {
-    // Bind floor shader program (optimized - only bind if different)
-    static GLuint lastProgram = 0;
-    if (lastProgram != floorShaderProgram) {
-        glUseProgram(floorShaderProgram);
-        lastProgram = floorShaderProgram;
-    }
+    // Redundant binds are filtered by the state cache
+    glState.useProgram(floorShaderProgram);
     
     // Set matrices
     glUniformMatrix4fv(glGetUniformLocation(floorShaderProgram, "model"), 1, GL_FALSE, &model[0][0]);
@@ -436,12 +666,12 @@ void GraphicsManager::renderFloor(const glm::mat4& model, const glm::mat4& view,
     glUniform3f(glGetUniformLocation(floorShaderProgram, "lightPos"), currentLightPos.x, currentLightPos.y, currentLightPos.z);
     glUniform3f(glGetUniformLocation(floorShaderProgram, "lightColor"), currentLightColor.x, currentLightColor.y, currentLightColor.z);
     
-    glBindVertexArray(floorVAO);
+    glState.bindVertexArray(floorVAO);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 }
 
 void GraphicsManager::renderBullet(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) {
-    glUseProgram(mainShaderProgram);
+    glState.useProgram(mainShaderProgram);
     
     // Set matrices
     glUniformMatrix4fv(glGetUniformLocation(mainShaderProgram, "model"), 1, GL_FALSE, &model[0][0]);
@@ -452,19 +682,22 @@ void GraphicsManager::renderBullet(const glm::mat4& model, const glm::mat4& view
     glUniform3f(glGetUniformLocation(mainShaderProgram, "lightPos"), currentLightPos.x, currentLightPos.y, currentLightPos.z);
     glUniform3f(glGetUniformLocation(mainShaderProgram, "lightColor"), currentLightColor.x, currentLightColor.y, currentLightColor.z);
     
-    // Set bullet properties
+    setBulletMaterialUniforms();
+    
+    glState.bindVertexArray(sphereVAO);
+    glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+}
+
+void GraphicsManager::setBulletMaterialUniforms() {
     glUniform3f(glGetUniformLocation(mainShaderProgram, "objectColor"), 1.0f, 1.0f, 0.0f);
     glUniform1i(glGetUniformLocation(mainShaderProgram, "shadingModel"), 1); // Blinn-Phong
     glUniform1i(glGetUniformLocation(mainShaderProgram, "useMaterial"), 0); // Disable material mode
     glUniform1i(glGetUniformLocation(mainShaderProgram, "enableReflections"), 1);
     glUniform1f(glGetUniformLocation(mainShaderProgram, "ambientOcclusion"), 0.0f);
-    
-    glBindVertexArray(sphereVAO);
-    glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
 }
 
 void GraphicsManager::renderSpawned(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) {
-    glUseProgram(mainShaderProgram);
+    glState.useProgram(mainShaderProgram);
     
     // Set matrices
     glUniformMatrix4fv(glGetUniformLocation(mainShaderProgram, "model"), 1, GL_FALSE, &model[0][0]);
@@ -475,239 +708,1888 @@ void GraphicsManager::renderSpawned(const glm::mat4& model, const glm::mat4& vie
     glUniform3f(glGetUniformLocation(mainShaderProgram, "lightPos"), currentLightPos.x, currentLightPos.y, currentLightPos.z);
     glUniform3f(glGetUniformLocation(mainShaderProgram, "lightColor"), currentLightColor.x, currentLightColor.y, currentLightColor.z);
     
-    // Set spawned sphere properties
+    setSpawnedMaterialUniforms();
+    
+    glState.bindVertexArray(sphereVAO);
+    glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+}
+
+void GraphicsManager::setSpawnedMaterialUniforms() {
     glUniform3f(glGetUniformLocation(mainShaderProgram, "objectColor"), 0.3f, 0.8f, 0.3f);
     glUniform1i(glGetUniformLocation(mainShaderProgram, "shadingModel"), 0); // Lambert
     glUniform1i(glGetUniformLocation(mainShaderProgram, "useMaterial"), 0); // Disable material mode
     glUniform1i(glGetUniformLocation(mainShaderProgram, "enableReflections"), 0);
     glUniform1f(glGetUniformLocation(mainShaderProgram, "ambientOcclusion"), 0.2f);
-    
-    glBindVertexArray(sphereVAO);
-    glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
 }
 
-bool GraphicsManager::initRaytracing() {
-    // Create raytracing texture
-    glGenTextures(1, &raytracingTexture);
-    glBindTexture(GL_TEXTURE_2D, raytracingTexture);
-    
-    // Use GL_RGBA32F if available, otherwise fall back to GL_RGBA
-    GLenum internalFormat = GL_RGBA32F;
-    GLenum error = glGetError(); // Clear any existing errors
+namespace {
+    // Per-instance vertex data for sphere impostors
+    struct SphereImpostorInstance {
+        glm::vec4 centerRadius;
+        glm::vec4 albedo;
+        glm::vec4 specular; // rgb = specular color, a = shininess
+    };
+}
+
+bool GraphicsManager::initSphereImpostors() {
+    impostorShader = loadShaders("sphere_impostor_vertex.glsl", "sphere_impostor_fragment.glsl");
+    if (impostorShader == 0) {
+        std::cerr << "Failed to load sphere impostor shaders" << std::endl;
+        return false;
+    }
     
-    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, screenWidth, screenHeight, 0, GL_RGBA, GL_FLOAT, NULL);
+    // Unit quad drawn as a triangle strip
+    float quadCorners[] = {
+        -1.0f, -1.0f,
+         1.0f, -1.0f,
+        -1.0f,  1.0f,
+         1.0f,  1.0f
+    };
     
-    error = glGetError();
-    if (error != GL_NO_ERROR) {
-        std::cerr << "Error creating raytracing texture: " << error << std::endl;
-        // Try with a simpler format
-        internalFormat = GL_RGBA;
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, screenWidth, screenHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-        error = glGetError();
-        if (error != GL_NO_ERROR) {
-            std::cerr << "Failed to create raytracing texture with fallback format: " << error << std::endl;
-            return false;
-        }
-    }
+    glGenVertexArrays(1, &impostorVAO);
+    glGenBuffers(1, &impostorQuadVBO);
     
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glState.bindVertexArray(impostorVAO);
+    glState.bindBuffer(GL_ARRAY_BUFFER, impostorQuadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadCorners), quadCorners, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
     
-    // Bind as image texture for compute shader
-    if (pglBindImageTexture) {
-        pglBindImageTexture(0, raytracingTexture, 0, GL_FALSE, 0, GL_READ_WRITE, internalFormat);
-        error = glGetError();
-        if (error != GL_NO_ERROR) {
-            std::cerr << "Error binding image texture: " << error << std::endl;
-            return false;
-        }
-    } else {
-        std::cerr << "glBindImageTexture function not available" << std::endl;
-        return false;
+    // Instance attributes advance once per sphere; they point into the streaming buffer per frame
+    for (int i = 0; i < 3; i++) {
+        glEnableVertexAttribArray(1 + i);
+        glVertexAttribDivisor(1 + i, 1);
     }
     
-    std::cout << "Raytracing texture created successfully with format: " << internalFormat << std::endl;
+    glState.bindVertexArray(0);
+    std::cout << "Sphere impostors initialized successfully!" << std::endl;
     return true;
 }
 
-void GraphicsManager::createFullscreenQuad() {
-    float quadVertices[] = {
-        // positions   // texCoords
-        -1.0f,  1.0f,  0.0f, 1.0f,
-        -1.0f, -1.0f,  0.0f, 0.0f,
-         1.0f, -1.0f,  1.0f, 0.0f,
-
-        -1.0f,  1.0f,  0.0f, 1.0f,
-         1.0f, -1.0f,  1.0f, 0.0f,
-         1.0f,  1.0f,  1.0f, 1.0f
-    };
-
-    unsigned int quadVBO;
-    glGenVertexArrays(1, &fullscreenVAO);
-    glGenBuffers(1, &quadVBO);
-    glBindVertexArray(fullscreenVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-}
-
-void GraphicsManager::renderRaytraced(const std::vector<RTSphere>& spheres, const glm::vec3& cameraPos, 
-                                     const glm::vec3& cameraFront, const glm::vec3& cameraUp, const glm::vec3& cameraRight,
-                                     const glm::vec3& lightPos, const glm::vec3& lightColor, float time,
-                                     int maxBounces, int numSamples, float exposure, bool enableToneMapping) {
-    // Debug output
-    static bool firstCall = true;
-    if (firstCall) {
-        std::cout << "First raytraced render call - Spheres: " << spheres.size() << std::endl;
-        std::cout << "Camera pos: " << cameraPos.x << ", " << cameraPos.y << ", " << cameraPos.z << std::endl;
-        std::cout << "Screen size: " << screenWidth << "x" << screenHeight << std::endl;
-        firstCall = false;
+void GraphicsManager::renderSphereImpostors(const glm::mat4& view, const glm::mat4& projection, const std::vector<RTSphere>& spheres) {
+    if (spheres.empty() || impostorShader == 0) {
+        return;
     }
     
-    // Clear any existing OpenGL errors
-    while (glGetError() != GL_NO_ERROR);
+    std::vector<SphereImpostorInstance> instances(spheres.size());
+    for (size_t i = 0; i < spheres.size(); i++) {
+        const RTSphere& sphere = spheres[i];
+        instances[i].centerRadius = glm::vec4(sphere.center, sphere.radius);
+        instances[i].albedo = glm::vec4(sphere.material.albedo, 1.0f);
+        instances[i].specular = glm::vec4(sphere.material.specular, sphere.material.shininess);
+    }
     
-    // Use compute shader for raytracing
-    glUseProgram(computeShader);
+    StreamingAllocation instanceData = streamingBuffer.upload(glState, instances.data(),
+                                                              instances.size() * sizeof(SphereImpostorInstance), sizeof(float));
+    if (!instanceData.buffer) {
+        return;
+    }
     
-    // Set camera uniforms
-    glUniform3f(glGetUniformLocation(computeShader, "cameraPos"), cameraPos.x, cameraPos.y, cameraPos.z);
-    glUniform3f(glGetUniformLocation(computeShader, "cameraFront"), cameraFront.x, cameraFront.y, cameraFront.z);
-    glUniform3f(glGetUniformLocation(computeShader, "cameraUp"), cameraUp.x, cameraUp.y, cameraUp.z);
-    glUniform3f(glGetUniformLocation(computeShader, "cameraRight"), cameraRight.x, cameraRight.y, cameraRight.z);
-    glUniform1f(glGetUniformLocation(computeShader, "fov"), glm::radians(45.0f));
-    glUniform1f(glGetUniformLocation(computeShader, "aspectRatio"), (float)screenWidth / (float)screenHeight);
-    glUniform1i(glGetUniformLocation(computeShader, "maxBounces"), maxBounces);
-    glUniform1i(glGetUniformLocation(computeShader, "numSamples"), numSamples);
-    glUniform3f(glGetUniformLocation(computeShader, "lightPos"), lightPos.x, lightPos.y, lightPos.z);
-    glUniform3f(glGetUniformLocation(computeShader, "lightColor"), lightColor.x, lightColor.y, lightColor.z);
-    glUniform1f(glGetUniformLocation(computeShader, "time"), time);
+    glm::vec3 lightPosView = glm::vec3(view * glm::vec4(currentLightPos, 1.0f));
     
-    // Set scene uniforms
-    glUniform1i(glGetUniformLocation(computeShader, "numSpheres"), static_cast<int>(spheres.size()));
+    glState.useProgram(impostorShader);
+    glUniformMatrix4fv(glGetUniformLocation(impostorShader, "view"), 1, GL_FALSE, &view[0][0]);
+    glUniformMatrix4fv(glGetUniformLocation(impostorShader, "projection"), 1, GL_FALSE, &projection[0][0]);
+    glUniform3f(glGetUniformLocation(impostorShader, "lightPosView"), lightPosView.x, lightPosView.y, lightPosView.z);
+    glUniform3f(glGetUniformLocation(impostorShader, "lightColor"), currentLightColor.x, currentLightColor.y, currentLightColor.z);
     
-    // Upload sphere data (simplified - in a real implementation you'd use uniform buffers)
-    for (int i = 0; i < std::min(static_cast<int>(spheres.size()), 20); i++) {
-        std::string prefix = "spheres[" + std::to_string(i) + "]";
-        glUniform3f(glGetUniformLocation(computeShader, (prefix + ".center").c_str()), 
-                   spheres[i].center.x, spheres[i].center.y, spheres[i].center.z);
-        glUniform1f(glGetUniformLocation(computeShader, (prefix + ".radius").c_str()), 
-                   spheres[i].radius);
-        glUniform3f(glGetUniformLocation(computeShader, (prefix + ".material.albedo").c_str()), 
-                   spheres[i].material.albedo.x, spheres[i].material.albedo.y, spheres[i].material.albedo.z);
-        glUniform3f(glGetUniformLocation(computeShader, (prefix + ".material.specular").c_str()), 
-                   spheres[i].material.specular.x, spheres[i].material.specular.y, spheres[i].material.specular.z);
-        glUniform1f(glGetUniformLocation(computeShader, (prefix + ".material.shininess").c_str()), 
-                   spheres[i].material.shininess);
-        glUniform1f(glGetUniformLocation(computeShader, (prefix + ".material.metallic").c_str()), 
-                   spheres[i].material.metallic);
-        glUniform1f(glGetUniformLocation(computeShader, (prefix + ".material.roughness").c_str()), 
-                   spheres[i].material.roughness);
-        glUniform1f(glGetUniformLocation(computeShader, (prefix + ".material.ior").c_str()), 
-                   spheres[i].material.ior);
-        glUniform1i(glGetUniformLocation(computeShader, (prefix + ".material.type").c_str()), 
-                   spheres[i].material.type);
+    glState.bindVertexArray(impostorVAO);
+    bindInstanceAttributes(instanceData, 1, 3, sizeof(SphereImpostorInstance));
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(instances.size()));
+}
+
+void GraphicsManager::runSphereBenchmark(int sphereCount, int frames) {
+    // Deterministic field of small spheres in front of the camera
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> spread(-20.0f, 20.0f);
+    std::uniform_real_distribution<float> depth(-60.0f, -5.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    
+    std::vector<RTSphere> spheres(sphereCount);
+    for (auto& sphere : spheres) {
+        sphere.center = glm::vec3(spread(rng), spread(rng) * 0.5f, depth(rng));
+        sphere.radius = 0.05f + unit(rng) * 0.1f;
+        sphere.material.albedo = glm::vec3(unit(rng), unit(rng), unit(rng));
+        sphere.material.specular = glm::vec3(0.5f);
+        sphere.material.shininess = 32.0f;
     }
     
-    // Set floor uniforms
-    glUniform3f(glGetUniformLocation(computeShader, "floorNormal"), 0.0f, 1.0f, 0.0f);
-    glUniform1f(glGetUniformLocation(computeShader, "floorDistance"), 0.5f);
-    
-    RTMaterial floorMat;
-    floorMat.albedo = glm::vec3(0.3f, 0.3f, 0.3f);
-    floorMat.specular = glm::vec3(0.2f, 0.2f, 0.2f);
-    floorMat.shininess = 16.0f;
-    floorMat.metallic = 0.0f;
-    floorMat.roughness = 0.8f;
-    floorMat.ior = 1.0f;
-    floorMat.type = 0;
-    
-    glUniform3f(glGetUniformLocation(computeShader, "floorMaterial.albedo"), 
-               floorMat.albedo.x, floorMat.albedo.y, floorMat.albedo.z);
-    glUniform3f(glGetUniformLocation(computeShader, "floorMaterial.specular"), 
-               floorMat.specular.x, floorMat.specular.y, floorMat.specular.z);
-    glUniform1f(glGetUniformLocation(computeShader, "floorMaterial.shininess"), floorMat.shininess);
-    glUniform1f(glGetUniformLocation(computeShader, "floorMaterial.metallic"), floorMat.metallic);
-    glUniform1f(glGetUniformLocation(computeShader, "floorMaterial.roughness"), floorMat.roughness);
-    glUniform1f(glGetUniformLocation(computeShader, "floorMaterial.ior"), floorMat.ior);
-    glUniform1i(glGetUniformLocation(computeShader, "floorMaterial.type"), floorMat.type);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)screenWidth / (float)screenHeight, 0.1f, 100.0f);
     
-    // Bind the raytracing texture as an image for writing - this should be done once during initialization
-    // But we'll do it here to ensure it's properly bound
-    if (pglBindImageTexture) {
-        pglBindImageTexture(0, raytracingTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
-    }
+    std::cout << "=== Sphere benchmark: " << sphereCount << " spheres, " << frames << " frames ===" << std::endl;
     
-    // Dispatch compute shader
-    if (pglDispatchCompute && pglMemoryBarrier) {
-        GLuint workGroupsX = (screenWidth + 15) / 16;
-        GLuint workGroupsY = (screenHeight + 15) / 16;
-        pglDispatchCompute(workGroupsX, workGroupsY, 1);
+    for (int pass = 0; pass < 2; pass++) {
+        bool impostors = (pass == 1);
+        if (impostors && impostorShader == 0) {
+            std::cout << "Impostor path unavailable" << std::endl;
+            break;
+        }
         
-        // Wait for compute shader to finish
-        pglMemoryBarrier(0x00000008); // GL_SHADER_IMAGE_ACCESS_BARRIER_BIT = 0x00000008
+        glFinish();
+        auto start = std::chrono::high_resolution_clock::now();
         
-        // Debug: Check for OpenGL errors
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            static int errorCount = 0;
-            if (errorCount < 5) { // Only show first 5 errors
-                std::cerr << "OpenGL error after compute dispatch: " << error << std::endl;
-                errorCount++;
+        for (int frame = 0; frame < frames; frame++) {
+            beginFrame();
+            glState.disable(GL_BLEND);
+            
+            if (impostors) {
+                renderSphereImpostors(view, projection, spheres);
+            } else {
+                glState.useProgram(mainShaderProgram);
+                glUniformMatrix4fv(glGetUniformLocation(mainShaderProgram, "view"), 1, GL_FALSE, &view[0][0]);
+                glUniformMatrix4fv(glGetUniformLocation(mainShaderProgram, "projection"), 1, GL_FALSE, &projection[0][0]);
+                glUniform1i(glGetUniformLocation(mainShaderProgram, "useMaterial"), 0);
+                glUniform1i(glGetUniformLocation(mainShaderProgram, "shadingModel"), 1);
+                glState.bindVertexArray(sphereVAO);
+                
+                GLint modelLoc = glGetUniformLocation(mainShaderProgram, "model");
+                GLint colorLoc = glGetUniformLocation(mainShaderProgram, "objectColor");
+                for (const auto& sphere : spheres) {
+                    // Sphere mesh has radius 0.5
+                    glm::mat4 model = glm::translate(glm::mat4(1.0f), sphere.center);
+                    model = glm::scale(model, glm::vec3(sphere.radius * 2.0f));
+                    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &model[0][0]);
+                    glUniform3f(colorLoc, sphere.material.albedo.x, sphere.material.albedo.y, sphere.material.albedo.z);
+                    glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+                }
             }
         }
-    } else {
-        std::cerr << "Compute shader dispatch functions not available" << std::endl;
-        return;
-    }
-    
-    // Render fullscreen quad with the raytraced result
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glUseProgram(fullscreenShader);
-    
-    // Bind the raytracing texture for reading
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, raytracingTexture);
-    glUniform1i(glGetUniformLocation(fullscreenShader, "screenTexture"), 0);
-    glUniform1f(glGetUniformLocation(fullscreenShader, "exposure"), exposure);
-    glUniform1i(glGetUniformLocation(fullscreenShader, "enableToneMapping"), enableToneMapping ? 1 : 0);
-    
-    glBindVertexArray(fullscreenVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    
-    // Debug: Check for OpenGL errors
-    GLenum error = glGetError();
-    if (error != GL_NO_ERROR) {
-        static int errorCount = 0;
-        if (errorCount < 5) { // Only show first 5 errors
-            std::cerr << "OpenGL error after fullscreen render: " << error << std::endl;
-            errorCount++;
-        }
+        
+        glFinish();
+        double totalMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        
+        std::cout << (impostors ? "Impostors: " : "Meshes:    ")
+                  << std::fixed << std::setprecision(2) << totalMs / frames << " ms/frame, "
+                  << (impostors ? 4 : sphereIndexCount) << " vertices per sphere" << std::endl;
     }
 }
 
-void GraphicsManager::setLightProperties(const glm::vec3& lightPos, const glm::vec3& lightColor) {
-    currentLightPos = lightPos;
-    currentLightColor = lightColor;
+namespace {
+    // RTMaterial::type of glass (see buildRaytracingScene)
+    const int RT_MATERIAL_GLASS = 2;
+    
+    // Coverage of a glass surface seen head-on; the shader raises it towards grazing angles
+    const float GLASS_ALPHA = 0.3f;
+    
+    // Per-instance vertex data for transparent spheres
+    struct TransparentSphereInstance {
+        glm::vec4 centerRadius;
+        glm::vec4 color; // rgb = albedo, a = coverage
+    };
 }
 
-void GraphicsManager::setupSphereBuffers(const std::vector<float>& vertices, const std::vector<unsigned int>& indices) {
-    sphereIndexCount = static_cast<int>(indices.size());
+bool GraphicsManager::initOIT() {
+    oitAccumulateShader = loadShaders("oit_accumulate_vertex.glsl", "oit_accumulate_fragment.glsl");
+    oitCompositeShader = loadShaders("oit_composite_vertex.glsl", "oit_composite_fragment.glsl");
+    if (oitAccumulateShader == 0 || oitCompositeShader == 0) {
+        std::cerr << "Failed to load OIT shaders" << std::endl;
+        return false;
+    }
     
-    glGenVertexArrays(1, &sphereVAO);
-    glGenBuffers(1, &sphereVBO);
+    // Accumulation (rgb = weighted premultiplied color, a = revealage) and weight sum targets
+    glGenTextures(1, &oitAccumulationTexture);
+    glState.bindTexture(GL_TEXTURE_2D, oitAccumulationTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, screenWidth, screenHeight, 0, GL_RGBA, GL_HALF_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    
+    glGenTextures(1, &oitWeightTexture);
+    glState.bindTexture(GL_TEXTURE_2D, oitWeightTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, screenWidth, screenHeight, 0, GL_RED, GL_HALF_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glState.bindTexture(GL_TEXTURE_2D, 0);
+    
+    // Receives a copy of the opaque depth so hidden transparent fragments are rejected
+    glGenRenderbuffers(1, &oitDepthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, oitDepthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, screenWidth, screenHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    
+    glGenFramebuffers(1, &oitFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, oitFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, oitAccumulationTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, oitWeightTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, oitDepthRenderbuffer);
+    const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, drawBuffers);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "OIT framebuffer incomplete: " << status << std::endl;
+        return false;
+    }
+    
+    // Sphere mesh plus per-instance center/radius and color
+    glGenVertexArrays(1, &oitVAO);
+    glState.bindVertexArray(oitVAO);
+    glState.bindBuffer(GL_ARRAY_BUFFER, sphereVBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glState.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereEBO);
+    
+    for (int i = 0; i < 2; i++) {
+        glEnableVertexAttribArray(3 + i);
+        glVertexAttribDivisor(3 + i, 1);
+    }
+    glState.bindVertexArray(0);
+    
+    // The composite triangle is generated in the vertex shader but core profile still needs a VAO
+    glGenVertexArrays(1, &oitCompositeVAO);
+    
+    std::cout << "Weighted blended OIT initialized successfully!" << std::endl;
+    return true;
+}
+
+void GraphicsManager::cleanupOIT() {
+    if (oitAccumulateShader) glDeleteProgram(oitAccumulateShader);
+    if (oitCompositeShader) glDeleteProgram(oitCompositeShader);
+    if (oitFBO) glDeleteFramebuffers(1, &oitFBO);
+    if (oitAccumulationTexture) glDeleteTextures(1, &oitAccumulationTexture);
+    if (oitWeightTexture) glDeleteTextures(1, &oitWeightTexture);
+    if (oitDepthRenderbuffer) glDeleteRenderbuffers(1, &oitDepthRenderbuffer);
+    if (oitVAO) glDeleteVertexArrays(1, &oitVAO);
+    if (oitCompositeVAO) glDeleteVertexArrays(1, &oitCompositeVAO);
+    oitAccumulateShader = oitCompositeShader = 0;
+    oitFBO = oitAccumulationTexture = oitWeightTexture = oitDepthRenderbuffer = 0;
+    oitVAO = oitCompositeVAO = 0;
+    oitSupported = false;
+    glState.invalidate();
+}
+
+void GraphicsManager::renderTransparentSpheres(const glm::mat4& view, const glm::mat4& projection, const std::vector<RTSphere>& spheres) {
+    if (spheres.empty() || !oitSupported) {
+        return;
+    }
+    
+    std::vector<TransparentSphereInstance> instances(spheres.size());
+    for (size_t i = 0; i < spheres.size(); i++) {
+        instances[i].centerRadius = glm::vec4(spheres[i].center, spheres[i].radius);
+        instances[i].color = glm::vec4(spheres[i].material.albedo, GLASS_ALPHA);
+    }
+    
+    StreamingAllocation instanceData = streamingBuffer.upload(glState, instances.data(),
+                                                              instances.size() * sizeof(TransparentSphereInstance), sizeof(float));
+    if (!instanceData.buffer) {
+        return;
+    }
+    
+    // Copy the opaque depth; if the default framebuffer's depth format can't be blitted,
+    // transparent surfaces are drawn without occlusion by opaque geometry
+    glBindFramebuffer(GL_FRAMEBUFFER, oitFBO);
+    if (oitDepthCopySupported) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, outputFramebuffer);
+        glBlitFramebuffer(0, 0, screenWidth, screenHeight, 0, 0, screenWidth, screenHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, oitFBO);
+        if (!oitDepthCopyVerified) {
+            oitDepthCopyVerified = true;
+            if (glGetError() != GL_NO_ERROR) {
+                std::cerr << "Opaque depth copy for OIT failed - transparent objects ignore opaque occlusion" << std::endl;
+                oitDepthCopySupported = false;
+            }
+        }
+    }
+    if (!oitDepthCopySupported) {
+        glState.depthMask(true);
+        glClear(GL_DEPTH_BUFFER_BIT);
+    }
+    
+    const GLfloat clearAccumulation[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    const GLfloat clearWeight[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glClearBufferfv(GL_COLOR, 0, clearAccumulation);
+    glClearBufferfv(GL_COLOR, 1, clearWeight);
+    
+    // Accumulate: depth-tested against opaque geometry but never written, so draw order doesn't matter.
+    // rgb adds up, alpha multiplies (1 - alpha) into the revealage.
+    glState.enable(GL_DEPTH_TEST);
+    glState.depthMask(false);
+    glState.enable(GL_BLEND);
+    glState.blendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+    
+    glm::vec3 viewPos = glm::vec3(glm::inverse(view)[3]);
+    glState.useProgram(oitAccumulateShader);
+    glUniformMatrix4fv(glGetUniformLocation(oitAccumulateShader, "view"), 1, GL_FALSE, &view[0][0]);
+    glUniformMatrix4fv(glGetUniformLocation(oitAccumulateShader, "projection"), 1, GL_FALSE, &projection[0][0]);
+    glUniform3f(glGetUniformLocation(oitAccumulateShader, "viewPos"), viewPos.x, viewPos.y, viewPos.z);
+    glUniform3f(glGetUniformLocation(oitAccumulateShader, "lightPos"), currentLightPos.x, currentLightPos.y, currentLightPos.z);
+    glUniform3f(glGetUniformLocation(oitAccumulateShader, "lightColor"), currentLightColor.x, currentLightColor.y, currentLightColor.z);
+    
+    glState.bindVertexArray(oitVAO);
+    bindInstanceAttributes(instanceData, 3, 2, sizeof(TransparentSphereInstance));
+    glDrawElementsInstanced(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(instances.size()));
+    
+    // Composite the weighted average over the opaque image
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+    glState.disable(GL_DEPTH_TEST);
+    glState.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    
+    glState.useProgram(oitCompositeShader);
+    glState.activeTexture(GL_TEXTURE0);
+    glState.bindTexture(GL_TEXTURE_2D, oitAccumulationTexture);
+    glState.activeTexture(GL_TEXTURE1);
+    glState.bindTexture(GL_TEXTURE_2D, oitWeightTexture);
+    glState.activeTexture(GL_TEXTURE0);
+    glUniform1i(glGetUniformLocation(oitCompositeShader, "accumulationTexture"), 0);
+    glUniform1i(glGetUniformLocation(oitCompositeShader, "weightTexture"), 1);
+    
+    glState.bindVertexArray(oitCompositeVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    
+    glState.enable(GL_DEPTH_TEST);
+    glState.depthMask(true);
+}
+
+void GraphicsManager::runTransparencyBenchmark(int maxInstances, int frames) {
+    if (!oitSupported) {
+        std::cout << "Order-independent transparency unavailable" << std::endl;
+        return;
+    }
+    
+    // Deterministic cloud of overlapping glass spheres over the floor
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> spreadX(-6.0f, 6.0f);
+    std::uniform_real_distribution<float> spreadY(-0.4f, 4.0f);
+    std::uniform_real_distribution<float> depth(-25.0f, -2.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    
+    std::vector<RTSphere> allSpheres(maxInstances);
+    for (auto& sphere : allSpheres) {
+        sphere.center = glm::vec3(spreadX(rng), spreadY(rng), depth(rng));
+        sphere.radius = 0.2f + unit(rng) * 0.4f;
+        sphere.material.albedo = glm::vec3(0.1f + unit(rng) * 0.3f, 0.5f + unit(rng) * 0.5f, 0.3f + unit(rng) * 0.4f);
+        sphere.material.type = RT_MATERIAL_GLASS;
+    }
+    
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 1.5f, 5.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)screenWidth / (float)screenHeight, 0.1f, 100.0f);
+    glm::mat4 floorModel = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.5f, 0.0f));
+    floorModel = glm::scale(floorModel, glm::vec3(20.0f, 0.1f, 20.0f));
+    
+    // 0 (opaque floor only) as the baseline, then doubling instance counts
+    std::vector<int> counts = { 0 };
+    for (int count = 1000; count < maxInstances; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(maxInstances);
+    
+    std::cout << "=== Transparency benchmark: up to " << maxInstances << " glass spheres, " << frames << " frames ===" << std::endl;
+    
+    double baselineMs = 0.0;
+    double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    std::vector<RTSphere> spheres;
+    for (int count : counts) {
+        spheres.assign(allSpheres.begin(), allSpheres.begin() + count);
+        
+        glFinish();
+        auto start = std::chrono::high_resolution_clock::now();
+        
+        for (int frame = 0; frame < frames; frame++) {
+            beginFrame();
+            glState.disable(GL_BLEND);
+            setGlobalRenderState(view, projection);
+            renderFloor(floorModel, view, projection);
+            renderTransparentSpheres(view, projection, spheres);
+        }
+        
+        glFinish();
+        double frameMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / frames;
+        
+        std::cout << std::setw(8) << count << " spheres: " << std::fixed << std::setprecision(3) << frameMs << " ms/frame";
+        if (count == 0) {
+            baselineMs = frameMs;
+        } else {
+            std::cout << ", " << (frameMs - baselineMs) / (count / 1000.0) << " ms per 1k transparent instances";
+        }
+        std::cout << std::endl;
+        
+        double thousands = count / 1000.0;
+        sumX += thousands;
+        sumY += frameMs;
+        sumXX += thousands * thousands;
+        sumXY += thousands * frameMs;
+    }
+    
+    // Least-squares slope over all runs: the marginal cost of another 1k instances
+    double n = static_cast<double>(counts.size());
+    double denominator = n * sumXX - sumX * sumX;
+    if (denominator > 0.0) {
+        std::cout << "Fitted cost: " << std::fixed << std::setprecision(3)
+                  << (n * sumXY - sumX * sumY) / denominator << " ms per 1k transparent instances" << std::endl;
+    }
+}
+
+bool GraphicsManager::hasExtension(const char* name) const {
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount; i++) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (extension && std::string(extension) == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+namespace {
+    // Per-object data read by the culling shader and as instance attributes
+    struct CullObject {
+        glm::vec4 centerRadius;
+        glm::vec4 color;
+    };
+    
+    // Matches DrawElementsIndirectCommand
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+}
+
+bool GraphicsManager::initGpuCulling() {
+    pglMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)procAddressLoader("glMultiDrawElementsIndirect");
+    pglClearBufferData = (PFNGLCLEARBUFFERDATAPROC)procAddressLoader("glClearBufferData");
+    if (!pglMultiDrawElementsIndirect || !pglClearBufferData) {
+        std::cerr << "Failed to load glMultiDrawElementsIndirect/glClearBufferData" << std::endl;
+        return false;
+    }
+    
+    // The count variant lets the GPU-written visible count drive the draw (GL 4.6 or ARB_indirect_parameters)
+    int major, minor;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major > 4 || (major == 4 && minor >= 6)) {
+        pglMultiDrawElementsIndirectCount = (PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC)procAddressLoader("glMultiDrawElementsIndirectCount");
+    } else if (hasExtension("GL_ARB_indirect_parameters")) {
+        pglMultiDrawElementsIndirectCount = (PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC)procAddressLoader("glMultiDrawElementsIndirectCountARB");
+    }
+    
+    gpuCullingComputeShader = loadComputeShader("gpu_culling.comp");
+    if (gpuCullingComputeShader == 0) {
+        std::cerr << "Failed to load GPU culling compute shader" << std::endl;
+        return false;
+    }
+    
+    gpuDrivenShader = loadShaders("gpu_driven_vertex.glsl", "gpu_driven_fragment.glsl");
+    if (gpuDrivenShader == 0) {
+        std::cerr << "Failed to load GPU-driven shaders" << std::endl;
+        return false;
+    }
+    
+    glGenBuffers(1, &drawCommandBuffer);
+    glGenBuffers(1, &drawCountBuffer);
+    
+    // Visible count (indirect draw parameter) followed by the frustum-culled and occluded counters
+    glState.bindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, drawCountBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER_LOCAL, 3 * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+    
+    // Statistics are copied into a small ring and read once their fence has passed
+    glGenBuffers(STATS_READBACK_FRAMES, statsReadbackBuffers);
+    for (GLuint buffer : statsReadbackBuffers) {
+        glState.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, 3 * sizeof(GLuint), nullptr, GL_STREAM_READ);
+    }
+    
+    // Sphere mesh per vertex, object data per instance (selected by each command's baseInstance)
+    glGenVertexArrays(1, &gpuDrivenVAO);
+    glState.bindVertexArray(gpuDrivenVAO);
+    glState.bindBuffer(GL_ARRAY_BUFFER, sphereVBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glState.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereEBO);
+    
+    // Object attributes point at this frame's streamed object data when drawing
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
+    glState.bindVertexArray(0);
+    
+    std::cout << "GPU-driven culling initialized (" 
+              << (pglMultiDrawElementsIndirectCount ? "indirect count" : "fixed-count multi-draw") << ")" << std::endl;
+    return true;
+}
+
+void GraphicsManager::cleanupGpuCulling() {
+    if (gpuDrivenVAO) glDeleteVertexArrays(1, &gpuDrivenVAO);
+    if (drawCommandBuffer) glDeleteBuffers(1, &drawCommandBuffer);
+    if (drawCountBuffer) glDeleteBuffers(1, &drawCountBuffer);
+    if (gpuCullingComputeShader) glDeleteProgram(gpuCullingComputeShader);
+    if (gpuDrivenShader) glDeleteProgram(gpuDrivenShader);
+    gpuDrivenVAO = drawCommandBuffer = drawCountBuffer = 0;
+    gpuCullingComputeShader = gpuDrivenShader = 0;
+    
+    for (int i = 0; i < STATS_READBACK_FRAMES; i++) {
+        if (statsFences[i]) glDeleteSync(statsFences[i]);
+        if (statsReadbackBuffers[i]) glDeleteBuffers(1, &statsReadbackBuffers[i]);
+        statsFences[i] = nullptr;
+        statsReadbackBuffers[i] = 0;
+    }
+    glState.invalidate();
+}
+
+namespace {
+    // Largest power of two that is not greater than value
+    int previousPowerOfTwo(unsigned int value) {
+        int result = 1;
+        while (static_cast<unsigned int>(result * 2) <= value) {
+            result *= 2;
+        }
+        return result;
+    }
+}
+
+bool GraphicsManager::initHiZ() {
+    hiZDownsampleShader = loadComputeShader("hiz_downsample.comp");
+    if (hiZDownsampleShader == 0) {
+        std::cerr << "Failed to load Hi-Z downsample compute shader" << std::endl;
+        return false;
+    }
+    
+    // Occluders are drawn with the depth-only prepass shader
+    if (depthPrepassShader == 0) {
+        depthPrepassShader = loadShaders("depth_prepass_vertex.glsl", "depth_prepass_fragment.glsl");
+        if (depthPrepassShader == 0) {
+            std::cerr << "Failed to load depth prepass shaders" << std::endl;
+            return false;
+        }
+    }
+    
+    // Occluder depth target at screen resolution
+    glGenTextures(1, &occlusionDepthTexture);
+    glState.bindTexture(GL_TEXTURE_2D, occlusionDepthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, screenWidth, screenHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    
+    glGenFramebuffers(1, &occlusionDepthFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, occlusionDepthFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, occlusionDepthTexture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Occlusion depth framebuffer incomplete: " << status << std::endl;
+        return false;
+    }
+    
+    // Pyramid level 0 is the largest power of two within the screen so every further level halves exactly
+    hiZWidth = previousPowerOfTwo(screenWidth);
+    hiZHeight = previousPowerOfTwo(screenHeight);
+    hiZLevels = 1;
+    while ((std::max(hiZWidth, hiZHeight) >> hiZLevels) > 0) {
+        hiZLevels++;
+    }
+    
+    glGenTextures(1, &hiZTexture);
+    glState.bindTexture(GL_TEXTURE_2D, hiZTexture);
+    for (int level = 0; level < hiZLevels; level++) {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_R32F, std::max(1, hiZWidth >> level), std::max(1, hiZHeight >> level),
+                     0, GL_RED, GL_FLOAT, nullptr);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, hiZLevels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glState.bindTexture(GL_TEXTURE_2D, 0);
+    
+    std::cout << "Hi-Z occlusion culling initialized (" << hiZWidth << "x" << hiZHeight
+              << " pyramid, " << hiZLevels << " levels)" << std::endl;
+    return true;
+}
+
+void GraphicsManager::cleanupHiZ() {
+    if (hiZDownsampleShader) glDeleteProgram(hiZDownsampleShader);
+    if (occlusionDepthFBO) glDeleteFramebuffers(1, &occlusionDepthFBO);
+    if (occlusionDepthTexture) glDeleteTextures(1, &occlusionDepthTexture);
+    if (hiZTexture) glDeleteTextures(1, &hiZTexture);
+    hiZDownsampleShader = occlusionDepthFBO = occlusionDepthTexture = hiZTexture = 0;
+    hiZSupported = hiZOcclusionEnabled = hiZReady = false;
+    
+    // Deleting a bound object resets its binding behind the cache's back
+    glState.invalidate();
+}
+
+void GraphicsManager::buildHiZPyramid() {
+    glState.useProgram(hiZDownsampleShader);
+    glState.activeTexture(GL_TEXTURE0);
+    glState.bindTexture(GL_TEXTURE_2D, occlusionDepthTexture);
+    glUniform1i(glGetUniformLocation(hiZDownsampleShader, "sourceDepth"), 0);
+    
+    int sourceWidth = static_cast<int>(screenWidth);
+    int sourceHeight = static_cast<int>(screenHeight);
+    int width = hiZWidth;
+    int height = hiZHeight;
+    
+    // Max-reduce level by level; each pass reads the previous level as an image
+    for (int level = 0; level < hiZLevels; level++) {
+        glUniform1i(glGetUniformLocation(hiZDownsampleShader, "fromDepthTexture"), level == 0 ? 1 : 0);
+        if (level > 0) {
+            pglBindImageTexture(1, hiZTexture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+        }
+        pglBindImageTexture(2, hiZTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        glUniform2i(glGetUniformLocation(hiZDownsampleShader, "sourceSize"), sourceWidth, sourceHeight);
+        glUniform2i(glGetUniformLocation(hiZDownsampleShader, "destinationSize"), width, height);
+        
+        pglDispatchCompute(static_cast<GLuint>((width + 7) / 8), static_cast<GLuint>((height + 7) / 8), 1);
+        pglMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT_LOCAL);
+        
+        sourceWidth = width;
+        sourceHeight = height;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    
+    pglMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT_LOCAL);
+}
+
+void GraphicsManager::queueCullingStatsReadback(uint32_t objectCount) {
+    int slot = statsFrameIndex % STATS_READBACK_FRAMES;
+    
+    // A slot still pending after a full ring is dropped instead of waited on
+    if (statsFences[slot]) {
+        glDeleteSync(statsFences[slot]);
+    }
+    
+    glState.bindBuffer(GL_COPY_READ_BUFFER, drawCountBuffer);
+    glState.bindBuffer(GL_COPY_WRITE_BUFFER, statsReadbackBuffers[slot]);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, 3 * sizeof(GLuint));
+    statsFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    statsObjectCounts[slot] = objectCount;
+    statsFrameIndex++;
+}
+
+void GraphicsManager::collectCullingStats() {
+    // Oldest to newest so the most recent finished frame ends up in occlusionStats; never blocks
+    for (int i = 0; i < STATS_READBACK_FRAMES; i++) {
+        int slot = (statsFrameIndex + i) % STATS_READBACK_FRAMES;
+        if (!statsFences[slot]) {
+            continue;
+        }
+        
+        GLenum result = glClientWaitSync(statsFences[slot], 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+            continue;
+        }
+        
+        GLuint counters[3] = {0, 0, 0};
+        glState.bindBuffer(GL_COPY_READ_BUFFER, statsReadbackBuffers[slot]);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(counters), counters);
+        glDeleteSync(statsFences[slot]);
+        statsFences[slot] = nullptr;
+        
+        occlusionStats.objectCount = statsObjectCounts[slot];
+        occlusionStats.visibleCount = counters[0];
+        occlusionStats.frustumCulledCount = counters[1];
+        occlusionStats.occludedCount = counters[2];
+    }
+}
+
+void GraphicsManager::dispatchGpuCulling(const glm::mat4& view, const glm::mat4& projection, const std::vector<RTSphere>& spheres) {
+    GpuProfileScope cullingScope(gpuProfiler, "GPU culling");
+    
+    std::vector<CullObject> objects(spheres.size());
+    for (size_t i = 0; i < spheres.size(); i++) {
+        objects[i].centerRadius = glm::vec4(spheres[i].center, spheres[i].radius);
+        objects[i].color = glm::vec4(spheres[i].material.albedo, 1.0f);
+    }
+    
+    // Objects stream in every frame; the command buffer only grows
+    if (objects.size() > cullObjectCapacity) {
+        cullObjectCapacity = objects.size();
+        glState.bindBuffer(GL_DRAW_INDIRECT_BUFFER_LOCAL, drawCommandBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER_LOCAL, cullObjectCapacity * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_DRAW);
+    }
+    cullObjectData = streamingBuffer.upload(glState, objects.data(), objects.size() * sizeof(CullObject), storageBufferAlignment);
+    
+    // Reset the visible counter; without the count variant, unused commands must be zero-instance draws
+    glState.bindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, drawCountBuffer);
+    pglClearBufferData(GL_SHADER_STORAGE_BUFFER_LOCAL, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    if (!pglMultiDrawElementsIndirectCount) {
+        glState.bindBuffer(GL_DRAW_INDIRECT_BUFFER_LOCAL, drawCommandBuffer);
+        pglClearBufferData(GL_DRAW_INDIRECT_BUFFER_LOCAL, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    }
+    
+    Frustum frustum = FrustumCuller::extractFrustum(projection * view);
+    
+    glState.useProgram(gpuCullingComputeShader);
+    glUniform4fv(glGetUniformLocation(gpuCullingComputeShader, "frustumPlanes"), 6, &frustum.planes[0][0]);
+    glUniform1ui(glGetUniformLocation(gpuCullingComputeShader, "objectCount"), static_cast<GLuint>(objects.size()));
+    glUniform1ui(glGetUniformLocation(gpuCullingComputeShader, "indexCount"), static_cast<GLuint>(sphereIndexCount));
+    
+    // The pyramid is only valid for the camera it was built with in this frame's prepass
+    bool useOcclusion = hiZOcclusionEnabled && hiZReady;
+    hiZReady = false;
+    glUniform1i(glGetUniformLocation(gpuCullingComputeShader, "occlusionEnabled"), useOcclusion ? 1 : 0);
+    if (useOcclusion) {
+        glState.activeTexture(GL_TEXTURE0);
+        glState.bindTexture(GL_TEXTURE_2D, hiZTexture);
+        glUniform1i(glGetUniformLocation(gpuCullingComputeShader, "hiZPyramid"), 0);
+        glUniform1i(glGetUniformLocation(gpuCullingComputeShader, "hiZLevels"), hiZLevels);
+        glUniformMatrix4fv(glGetUniformLocation(gpuCullingComputeShader, "view"), 1, GL_FALSE, &view[0][0]);
+        glUniform4f(glGetUniformLocation(gpuCullingComputeShader, "projectionParams"),
+                    projection[0][0], projection[1][1], projection[2][2], projection[3][2]);
+        glUniform1f(glGetUniformLocation(gpuCullingComputeShader, "zNear"), projection[3][2] / (projection[2][2] - 1.0f));
+    }
+    
+    glState.bindBufferRange(GL_SHADER_STORAGE_BUFFER_LOCAL, 3, cullObjectData.buffer, cullObjectData.offset, cullObjectData.size);
+    glState.bindBufferBase(GL_SHADER_STORAGE_BUFFER_LOCAL, 4, drawCommandBuffer);
+    glState.bindBufferBase(GL_SHADER_STORAGE_BUFFER_LOCAL, 5, drawCountBuffer);
+    
+    pglDispatchCompute(static_cast<GLuint>((objects.size() + 63) / 64), 1, 1);
+    pglMemoryBarrier(GL_COMMAND_BARRIER_BIT_LOCAL | GL_SHADER_STORAGE_BARRIER_BIT_LOCAL |
+                     GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT_LOCAL | GL_BUFFER_UPDATE_BARRIER_BIT_LOCAL);
+}
+
+void GraphicsManager::renderGpuCulledSpheres(const glm::mat4& view, const glm::mat4& projection, const std::vector<RTSphere>& spheres) {
+    if (spheres.empty() || !gpuCullingSupported) {
+        return;
+    }
+    
+    dispatchGpuCulling(view, projection, spheres);
+    queueCullingStatsReadback(static_cast<uint32_t>(spheres.size()));
+    collectCullingStats();
+    
+    glm::vec3 viewPos = glm::vec3(glm::inverse(view)[3]);
+    glState.useProgram(gpuDrivenShader);
+    glUniformMatrix4fv(glGetUniformLocation(gpuDrivenShader, "view"), 1, GL_FALSE, &view[0][0]);
+    glUniformMatrix4fv(glGetUniformLocation(gpuDrivenShader, "projection"), 1, GL_FALSE, &projection[0][0]);
+    glUniform3f(glGetUniformLocation(gpuDrivenShader, "viewPos"), viewPos.x, viewPos.y, viewPos.z);
+    glUniform3f(glGetUniformLocation(gpuDrivenShader, "lightPos"), currentLightPos.x, currentLightPos.y, currentLightPos.z);
+    glUniform3f(glGetUniformLocation(gpuDrivenShader, "lightColor"), currentLightColor.x, currentLightColor.y, currentLightColor.z);
+    
+    // A single submission regardless of how many objects are in the scene
+    glState.bindVertexArray(gpuDrivenVAO);
+    bindInstanceAttributes(cullObjectData, 3, 2, sizeof(CullObject));
+    glState.bindBuffer(GL_DRAW_INDIRECT_BUFFER_LOCAL, drawCommandBuffer);
+    if (pglMultiDrawElementsIndirectCount) {
+        glState.bindBuffer(GL_PARAMETER_BUFFER_LOCAL, drawCountBuffer);
+        pglMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 0, static_cast<GLsizei>(spheres.size()), 0);
+    } else {
+        pglMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(spheres.size()), 0);
+    }
+}
+
+bool GraphicsManager::runCullingValidation(int sphereCount) {
+    if (!gpuCullingSupported) {
+        std::cerr << "GPU-driven culling not supported, cannot validate" << std::endl;
+        return false;
+    }
+    
+    // Spheres scattered all around the camera so every frustum plane rejects some
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> radius(0.05f, 2.0f);
+    
+    std::vector<RTSphere> spheres(sphereCount);
+    for (auto& sphere : spheres) {
+        sphere.center = glm::vec3(position(rng), position(rng), position(rng));
+        sphere.radius = radius(rng);
+        sphere.material.albedo = glm::vec3(1.0f);
+    }
+    
+    const glm::vec3 eye(0.0f, 1.8f, 3.0f);
+    const glm::vec3 directions[] = {
+        glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(1.0f, 0.0f, 0.0f),
+        glm::vec3(0.0f, -0.7f, 0.7f), glm::vec3(-0.5f, 0.5f, -0.7f)
+    };
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)screenWidth / (float)screenHeight, 0.1f, 100.0f);
+    
+    bool allPassed = true;
+    for (const auto& direction : directions) {
+        glm::mat4 view = glm::lookAt(eye, eye + glm::normalize(direction), glm::vec3(0.0f, 1.0f, 0.0f));
+        dispatchGpuCulling(view, projection, spheres);
+        
+        // Read back the GPU results (stalls, validation only)
+        GLuint gpuCount = 0;
+        glState.bindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, drawCountBuffer);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER_LOCAL, 0, sizeof(GLuint), &gpuCount);
+        
+        std::vector<DrawElementsIndirectCommand> commands(std::min<size_t>(gpuCount, spheres.size()));
+        glState.bindBuffer(GL_DRAW_INDIRECT_BUFFER_LOCAL, drawCommandBuffer);
+        glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER_LOCAL, 0, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+        
+        std::set<GLuint> gpuVisible;
+        for (const auto& command : commands) {
+            gpuVisible.insert(command.baseInstance);
+        }
+        
+        // CPU reference
+        Frustum frustum = FrustumCuller::extractFrustum(projection * view);
+        std::set<GLuint> cpuVisible;
+        for (size_t i = 0; i < spheres.size(); i++) {
+            if (FrustumCuller::isSphereVisible(frustum, spheres[i].center, spheres[i].radius)) {
+                cpuVisible.insert(static_cast<GLuint>(i));
+            }
+        }
+        
+        bool passed = (gpuCount == cpuVisible.size()) && (gpuVisible == cpuVisible);
+        allPassed = allPassed && passed;
+        std::cout << "Culling validation: GPU " << gpuCount << " visible, CPU " << cpuVisible.size()
+                  << " visible of " << spheres.size() << (passed ? " - OK" : " - MISMATCH") << std::endl;
+    }
+    
+    // Occlusion: looking straight down at the floor, spheres under it must be rejected
+    // and no sphere above it may be (the test has to stay conservative)
+    if (hiZSupported) {
+        std::uniform_real_distribution<float> spread(-3.0f, 3.0f);
+        std::uniform_real_distribution<float> belowFloor(-20.0f, -2.0f);
+        std::uniform_real_distribution<float> aboveFloor(0.0f, 4.0f);
+        for (size_t i = 0; i < spheres.size(); i++) {
+            float y = (i % 2 == 0) ? belowFloor(rng) : aboveFloor(rng);
+            spheres[i].center = glm::vec3(spread(rng), y, spread(rng));
+            spheres[i].radius = 0.25f;
+        }
+        
+        bool wasEnabled = hiZOcclusionEnabled;
+        hiZOcclusionEnabled = true;
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 8.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+        performDepthPrepass(view, projection, spheres, std::vector<Cube>(), std::vector<Bullet>(), glm::vec3(0.0f, -100.0f, 0.0f));
+        dispatchGpuCulling(view, projection, spheres);
+        hiZOcclusionEnabled = wasEnabled;
+        
+        GLuint counters[3] = {0, 0, 0};
+        glState.bindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, drawCountBuffer);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER_LOCAL, 0, sizeof(counters), counters);
+        
+        std::vector<DrawElementsIndirectCommand> commands(std::min<size_t>(counters[0], spheres.size()));
+        glState.bindBuffer(GL_DRAW_INDIRECT_BUFFER_LOCAL, drawCommandBuffer);
+        glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER_LOCAL, 0, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+        std::set<GLuint> gpuVisible;
+        for (const auto& command : commands) {
+            gpuVisible.insert(command.baseInstance);
+        }
+        
+        Frustum frustum = FrustumCuller::extractFrustum(projection * view);
+        size_t wronglyCulled = 0;
+        size_t hiddenCount = 0;
+        for (size_t i = 0; i < spheres.size(); i++) {
+            const RTSphere& sphere = spheres[i];
+            if (!FrustumCuller::isSphereVisible(frustum, sphere.center, sphere.radius)) {
+                continue;
+            }
+            if (sphere.center.y + sphere.radius < -0.5f) {
+                hiddenCount++;
+            } else if (gpuVisible.count(static_cast<GLuint>(i)) == 0) {
+                wronglyCulled++;
+            }
+        }
+        
+        bool passed = (wronglyCulled == 0) && (counters[2] > 0);
+        allPassed = allPassed && passed;
+        std::cout << "Occlusion validation: " << counters[2] << " of " << hiddenCount << " spheres under the floor occluded, "
+                  << wronglyCulled << " visible spheres culled" << (passed ? " - OK" : " - MISMATCH") << std::endl;
+    }
+    
+    return allPassed;
+}
+
+bool GraphicsManager::initRaytracing() {
+    // Create raytracing texture
+    glGenTextures(1, &raytracingTexture);
+    glState.bindTexture(GL_TEXTURE_2D, raytracingTexture);
+    
+    // Use GL_RGBA32F if available, otherwise fall back to GL_RGBA
+    GLenum internalFormat = GL_RGBA32F;
+    GLenum error = glGetError(); // Clear any existing errors
+    
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, screenWidth, screenHeight, 0, GL_RGBA, GL_FLOAT, NULL);
+    
+    error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "Error creating raytracing texture: " << error << std::endl;
+        // Try with a simpler format
+        internalFormat = GL_RGBA;
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, screenWidth, screenHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        error = glGetError();
+        if (error != GL_NO_ERROR) {
+            std::cerr << "Failed to create raytracing texture with fallback format: " << error << std::endl;
+            return false;
+        }
+    }
+    
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    
+    // Bind as image texture for compute shader
+    if (pglBindImageTexture) {
+        pglBindImageTexture(0, raytracingTexture, 0, GL_FALSE, 0, GL_READ_WRITE, internalFormat);
+        error = glGetError();
+        if (error != GL_NO_ERROR) {
+            std::cerr << "Error binding image texture: " << error << std::endl;
+            return false;
+        }
+    } else {
+        std::cerr << "glBindImageTexture function not available" << std::endl;
+        return false;
+    }
+    
+    std::cout << "Raytracing texture created successfully with format: " << internalFormat << std::endl;
+    return true;
+}
+
+bool GraphicsManager::initDenoiser() {
+    // The filter reads the trace as 32-bit float radiance, which the GL_RGBA fallback is not
+    GLint format = 0;
+    glState.bindTexture(GL_TEXTURE_2D, raytracingTexture);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+    glState.bindTexture(GL_TEXTURE_2D, 0);
+    if (format != GL_RGBA32F) {
+        std::cerr << "Denoiser needs an RGBA32F raytracing texture" << std::endl;
+        return false;
+    }
+    
+    denoiseShader = loadComputeShader("denoise_atrous.comp");
+    if (!denoiseShader) {
+        return false;
+    }
+    if (!createDenoiseTargets(screenWidth, screenHeight, denoiseTargets)) {
+        cleanupDenoiser();
+        return false;
+    }
+    std::cout << "A-trous denoiser: " << denoiseIterations << " iterations" << std::endl;
+    return true;
+}
+
+void GraphicsManager::cleanupDenoiser() {
+    destroyDenoiseTargets(denoiseTargets);
+    if (denoiseShader) {
+        glDeleteProgram(denoiseShader);
+        denoiseShader = 0;
+    }
+}
+
+bool GraphicsManager::createDenoiseTargets(int width, int height, DenoiseTargets& targets) {
+    auto createTarget = [&](GLenum internalFormat) {
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        glState.bindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        return texture;
+    };
+    
+    while (glGetError() != GL_NO_ERROR);
+    targets.color[0] = createTarget(GL_RGBA32F);
+    targets.color[1] = createTarget(GL_RGBA32F);
+    targets.normalDepth = createTarget(GL_RGBA16F);
+    targets.albedo = createTarget(GL_RGBA16F);
+    glState.bindTexture(GL_TEXTURE_2D, 0);
+    
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "Error creating denoiser targets: " << error << std::endl;
+        destroyDenoiseTargets(targets);
+        return false;
+    }
+    return true;
+}
+
+void GraphicsManager::destroyDenoiseTargets(DenoiseTargets& targets) {
+    GLuint textures[] = { targets.color[0], targets.color[1], targets.normalDepth, targets.albedo };
+    for (GLuint texture : textures) {
+        if (texture) {
+            glDeleteTextures(1, &texture);
+        }
+    }
+    targets = DenoiseTargets();
+}
+
+void GraphicsManager::bindDenoiseTargets(const DenoiseTargets& targets) {
+    pglBindImageTexture(0, targets.color[0], 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    pglBindImageTexture(1, targets.normalDepth, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    pglBindImageTexture(2, targets.albedo, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+}
+
+void GraphicsManager::runDenoiser(const DenoiseTargets& targets, int iterations, GLuint output, bool outputLinear) {
+    static const char* const ITERATION_SCOPES[MAX_DENOISE_ITERATIONS] = {
+        "A-trous 1", "A-trous 2", "A-trous 4", "A-trous 8", "A-trous 16"
+    };
+    GpuProfileScope denoiseScope(gpuProfiler, "Denoise");
+    
+    // The trace output is read with imageLoad
+    pglMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT_LOCAL);
+    
+    glState.useProgram(denoiseShader);
+    glUniform1i(glGetUniformLocation(denoiseShader, "outputLinear"), outputLinear ? 1 : 0);
+    pglBindImageTexture(1, targets.normalDepth, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
+    pglBindImageTexture(2, targets.albedo, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
+    
+    GLint width = 0;
+    GLint height = 0;
+    glState.bindTexture(GL_TEXTURE_2D, targets.color[0]);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    glState.bindTexture(GL_TEXTURE_2D, 0);
+    
+    // Each iteration doubles the kernel's spacing, so 5 iterations cover a 61 pixel footprint
+    for (int i = 0; i < iterations; i++) {
+        GpuProfileScope iterationScope(gpuProfiler, ITERATION_SCOPES[i]);
+        bool last = (i == iterations - 1);
+        pglBindImageTexture(0, targets.color[i % 2], 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA32F);
+        pglBindImageTexture(3, last ? output : targets.color[(i + 1) % 2], 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+        glUniform1i(glGetUniformLocation(denoiseShader, "stepSize"), 1 << i);
+        glUniform1i(glGetUniformLocation(denoiseShader, "firstIteration"), i == 0 ? 1 : 0);
+        glUniform1i(glGetUniformLocation(denoiseShader, "lastIteration"), last ? 1 : 0);
+        pglDispatchCompute((width + 15) / 16, (height + 15) / 16, 1);
+        pglMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT_LOCAL | GL_TEXTURE_FETCH_BARRIER_BIT_LOCAL);
+    }
+}
+
+bool GraphicsManager::initAdaptiveSampling() {
+    if (!pglDispatchComputeIndirect) {
+        std::cerr << "glDispatchComputeIndirect not available" << std::endl;
+        return false;
+    }
+    GLsizeiptr tileCount = static_cast<GLsizeiptr>((screenWidth + 15) / 16) * ((screenHeight + 15) / 16);
+    glGenBuffers(1, &adaptiveTileBuffer);
+    glState.bindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, adaptiveTileBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER_LOCAL, (3 + 2 * tileCount) * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+    return true;
+}
+
+int GraphicsManager::adaptiveBaseSamples(int numSamples) {
+    return std::max(2, numSamples / 4);
+}
+
+void GraphicsManager::dispatchRaytrace(int width, int height, int numSamples, float errorThreshold) {
+    int baseSamples = adaptiveBaseSamples(numSamples);
+    if (errorThreshold <= 0.0f || !adaptiveTileBuffer || numSamples <= baseSamples) {
+        glUniform1i(glGetUniformLocation(computeShader, "adaptivePass"), 0);
+        glUniform1i(glGetUniformLocation(computeShader, "numSamples"), numSamples);
+        dispatchTiles(width, height);
+        return;
+    }
+    
+    // Empty tile list: zero work groups in x, 1 in y and z
+    const GLuint emptyList[3] = { 0, 1, 1 };
+    glState.bindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, adaptiveTileBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER_LOCAL, 0, sizeof(emptyList), emptyList);
+    glState.bindBufferBase(GL_SHADER_STORAGE_BUFFER_LOCAL, ADAPTIVE_TILE_BINDING, adaptiveTileBuffer);
+    
+    glUniform1i(glGetUniformLocation(computeShader, "adaptivePass"), 1);
+    glUniform1i(glGetUniformLocation(computeShader, "numSamples"), baseSamples);
+    glUniform1i(glGetUniformLocation(computeShader, "refineSamples"), numSamples - baseSamples);
+    glUniform1f(glGetUniformLocation(computeShader, "errorThreshold"), errorThreshold);
+    dispatchTiles(width, height);
+    pglMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT_LOCAL | GL_COMMAND_BARRIER_BIT_LOCAL | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT_LOCAL);
+    
+    GpuProfileScope refineScope(gpuProfiler, "Adaptive refine");
+    glUniform1i(glGetUniformLocation(computeShader, "adaptivePass"), 2);
+    glState.bindBuffer(GL_DISPATCH_INDIRECT_BUFFER_LOCAL, adaptiveTileBuffer);
+    pglDispatchComputeIndirect(0);
+    glUniform1i(glGetUniformLocation(computeShader, "adaptivePass"), 0);
+}
+
+void GraphicsManager::dispatchTiles(int width, int height) {
+    GLuint groupsX = (width + 15) / 16;
+    GLuint groupsY = (height + 15) / 16;
+    if (persistentWorkGroups <= 0) {
+        glUniform1i(glGetUniformLocation(computeShader, "tilesPerGroup"), 0);
+        pglDispatchCompute(groupsX, groupsY, 1);
+        return;
+    }
+    
+    prepareTileQueue(width, height);
+    glUniform1i(glGetUniformLocation(computeShader, "tilesPerGroup"), PERSISTENT_TILES_PER_GROUP);
+    // Each dispatch drains up to groups * PERSISTENT_TILES_PER_GROUP tiles off the queue
+    GLuint tiles = groupsX * groupsY;
+    GLuint groups = std::min(static_cast<GLuint>(persistentWorkGroups), tiles);
+    for (GLuint queued = tiles; ; ) {
+        GLuint dispatched = std::min(groups, (queued + PERSISTENT_TILES_PER_GROUP - 1) / PERSISTENT_TILES_PER_GROUP);
+        pglDispatchCompute(dispatched, 1, 1);
+        if (queued <= dispatched * PERSISTENT_TILES_PER_GROUP) {
+            break;
+        }
+        queued -= dispatched * PERSISTENT_TILES_PER_GROUP;
+        pglMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT_LOCAL);
+    }
+}
+
+void GraphicsManager::prepareTileQueue(int width, int height) {
+    if (!tileQueueBuffer) {
+        glGenBuffers(1, &tileQueueBuffer);
+    }
+    glState.bindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, tileQueueBuffer);
+    if (width != tileQueueWidth || height != tileQueueHeight) {
+        // Queue head, then the tiles sorted by the Morton code of their coordinates
+        int tilesX = (width + 15) / 16;
+        int tilesY = (height + 15) / 16;
+        std::vector<std::pair<uint32_t, GLuint>> order;
+        order.reserve(static_cast<size_t>(tilesX) * tilesY);
+        for (int y = 0; y < tilesY; y++) {
+            for (int x = 0; x < tilesX; x++) {
+                order.emplace_back(mortonCode(x, y), static_cast<GLuint>(x) | (static_cast<GLuint>(y) << 16));
+            }
+        }
+        std::sort(order.begin(), order.end());
+        std::vector<GLuint> contents(1, 0);
+        for (const auto& tile : order) {
+            contents.push_back(tile.second);
+        }
+        glBufferData(GL_SHADER_STORAGE_BUFFER_LOCAL, contents.size() * sizeof(GLuint), contents.data(), GL_DYNAMIC_DRAW);
+        tileQueueWidth = width;
+        tileQueueHeight = height;
+    } else {
+        const GLuint head = 0;
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER_LOCAL, 0, sizeof(head), &head);
+    }
+    glState.bindBufferBase(GL_SHADER_STORAGE_BUFFER_LOCAL, TILE_QUEUE_BINDING, tileQueueBuffer);
+}
+
+void GraphicsManager::setRaytracingPersistentGroups(int workGroups) {
+    persistentWorkGroups = std::max(workGroups, 0);
+}
+
+void GraphicsManager::setDenoiseIterations(int iterations) {
+    denoiseIterations = std::max(0, std::min(iterations, MAX_DENOISE_ITERATIONS));
+}
+
+void GraphicsManager::setAdaptiveErrorThreshold(float threshold) {
+    adaptiveErrorThreshold = std::max(threshold, 0.0f);
+}
+
+void GraphicsManager::createFullscreenQuad() {
+    float quadVertices[] = {
+        // positions   // texCoords
+        -1.0f,  1.0f,  0.0f, 1.0f,
+        -1.0f, -1.0f,  0.0f, 0.0f,
+         1.0f, -1.0f,  1.0f, 0.0f,
+
+        -1.0f,  1.0f,  0.0f, 1.0f,
+         1.0f, -1.0f,  1.0f, 0.0f,
+         1.0f,  1.0f,  1.0f, 1.0f
+    };
+
+    unsigned int quadVBO;
+    glGenVertexArrays(1, &fullscreenVAO);
+    glGenBuffers(1, &quadVBO);
+    glState.bindVertexArray(fullscreenVAO);
+    glState.bindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+}
+
+void GraphicsManager::renderRaytraced(const std::vector<RTSphere>& spheres, const glm::vec3& cameraPos, 
+                                     const glm::vec3& cameraFront, const glm::vec3& cameraUp, const glm::vec3& cameraRight,
+                                     const glm::vec3& lightPos, const glm::vec3& lightColor, float time,
+                                     int maxBounces, int numSamples, float exposure, bool enableToneMapping) {
+    // Debug output
+    static bool firstCall = true;
+    if (firstCall) {
+        std::cout << "First raytraced render call - Spheres: " << spheres.size() << std::endl;
+        std::cout << "Camera pos: " << cameraPos.x << ", " << cameraPos.y << ", " << cameraPos.z << std::endl;
+        std::cout << "Screen size: " << screenWidth << "x" << screenHeight << std::endl;
+        firstCall = false;
+    }
+    
+    // Clear any existing OpenGL errors
+    while (glGetError() != GL_NO_ERROR);
+    
+    GpuProfileScope raytracingScope(gpuProfiler, "Raytracing");
+    
+    // Use compute shader for raytracing; every frame draws fresh random numbers
+    glState.useProgram(computeShader);
+    setRaytracingUniforms(spheres, cameraPos, cameraFront, cameraUp, cameraRight, lightPos, lightColor, time,
+                          maxBounces, numSamples);
+    glUniform1i(glGetUniformLocation(computeShader, "frameIndex"), static_cast<GLint>(raytracingFrameIndex++));
+    
+    // Denoising: the trace leaves linear radiance and its features to the filter, which writes
+    // the tone-mapped result into the raytracing texture
+    bool denoise = denoiseIterations > 0 && denoiserAvailable();
+    glUniform1i(glGetUniformLocation(computeShader, "outputLinear"), denoise ? 1 : 0);
+    glUniform1i(glGetUniformLocation(computeShader, "writeFeatures"), denoise ? 1 : 0);
+    
+    // Bind the raytracing texture as an image for writing - this should be done once during initialization
+    // But we'll do it here to ensure it's properly bound
+    if (pglBindImageTexture) {
+        if (denoise) {
+            bindDenoiseTargets(denoiseTargets);
+        } else {
+            pglBindImageTexture(0, raytracingTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+        }
+    }
+    
+    // Dispatch compute shader
+    if (pglDispatchCompute && pglMemoryBarrier) {
+        GpuProfileScope dispatchScope(gpuProfiler, "Raytrace dispatch");
+        dispatchRaytrace(screenWidth, screenHeight, numSamples, adaptiveErrorThreshold);
+        
+        // Wait for compute shader to finish
+        pglMemoryBarrier(0x00000008); // GL_SHADER_IMAGE_ACCESS_BARRIER_BIT = 0x00000008
+        
+        // Debug: Check for OpenGL errors
+        GLenum error = glGetError();
+        if (error != GL_NO_ERROR) {
+            static int errorCount = 0;
+            if (errorCount < 5) { // Only show first 5 errors
+                std::cerr << "OpenGL error after compute dispatch: " << error << std::endl;
+                errorCount++;
+            }
+        }
+    } else {
+        std::cerr << "Compute shader dispatch functions not available" << std::endl;
+        return;
+    }
+    
+    if (denoise) {
+        runDenoiser(denoiseTargets, denoiseIterations, raytracingTexture, false);
+    }
+    
+    // Render fullscreen quad with the raytraced result
+    gpuProfiler.beginScope("Tone map");
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glState.useProgram(fullscreenShader);
+    
+    // Bind the raytracing texture for reading
+    glState.activeTexture(GL_TEXTURE0);
+    glState.bindTexture(GL_TEXTURE_2D, raytracingTexture);
+    glUniform1i(glGetUniformLocation(fullscreenShader, "screenTexture"), 0);
+    glUniform1f(glGetUniformLocation(fullscreenShader, "exposure"), exposure);
+    glUniform1i(glGetUniformLocation(fullscreenShader, "enableToneMapping"), enableToneMapping ? 1 : 0);
+    
+    glState.bindVertexArray(fullscreenVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    gpuProfiler.endScope();
+    
+    // Debug: Check for OpenGL errors
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        static int errorCount = 0;
+        if (errorCount < 5) { // Only show first 5 errors
+            std::cerr << "OpenGL error after fullscreen render: " << error << std::endl;
+            errorCount++;
+        }
+    }
+}
+
+bool GraphicsManager::runRaytracingNoiseBenchmark(int maxSamples) {
+    if (!raytracingSupported || !pglDispatchCompute || !pglBindImageTexture || !pglMemoryBarrier) {
+        std::cerr << "Raytracing noise benchmark needs compute shader support" << std::endl;
+        return false;
+    }
+    
+    // Fixed scene: diffuse, metal and glass spheres on the floor, the light off to the side
+    std::vector<RTSphere> spheres = {
+        makeBenchSphere(glm::vec3(0.0f, 0.0f, 0.0f), 0.5f, glm::vec3(0.8f, 0.2f, 0.2f), glm::vec3(0.3f), 32.0f, 0),
+        makeBenchSphere(glm::vec3(-1.2f, 0.0f, -0.6f), 0.5f, glm::vec3(0.9f, 0.7f, 0.3f), glm::vec3(0.9f, 0.7f, 0.3f), 128.0f, 1),
+        makeBenchSphere(glm::vec3(1.1f, -0.25f, 0.4f), 0.25f, glm::vec3(0.3f, 0.8f, 0.3f), glm::vec3(0.1f), 8.0f, 0),
+        makeBenchSphere(glm::vec3(0.45f, -0.15f, 1.2f), 0.35f, glm::vec3(0.6f, 0.95f, 0.7f), glm::vec3(1.0f), 10.0f, 2),
+    };
+    const glm::vec3 cameraPos(0.0f, 1.0f, 3.5f);
+    const glm::vec3 cameraFront = glm::normalize(glm::vec3(0.0f, -0.2f, -1.0f));
+    const glm::vec3 cameraRight = glm::normalize(glm::cross(cameraFront, glm::vec3(0.0f, 1.0f, 0.0f)));
+    const glm::vec3 cameraUp = glm::cross(cameraRight, cameraFront);
+    const glm::vec3 lightPos(1.2f, 1.0f, 2.0f);
+    const int bounces = 5;
+    
+    // A fifth of the screen in each direction keeps the aspect ratio and the reference affordable
+    const int width = std::max(static_cast<int>(screenWidth) / 5, 16);
+    const int height = std::max(static_cast<int>(screenHeight) / 5, 16);
+    const int referencePassSamples = 64;
+    const int referencePasses = std::max(4, maxSamples * 16 / referencePassSamples);
+    
+    GLuint benchTexture = 0;
+    glGenTextures(1, &benchTexture);
+    glState.bindTexture(GL_TEXTURE_2D, benchTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    pglBindImageTexture(0, benchTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    
+    glState.useProgram(computeShader);
+    setRaytracingUniforms(spheres, cameraPos, cameraFront, cameraUp, cameraRight, lightPos, glm::vec3(1.0f), 0.0f, bounces, 1);
+    glUniform1i(glGetUniformLocation(computeShader, "outputLinear"), 1);
+    
+    // Reinhard-mapped radiance of one dispatch; every dispatch gets its own random numbers. The
+    // error is measured after the mapping, as it would be seen: in linear radiance a handful of
+    // pixels on the light's reflection in the metal sphere would outweigh the whole image
+    std::vector<float> pixels(static_cast<size_t>(width) * height * 4);
+    uint32_t seed = 1;
+    double meanPathLength = 0.0;    // of the last render, in ray segments
+    auto readBack = [&](GLuint texture, std::vector<double>& radiance) {
+        glState.bindTexture(GL_TEXTURE_2D, texture);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_FLOAT, pixels.data());
+        radiance.resize(static_cast<size_t>(width) * height * 3);
+        meanPathLength = 0.0;
+        for (size_t pixel = 0; pixel < static_cast<size_t>(width) * height; pixel++) {
+            meanPathLength += pixels[pixel * 4 + 3] / (static_cast<double>(width) * height);
+            for (int channel = 0; channel < 3; channel++) {
+                double value = pixels[pixel * 4 + channel];
+                radiance[pixel * 3 + channel] = value / (value + 1.0);
+            }
+        }
+    };
+    auto render = [&](int lightSampling, int samples, std::vector<double>& radiance) {
+        glUniform1i(glGetUniformLocation(computeShader, "lightSampling"), lightSampling);
+        glUniform1i(glGetUniformLocation(computeShader, "numSamples"), samples);
+        glUniform1i(glGetUniformLocation(computeShader, "frameIndex"), static_cast<GLint>(seed++));
+        glFinish();
+        auto start = std::chrono::high_resolution_clock::now();
+        pglDispatchCompute((width + 15) / 16, (height + 15) / 16, 1);
+        pglMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT_LOCAL);
+        readBack(benchTexture, radiance);
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+    
+    std::cout << "=== Raytracing noise vs spp: " << width << "x" << height << ", reference "
+              << referencePasses * referencePassSamples << " spp NEE+MIS ===" << std::endl;
+    
+    std::vector<double> reference(static_cast<size_t>(width) * height * 3, 0.0);
+    std::vector<double> radiance;
+    auto rootMeanSquareError = [&reference](const std::vector<double>& values) {
+        double squaredError = 0.0;
+        for (size_t i = 0; i < reference.size(); i++) {
+            double difference = values[i] - reference[i];
+            squaredError += difference * difference;
+        }
+        return std::sqrt(squaredError / reference.size());
+    };
+    
+    // The same after a 3x3 box filter over the error: what remains of the noise once the eye
+    // (or a denoiser) averages neighbouring pixels, where blue noise differs from white
+    auto lowPassError = [&reference, width, height](const std::vector<double>& values) {
+        double squaredError = 0.0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                for (int channel = 0; channel < 3; channel++) {
+                    double sum = 0.0;
+                    int count = 0;
+                    for (int dy = -1; dy <= 1; dy++) {
+                        for (int dx = -1; dx <= 1; dx++) {
+                            int nx = x + dx;
+                            int ny = y + dy;
+                            if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
+                                size_t i = (static_cast<size_t>(ny) * width + nx) * 3 + channel;
+                                sum += values[i] - reference[i];
+                                count++;
+                            }
+                        }
+                    }
+                    double filtered = sum / count;
+                    squaredError += filtered * filtered;
+                }
+            }
+        }
+        return std::sqrt(squaredError / reference.size());
+    };
+    
+    // Reference: many MIS passes averaged, paths ended by Russian roulette
+    for (int pass = 0; pass < referencePasses; pass++) {
+        render(LIGHT_SAMPLING_MIS, referencePassSamples, radiance);
+        for (size_t i = 0; i < reference.size(); i++) {
+            reference[i] += radiance[i] / referencePasses;
+        }
+    }
+    
+    const char* strategyNames[] = { "BSDF only", "NEE only", "NEE+MIS" };
+    std::cout << std::setw(6) << "spp";
+    for (const char* name : strategyNames) {
+        std::cout << std::setw(12) << name << std::setw(10) << "ms";
+    }
+    std::cout << "   (RMSE of tone-mapped radiance)" << std::endl;
+    
+    bool converging = true;
+    double previousMisError = 0.0;
+    for (int samples = 1; samples <= std::max(maxSamples, 1); samples *= 2) {
+        std::cout << std::setw(6) << samples;
+        for (int strategy = LIGHT_SAMPLING_BSDF; strategy <= LIGHT_SAMPLING_MIS; strategy++) {
+            double ms = render(strategy, samples, radiance);
+            double rmse = rootMeanSquareError(radiance);
+            std::cout << std::fixed << std::setprecision(4) << std::setw(12) << rmse
+                      << std::setprecision(1) << std::setw(10) << ms;
+            if (strategy == LIGHT_SAMPLING_MIS) {
+                // Doubling the samples must not raise the error of the estimator used for rendering
+                converging = converging && (samples == 1 || rmse < previousMisError * 1.05);
+                previousMisError = rmse;
+            }
+        }
+        std::cout << std::endl;
+    }
+    
+    // Samplers: the same estimator fed by each random number source, the error averaged over a
+    // few frames so one firefly does not decide the comparison
+    const char* samplerNames[] = { "White noise", "Sobol", "Blue noise" };
+    const int samplerFrames = 4;
+    std::cout << std::setw(6) << "spp";
+    for (const char* name : samplerNames) {
+        std::cout << std::setw(20) << name;
+    }
+    std::cout << "   (RMSE / after 3x3 box, NEE+MIS, " << samplerFrames << " frames)" << std::endl;
+    bool samplersBeatWhiteNoise = true;
+    for (int samples = 1; samples <= std::max(maxSamples, 1); samples *= 2) {
+        std::cout << std::setw(6) << samples;
+        double rawError[3] = {};
+        double filteredError[3] = {};
+        for (int sampler = 0; sampler < 3; sampler++) {
+            if (static_cast<RaytracingSampler>(sampler) == RaytracingSampler::BlueNoise && !blueNoise.isInitialized()) {
+                std::cout << std::setw(20) << "n/a";
+                continue;
+            }
+            glUniform1i(glGetUniformLocation(computeShader, "samplerType"), sampler);
+            for (int frame = 0; frame < samplerFrames; frame++) {
+                render(LIGHT_SAMPLING_MIS, samples, radiance);
+                double raw = rootMeanSquareError(radiance);
+                double filtered = lowPassError(radiance);
+                rawError[sampler] += raw * raw / samplerFrames;
+                filteredError[sampler] += filtered * filtered / samplerFrames;
+            }
+            rawError[sampler] = std::sqrt(rawError[sampler]);
+            filteredError[sampler] = std::sqrt(filteredError[sampler]);
+            std::cout << std::fixed << std::setprecision(4) << std::setw(11) << rawError[sampler]
+                      << " / " << filteredError[sampler];
+        }
+        std::cout << std::endl;
+        
+        const int white = static_cast<int>(RaytracingSampler::WhiteNoise);
+        const int sobol = static_cast<int>(RaytracingSampler::Sobol);
+        const int blue = static_cast<int>(RaytracingSampler::BlueNoise);
+        // A single sample of a scrambled sequence is as random as white noise; from 2 spp on
+        // Sobol's stratification has to show in the raw error
+        if (samples > 1 && rawError[sobol] >= rawError[white]) {
+            std::cout << "  Sobol does not beat white noise at " << samples << " spp" << std::endl;
+            samplersBeatWhiteNoise = false;
+        }
+        // Blue noise spreads the error to high frequencies: lower raw, or lower once filtered
+        if (blueNoise.isInitialized() && rawError[blue] >= rawError[white] && filteredError[blue] >= filteredError[white]) {
+            std::cout << "  Blue noise does not beat white noise at " << samples << " spp" << std::endl;
+            samplersBeatWhiteNoise = false;
+        }
+    }
+    glUniform1i(glGetUniformLocation(computeShader, "samplerType"), static_cast<GLint>(raytracingSampler));
+    
+    // BSDF sampling: uniform hemisphere against the lobes' own distributions. Under NEE+MIS, as
+    // rendered: glossy highlights and indirect light come from the BSDF samples there
+    int comparisonSamples = std::max(maxSamples, 1);
+    std::cout << "BSDF sampling at " << comparisonSamples << " spp NEE+MIS:" << std::endl;
+    for (int importance = 0; importance <= 1; importance++) {
+        glUniform1i(glGetUniformLocation(computeShader, "importanceSampling"), importance);
+        double ms = render(LIGHT_SAMPLING_MIS, comparisonSamples, radiance);
+        std::cout << "  " << std::left << std::setw(20) << (importance ? "GGX VNDF + cosine" : "Uniform hemisphere") << std::right
+                  << std::fixed << std::setprecision(4) << std::setw(8) << rootMeanSquareError(radiance) << " RMSE"
+                  << std::setprecision(1) << std::setw(10) << ms << " ms" << std::endl;
+    }
+    
+    // Path termination: the fixed bounce cutoff against Russian roulette
+    std::cout << "Path termination at " << comparisonSamples << " spp NEE+MIS:" << std::endl;
+    double fixedPathLength = 0.0;
+    for (int roulette = 0; roulette <= 1; roulette++) {
+        glUniform1i(glGetUniformLocation(computeShader, "russianRoulette"), roulette);
+        double ms = render(LIGHT_SAMPLING_MIS, comparisonSamples, radiance);
+        std::cout << "  " << std::left << std::setw(20)
+                  << (roulette ? "Russian roulette" : "Fixed " + std::to_string(bounces) + " bounces") << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(8) << meanPathLength << " rays/path"
+                  << std::setprecision(4) << std::setw(10) << rootMeanSquareError(radiance) << " RMSE"
+                  << std::setprecision(1) << std::setw(10) << ms << " ms";
+        if (roulette) {
+            std::cout << " (" << std::setprecision(0) << 100.0 * (1.0 - meanPathLength / fixedPathLength) << "% fewer rays)";
+        }
+        std::cout << std::endl;
+        fixedPathLength = meanPathLength;
+    }
+    
+    // Adaptive sampling: every sample in every pixel against the base pass plus refinement of the
+    // tiles above each threshold, up to the same spp. Rays are each pixel's mean path segments
+    // times its samples. A few fireflies decide much of one frame's error, so every row averages
+    // the squared error, samples and rays of several frames
+    int baseSamples = adaptiveBaseSamples(comparisonSamples);
+    if (adaptiveTileBuffer && comparisonSamples > baseSamples) {
+        const int adaptiveFrames = 4;
+        std::cout << "Adaptive sampling at " << comparisonSamples << " spp NEE+MIS, base pass " << baseSamples
+                  << " spp, " << adaptiveFrames << " frames:" << std::endl;
+        const float thresholds[] = { 0.0f, 0.03f, 0.02f, 0.01f, 0.005f };
+        double uniformRays = 0.0;
+        for (float threshold : thresholds) {
+            double squaredError = 0.0;
+            double samples = 0.0;
+            double rays = 0.0;
+            double ms = 0.0;
+            for (int frame = 0; frame < adaptiveFrames; frame++) {
+                glUniform1i(glGetUniformLocation(computeShader, "lightSampling"), LIGHT_SAMPLING_MIS);
+                glUniform1i(glGetUniformLocation(computeShader, "frameIndex"), static_cast<GLint>(seed++));
+                glFinish();
+                auto start = std::chrono::high_resolution_clock::now();
+                dispatchRaytrace(width, height, comparisonSamples, threshold);
+                pglMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT_LOCAL);
+                readBack(benchTexture, radiance);
+                ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / adaptiveFrames;
+                double error = rootMeanSquareError(radiance);
+                squaredError += error * error / adaptiveFrames;
+                
+                // Samples per pixel: the base pass everywhere plus each queued tile's own count
+                std::vector<int> pixelSamples(static_cast<size_t>(width) * height, threshold > 0.0f ? baseSamples : comparisonSamples);
+                if (threshold > 0.0f) {
+                    GLuint queuedCount = 0;
+                    glState.bindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, adaptiveTileBuffer);
+                    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER_LOCAL, 0, sizeof(GLuint), &queuedCount);
+                    std::vector<GLuint> queuedTiles(2 * queuedCount);
+                    if (queuedCount > 0) {
+                        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER_LOCAL, 3 * sizeof(GLuint), queuedTiles.size() * sizeof(GLuint), queuedTiles.data());
+                    }
+                    for (size_t i = 0; i < queuedTiles.size(); i += 2) {
+                        int tileX = static_cast<int>(queuedTiles[i] & 0xffffu) * 16;
+                        int tileY = static_cast<int>(queuedTiles[i] >> 16) * 16;
+                        for (int y = tileY; y < std::min(tileY + 16, height); y++) {
+                            for (int x = tileX; x < std::min(tileX + 16, width); x++) {
+                                pixelSamples[static_cast<size_t>(y) * width + x] += static_cast<int>(queuedTiles[i + 1]);
+                            }
+                        }
+                    }
+                }
+                for (size_t pixel = 0; pixel < pixelSamples.size(); pixel++) {
+                    samples += pixelSamples[pixel] / (static_cast<double>(pixelSamples.size()) * adaptiveFrames);
+                    rays += pixels[pixel * 4 + 3] * pixelSamples[pixel] / (static_cast<double>(pixelSamples.size()) * adaptiveFrames);
+                }
+            }
+            
+            std::ostringstream label;
+            if (threshold > 0.0f) {
+                label << "Threshold " << std::fixed << std::setprecision(3) << threshold;
+            } else {
+                label << "Uniform";
+            }
+            std::cout << "  " << std::left << std::setw(20) << label.str() << std::right
+                      << std::fixed << std::setprecision(1) << std::setw(6) << samples << " spp"
+                      << std::setprecision(1) << std::setw(8) << rays << " rays/pixel"
+                      << std::setprecision(4) << std::setw(10) << std::sqrt(squaredError) << " RMSE"
+                      << std::setprecision(1) << std::setw(10) << ms << " ms";
+            if (threshold > 0.0f) {
+                std::cout << " (" << std::setprecision(0) << 100.0 * (1.0 - rays / uniformRays) << "% fewer rays)";
+            } else {
+                uniformRays = rays;
+            }
+            std::cout << std::endl;
+        }
+    }
+    
+    // Denoiser at 1 spp: one noisy trace filtered by 1-5 a-trous iterations, each row from the
+    // same random numbers. The time is the filter's alone
+    DenoiseTargets benchTargets;
+    if (denoiserAvailable() && createDenoiseTargets(width, height, benchTargets)) {
+        std::cout << "Denoiser at 1 spp NEE+MIS:" << std::endl;
+        const uint32_t denoiseSeed = seed++;
+        // Untimed warm-up: the first dispatch of the filter includes its compilation on some drivers
+        runDenoiser(benchTargets, 1, benchTexture, true);
+        for (int iterations = 0; iterations <= MAX_DENOISE_ITERATIONS; iterations++) {
+            // Iterations overwrite the trace in color[0], so every row traces it again
+            glState.useProgram(computeShader);
+            glUniform1i(glGetUniformLocation(computeShader, "lightSampling"), LIGHT_SAMPLING_MIS);
+            glUniform1i(glGetUniformLocation(computeShader, "numSamples"), 1);
+            glUniform1i(glGetUniformLocation(computeShader, "frameIndex"), static_cast<GLint>(denoiseSeed));
+            glUniform1i(glGetUniformLocation(computeShader, "writeFeatures"), 1);
+            bindDenoiseTargets(benchTargets);
+            pglDispatchCompute((width + 15) / 16, (height + 15) / 16, 1);
+            glFinish();
+            auto start = std::chrono::high_resolution_clock::now();
+            if (iterations > 0) {
+                runDenoiser(benchTargets, iterations, benchTexture, true);
+            }
+            pglMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT_LOCAL);
+            glFinish();
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            readBack(iterations > 0 ? benchTexture : benchTargets.color[0], radiance);
+            std::cout << "  " << std::left << std::setw(20)
+                      << (iterations == 0 ? std::string("Raw samples")
+                                          : std::to_string(iterations) + (iterations == 1 ? " iteration" : " iterations")) << std::right
+                      << std::fixed << std::setprecision(4) << std::setw(8) << rootMeanSquareError(radiance) << " RMSE"
+                      << std::setprecision(2) << std::setw(10) << ms << " ms" << std::endl;
+        }
+        destroyDenoiseTargets(benchTargets);
+        glState.useProgram(computeShader);
+        glUniform1i(glGetUniformLocation(computeShader, "writeFeatures"), 0);
+        if (denoiserAvailable()) {
+            bindDenoiseTargets(denoiseTargets);
+        }
+    }
+    
+    glUniform1i(glGetUniformLocation(computeShader, "outputLinear"), 0);
+    glUniform1i(glGetUniformLocation(computeShader, "lightSampling"), LIGHT_SAMPLING_MIS);
+    pglBindImageTexture(0, raytracingTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    glState.bindTexture(GL_TEXTURE_2D, 0);
+    glDeleteTextures(1, &benchTexture);
+    
+    std::cout << (converging ? "NEE+MIS error falls with every doubling of spp" : "NEE+MIS error did not fall with spp") << std::endl;
+    std::cout << (samplersBeatWhiteNoise ? "Sobol and blue noise beat white noise at every spp"
+                                         : "Sobol or blue noise did not beat white noise") << std::endl;
+    return converging && samplersBeatWhiteNoise;
+}
+
+bool GraphicsManager::runRaytracingDispatchBenchmark(int frames) {
+    if (!raytracingSupported || !pglDispatchCompute || !pglBindImageTexture || !pglMemoryBarrier) {
+        std::cerr << "Raytracing dispatch benchmark needs compute shader support" << std::endl;
+        return false;
+    }
+    frames = std::max(frames, 1);
+    
+    // Scenes of uneven cost per tile: glass and metal packed into one corner of an otherwise
+    // empty view, the noise benchmark's mix, and diffuse spheres spread over the whole width
+    struct DispatchScene {
+        const char* name;
+        std::vector<RTSphere> spheres;
+    };
+    std::vector<DispatchScene> scenes(3);
+    scenes[0].name = "Glass corner";
+    for (int i = 0; i < 12; i++) {
+        glm::vec3 center(-1.7f + 0.45f * (i % 4), 0.95f - 0.45f * (i / 4), -0.3f * (i % 2));
+        scenes[0].spheres.push_back(i % 3 == 2
+            ? makeBenchSphere(center, 0.2f, glm::vec3(0.9f, 0.8f, 0.6f), glm::vec3(0.9f, 0.8f, 0.6f), 256.0f, 1)
+            : makeBenchSphere(center, 0.2f, glm::vec3(0.7f, 0.9f, 1.0f), glm::vec3(1.0f), 10.0f, 2));
+    }
+    scenes[1].name = "Mixed";
+    scenes[1].spheres = {
+        makeBenchSphere(glm::vec3(0.0f, 0.0f, 0.0f), 0.5f, glm::vec3(0.8f, 0.2f, 0.2f), glm::vec3(0.3f), 32.0f, 0),
+        makeBenchSphere(glm::vec3(-1.2f, 0.0f, -0.6f), 0.5f, glm::vec3(0.9f, 0.7f, 0.3f), glm::vec3(0.9f, 0.7f, 0.3f), 128.0f, 1),
+        makeBenchSphere(glm::vec3(1.1f, -0.25f, 0.4f), 0.25f, glm::vec3(0.3f, 0.8f, 0.3f), glm::vec3(0.1f), 8.0f, 0),
+        makeBenchSphere(glm::vec3(0.45f, -0.15f, 1.2f), 0.35f, glm::vec3(0.6f, 0.95f, 0.7f), glm::vec3(1.0f), 10.0f, 2),
+    };
+    scenes[2].name = "Diffuse";
+    for (int i = 0; i < 12; i++) {
+        glm::vec3 center(-1.75f + 0.7f * (i % 6), -0.2f, -0.8f * (i / 6));
+        scenes[2].spheres.push_back(makeBenchSphere(center, 0.3f, glm::vec3(0.3f + 0.05f * i, 0.5f, 0.7f), glm::vec3(0.1f), 8.0f, 0));
+    }
+    const glm::vec3 cameraPos(0.0f, 1.0f, 3.5f);
+    const glm::vec3 cameraFront = glm::normalize(glm::vec3(0.0f, -0.2f, -1.0f));
+    const glm::vec3 cameraRight = glm::normalize(glm::cross(cameraFront, glm::vec3(0.0f, 1.0f, 0.0f)));
+    const glm::vec3 cameraUp = glm::cross(cameraRight, cameraFront);
+    const glm::vec3 lightPos(1.2f, 1.0f, 2.0f);
+    
+    const int width = static_cast<int>(screenWidth);
+    const int height = static_cast<int>(screenHeight);
+    const int tileCount = ((width + 15) / 16) * ((height + 15) / 16);
+    const int persistentGroupCounts[] = { 32, 128, 512 };
+    
+    GLuint benchTexture = 0;
+    glGenTextures(1, &benchTexture);
+    glState.bindTexture(GL_TEXTURE_2D, benchTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    pglBindImageTexture(0, benchTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    
+    std::cout << "=== Raytracing dispatch: " << width << "x" << height << ", " << tileCount << " tiles of 16x16, 1 spp, "
+              << frames << " frames (ms/frame) ===" << std::endl;
+    std::cout << std::left << std::setw(16) << "Scene" << std::right << std::setw(12) << "Grid";
+    for (int groups : persistentGroupCounts) {
+        std::cout << std::setw(16) << ("Persistent " + std::to_string(groups));
+    }
+    std::cout << std::endl;
+    
+    // The samples depend on pixel and frame only, so every dispatch must produce the same image
+    const int savedPersistentGroups = persistentWorkGroups;
+    std::vector<float> gridImage(static_cast<size_t>(width) * height * 4);
+    std::vector<float> image(gridImage.size());
+    const std::vector<float> clearImage(gridImage.size(), -1.0f);
+    bool identical = true;
+    glState.useProgram(computeShader);
+    glUniform1i(glGetUniformLocation(computeShader, "outputLinear"), 1);
+    for (const DispatchScene& scene : scenes) {
+        setRaytracingUniforms(scene.spheres, cameraPos, cameraFront, cameraUp, cameraRight, lightPos, glm::vec3(1.0f), 0.0f, 5, 1);
+        std::cout << std::left << std::setw(16) << scene.name << std::right;
+        for (int config = 0; config <= 3; config++) {
+            persistentWorkGroups = config == 0 ? 0 : persistentGroupCounts[config - 1];
+            // Untimed first frame: builds the tile queue and warms up the shader
+            glUniform1i(glGetUniformLocation(computeShader, "frameIndex"), 0);
+            dispatchRaytrace(width, height, 1, 0.0f);
+            glFinish();
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int frame = 1; frame <= frames; frame++) {
+                glUniform1i(glGetUniformLocation(computeShader, "frameIndex"), frame);
+                dispatchRaytrace(width, height, 1, 0.0f);
+            }
+            glFinish();
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / frames;
+            std::cout << std::fixed << std::setprecision(1) << std::setw(config == 0 ? 12 : 16) << ms;
+            
+            // Checked frame over a cleared image, so tiles a dispatch misses show up
+            glState.bindTexture(GL_TEXTURE_2D, benchTexture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_FLOAT, clearImage.data());
+            pglMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT_LOCAL);
+            dispatchRaytrace(width, height, 1, 0.0f);
+            pglMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT_LOCAL);
+            glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_FLOAT, config == 0 ? gridImage.data() : image.data());
+            if (config > 0 && image != gridImage) {
+                identical = false;
+            }
+        }
+        std::cout << std::endl;
+    }
+    
+    persistentWorkGroups = savedPersistentGroups;
+    glUniform1i(glGetUniformLocation(computeShader, "outputLinear"), 0);
+    pglBindImageTexture(0, raytracingTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    glState.bindTexture(GL_TEXTURE_2D, 0);
+    glDeleteTextures(1, &benchTexture);
+    
+    std::cout << (identical ? "Persistent threads reproduce the grid's images" : "Persistent threads changed the image - MISMATCH") << std::endl;
+    return identical;
+}
+
+void GraphicsManager::setRaytracingUniforms(const std::vector<RTSphere>& spheres, const glm::vec3& cameraPos,
+                                            const glm::vec3& cameraFront, const glm::vec3& cameraUp, const glm::vec3& cameraRight,
+                                            const glm::vec3& lightPos, const glm::vec3& lightColor, float time,
+                                            int maxBounces, int numSamples) {
+    // computeShader is bound
+    CPU_PROFILE_SCOPE("Uniform upload");
+    // Set camera uniforms
+    glUniform3f(glGetUniformLocation(computeShader, "cameraPos"), cameraPos.x, cameraPos.y, cameraPos.z);
+    glUniform3f(glGetUniformLocation(computeShader, "cameraFront"), cameraFront.x, cameraFront.y, cameraFront.z);
+    glUniform3f(glGetUniformLocation(computeShader, "cameraUp"), cameraUp.x, cameraUp.y, cameraUp.z);
+    glUniform3f(glGetUniformLocation(computeShader, "cameraRight"), cameraRight.x, cameraRight.y, cameraRight.z);
+    glUniform1f(glGetUniformLocation(computeShader, "fov"), glm::radians(45.0f));
+    glUniform1f(glGetUniformLocation(computeShader, "aspectRatio"), (float)screenWidth / (float)screenHeight);
+    glUniform1i(glGetUniformLocation(computeShader, "maxBounces"), maxBounces);
+    glUniform1i(glGetUniformLocation(computeShader, "numSamples"), numSamples);
+    glUniform3f(glGetUniformLocation(computeShader, "lightPos"), lightPos.x, lightPos.y, lightPos.z);
+    glUniform3f(glGetUniformLocation(computeShader, "lightColor"), lightColor.x, lightColor.y, lightColor.z);
+    glUniform1f(glGetUniformLocation(computeShader, "time"), time);
+    glUniform1i(glGetUniformLocation(computeShader, "samplerType"), static_cast<GLint>(raytracingSampler));
+    if (blueNoise.isInitialized()) {
+        blueNoise.bindTexture(glState, GL_TEXTURE0 + BLUE_NOISE_TEXTURE_UNIT);
+        glState.activeTexture(GL_TEXTURE0);
+        glUniform1i(glGetUniformLocation(computeShader, "blueNoise"), BLUE_NOISE_TEXTURE_UNIT);
+    }
+
+    // Set scene uniforms
+    glUniform1i(glGetUniformLocation(computeShader, "numSpheres"), static_cast<int>(spheres.size()));
+
+    // Upload sphere data (simplified - in a real implementation you'd use uniform buffers)
+    for (int i = 0; i < std::min(static_cast<int>(spheres.size()), 20); i++) {
+        std::string prefix = "spheres[" + std::to_string(i) + "]";
+        glUniform3f(glGetUniformLocation(computeShader, (prefix + ".center").c_str()), 
+                   spheres[i].center.x, spheres[i].center.y, spheres[i].center.z);
+        glUniform1f(glGetUniformLocation(computeShader, (prefix + ".radius").c_str()), 
+                   spheres[i].radius);
+        glUniform3f(glGetUniformLocation(computeShader, (prefix + ".material.albedo").c_str()), 
+                   spheres[i].material.albedo.x, spheres[i].material.albedo.y, spheres[i].material.albedo.z);
+        glUniform3f(glGetUniformLocation(computeShader, (prefix + ".material.specular").c_str()), 
+                   spheres[i].material.specular.x, spheres[i].material.specular.y, spheres[i].material.specular.z);
+        glUniform1f(glGetUniformLocation(computeShader, (prefix + ".material.shininess").c_str()), 
+                   spheres[i].material.shininess);
+        glUniform1f(glGetUniformLocation(computeShader, (prefix + ".material.metallic").c_str()), 
+                   spheres[i].material.metallic);
+        glUniform1f(glGetUniformLocation(computeShader, (prefix + ".material.roughness").c_str()), 
+                   spheres[i].material.roughness);
+        glUniform1f(glGetUniformLocation(computeShader, (prefix + ".material.ior").c_str()), 
+                   spheres[i].material.ior);
+        glUniform1i(glGetUniformLocation(computeShader, (prefix + ".material.type").c_str()), 
+                   spheres[i].material.type);
+    }
+
+    // Set floor uniforms
+    glUniform3f(glGetUniformLocation(computeShader, "floorNormal"), 0.0f, 1.0f, 0.0f);
+    glUniform1f(glGetUniformLocation(computeShader, "floorDistance"), 0.5f);
+
+    RTMaterial floorMat;
+    floorMat.albedo = glm::vec3(0.3f, 0.3f, 0.3f);
+    floorMat.specular = glm::vec3(0.2f, 0.2f, 0.2f);
+    floorMat.shininess = 16.0f;
+    floorMat.metallic = 0.0f;
+    floorMat.roughness = 0.8f;
+    floorMat.ior = 1.0f;
+    floorMat.type = 0;
+
+    glUniform3f(glGetUniformLocation(computeShader, "floorMaterial.albedo"), 
+               floorMat.albedo.x, floorMat.albedo.y, floorMat.albedo.z);
+    glUniform3f(glGetUniformLocation(computeShader, "floorMaterial.specular"), 
+               floorMat.specular.x, floorMat.specular.y, floorMat.specular.z);
+    glUniform1f(glGetUniformLocation(computeShader, "floorMaterial.shininess"), floorMat.shininess);
+    glUniform1f(glGetUniformLocation(computeShader, "floorMaterial.metallic"), floorMat.metallic);
+    glUniform1f(glGetUniformLocation(computeShader, "floorMaterial.roughness"), floorMat.roughness);
+    glUniform1f(glGetUniformLocation(computeShader, "floorMaterial.ior"), floorMat.ior);
+    glUniform1i(glGetUniformLocation(computeShader, "floorMaterial.type"), floorMat.type);
+}
+
+void GraphicsManager::setRaytracingSampler(RaytracingSampler sampler) {
+    if (sampler == RaytracingSampler::BlueNoise && !blueNoise.isInitialized()) {
+        std::cerr << "Blue noise texture unavailable, using Sobol" << std::endl;
+        sampler = RaytracingSampler::Sobol;
+    }
+    raytracingSampler = sampler;
+}
+
+void GraphicsManager::setOutputFramebuffer(GLuint framebuffer) {
+    outputFramebuffer = framebuffer;
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+    glViewport(0, 0, screenWidth, screenHeight);
+}
+
+void GraphicsManager::bindInstanceAttributes(const StreamingAllocation& allocation, GLuint firstLocation,
+                                             int vec4Count, GLsizei stride) {
+    glState.bindBuffer(GL_ARRAY_BUFFER, allocation.buffer);
+    for (int i = 0; i < vec4Count; i++) {
+        glVertexAttribPointer(firstLocation + i, 4, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<const void*>(allocation.offset + i * sizeof(glm::vec4)));
+    }
+}
+
+bool GraphicsManager::startFrameCapture(const std::string& path, int frameRate) {
+    return frameCapture.start(glState, path, screenWidth, screenHeight, frameRate);
+}
+
+void GraphicsManager::captureFrame() {
+    if (!frameCapture.isActive()) {
+        return;
+    }
+    CPU_PROFILE_SCOPE("Frame capture");
+    GpuProfileScope captureScope(gpuProfiler, "Capture");
+    frameCapture.captureFrame(glState, outputFramebuffer);
+}
+
+void GraphicsManager::stopFrameCapture() {
+    frameCapture.stop(glState);
+}
+
+bool GraphicsManager::enableForwardPlus() {
+    if (forwardPlusSupported) {
+        return true;
+    }
+    if (!raytracingSupported) {
+        std::cerr << "Forward+ needs compute shader support" << std::endl;
+        return false;
+    }
+    forwardPlusSupported = initForwardPlus();
+    if (forwardPlusSupported) {
+        std::cout << "Forward+ (Tiled Forward) rendering initialized successfully!" << std::endl;
+    } else {
+        std::cerr << "Forward+ rendering initialization failed" << std::endl;
+    }
+    return forwardPlusSupported;
+}
+
+void GraphicsManager::setLightProperties(const glm::vec3& lightPos, const glm::vec3& lightColor) {
+    currentLightPos = lightPos;
+    currentLightColor = lightColor;
+}
+
+void GraphicsManager::setupSphereBuffers(const std::vector<float>& vertices, const std::vector<unsigned int>& indices) {
+    sphereIndexCount = static_cast<int>(indices.size());
+    
+    glGenVertexArrays(1, &sphereVAO);
+    glGenBuffers(1, &sphereVBO);
     glGenBuffers(1, &sphereEBO);
 
-    glBindVertexArray(sphereVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, sphereVBO);
+    glState.bindVertexArray(sphereVAO);
+    glState.bindBuffer(GL_ARRAY_BUFFER, sphereVBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereEBO);
+    glState.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereEBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
 
     // Position attribute
@@ -726,10 +2608,10 @@ void GraphicsManager::setupFloorBuffers(const std::vector<float>& vertices, cons
     glGenBuffers(1, &floorVBO);
     glGenBuffers(1, &floorEBO);
 
-    glBindVertexArray(floorVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, floorVBO);
+    glState.bindVertexArray(floorVAO);
+    glState.bindBuffer(GL_ARRAY_BUFFER, floorVBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, floorEBO);
+    glState.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, floorEBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
 
     // Floor vertex attributes
@@ -751,9 +2633,10 @@ bool GraphicsManager::checkComputeShaderSupport() {
 
 bool GraphicsManager::loadComputeShaderFunctions() {
     // Load compute shader function pointers
-    pglDispatchCompute = (PFNGLDISPATCHCOMPUTEPROC)glfwGetProcAddress("glDispatchCompute");
-    pglBindImageTexture = (PFNGLBINDIMAGETEXTUREPROC)glfwGetProcAddress("glBindImageTexture");
-    pglMemoryBarrier = (PFNGLMEMORYBARRIERPROC)glfwGetProcAddress("glMemoryBarrier");
+    pglDispatchCompute = (PFNGLDISPATCHCOMPUTEPROC)procAddressLoader("glDispatchCompute");
+    pglDispatchComputeIndirect = (PFNGLDISPATCHCOMPUTEINDIRECTPROC)procAddressLoader("glDispatchComputeIndirect");
+    pglBindImageTexture = (PFNGLBINDIMAGETEXTUREPROC)procAddressLoader("glBindImageTexture");
+    pglMemoryBarrier = (PFNGLMEMORYBARRIERPROC)procAddressLoader("glMemoryBarrier");
     
     if (!pglDispatchCompute) {
         std::cerr << "Failed to load glDispatchCompute" << std::endl;
@@ -799,6 +2682,10 @@ bool GraphicsManager::initForwardPlus() {
         std::cerr << "Failed to load tiled forward shaders" << std::endl;
         return false;
     }
+    glState.useProgram(tiledForwardShader);
+    shadowMaps.setUniforms(tiledForwardShader, SHADOW_TEXTURE_UNIT, false);
+    glUniform1i(glGetUniformLocation(tiledForwardShader, "pointShadowMap"), POINT_SHADOW_TEXTURE_UNIT);
+    glUniform1i(glGetUniformLocation(tiledForwardShader, "pointShadowCount"), 0);
     
     setupForwardPlusBuffers();
     return true;
@@ -807,46 +2694,39 @@ bool GraphicsManager::initForwardPlus() {
 void GraphicsManager::setupForwardPlusBuffers() {
     // Create depth texture for depth prepass
     glGenTextures(1, &depthTexture);
-    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glState.bindTexture(GL_TEXTURE_2D, depthTexture);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, screenWidth, screenHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     
-    // Define GL_SHADER_STORAGE_BUFFER if not available
-    const GLenum GL_SHADER_STORAGE_BUFFER_LOCAL = 0x90D2;
-    
-    // Create light data buffer (for all lights in scene)
-    glGenBuffers(1, &lightDataBuffer);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, lightDataBuffer);
-    glBufferData(GL_SHADER_STORAGE_BUFFER_LOCAL, sizeof(float) * 8 * 256, nullptr, GL_DYNAMIC_DRAW); // Max 256 lights, 8 floats each (pos.xyz, color.rgb, radius, intensity)
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER_LOCAL, 0, lightDataBuffer);
+    // Light data (binding 0) streams in every frame, see updateLightData
     
     // Create visible light indices buffer (per tile)
     int totalTiles = numTilesX * numTilesY;
     glGenBuffers(1, &visibleLightIndicesBuffer);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, visibleLightIndicesBuffer);
+    glState.bindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, visibleLightIndicesBuffer);
     glBufferData(GL_SHADER_STORAGE_BUFFER_LOCAL, sizeof(GLuint) * totalTiles * maxLightsPerTile, nullptr, GL_DYNAMIC_DRAW);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER_LOCAL, 1, visibleLightIndicesBuffer);
+    glState.bindBufferBase(GL_SHADER_STORAGE_BUFFER_LOCAL, 1, visibleLightIndicesBuffer);
     
     // Create light list buffer (count of lights per tile)
     glGenBuffers(1, &lightListBuffer);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, lightListBuffer);
+    glState.bindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, lightListBuffer);
     glBufferData(GL_SHADER_STORAGE_BUFFER_LOCAL, sizeof(GLuint) * totalTiles, nullptr, GL_DYNAMIC_DRAW);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER_LOCAL, 2, lightListBuffer);
+    glState.bindBufferBase(GL_SHADER_STORAGE_BUFFER_LOCAL, 2, lightListBuffer);
     
     std::cout << "Forward+ buffers created: " << totalTiles << " tiles, max " << maxLightsPerTile << " lights per tile" << std::endl;
 }
 
 void GraphicsManager::cleanupForwardPlus() {
     if (depthTexture) glDeleteTextures(1, &depthTexture);
-    if (lightDataBuffer) glDeleteBuffers(1, &lightDataBuffer);
     if (visibleLightIndicesBuffer) glDeleteBuffers(1, &visibleLightIndicesBuffer);
     if (lightListBuffer) glDeleteBuffers(1, &lightListBuffer);
     if (depthPrepassShader) glDeleteProgram(depthPrepassShader);
     if (lightCullingComputeShader) glDeleteProgram(lightCullingComputeShader);
     if (tiledForwardShader) glDeleteProgram(tiledForwardShader);
+    glState.invalidate();
 }
 
 void GraphicsManager::renderForwardPass(const glm::mat4& view, const glm::mat4& projection, 
@@ -856,12 +2736,17 @@ void GraphicsManager::renderForwardPass(const glm::mat4& view, const glm::mat4&
                                         const glm::vec3& mainObjectPos,
                                         const Material& currentMaterial) {
     // Forward rendering: render objects front-to-back for early Z rejection
+    GpuProfileScope forwardScope(gpuProfiler, "Forward");
     
-    // 1. Render opaque objects first (front to back for performance)
+    // 1. Render opaque objects first (sorted by state, then front to back)
+    gpuProfiler.beginScope("Opaque");
     renderOpaqueObjects(view, projection, spheres, cubes, bullets, mainObjectPos, currentMaterial);
+    gpuProfiler.endScope();
     
-    // 2. Render transparent objects last (back to front for correct blending)
+    // 2. Transparent objects last (order-independent, no sort needed)
+    gpuProfiler.beginScope("Transparent");
     renderTransparentObjects(view, projection, spheres, cubes, bullets);
+    gpuProfiler.endScope();
 }
 
 void GraphicsManager::renderOpaqueObjects(const glm::mat4& view, const glm::mat4& projection,
@@ -871,58 +2756,195 @@ void GraphicsManager::renderOpaqueObjects(const glm::mat4& view, const glm::mat4
                                          const glm::vec3& mainObjectPos,
                                          const Material& currentMaterial) {
     // Disable blending for opaque objects
-    glDisable(GL_BLEND);
+    glState.disable(GL_BLEND);
     
     // Set global render state once for all objects
     setGlobalRenderState(view, projection);
     
-    // Render floor first (usually largest/farthest object)
-    glm::mat4 floorModel = glm::mat4(1.0f);
-    floorModel = glm::translate(floorModel, glm::vec3(0.0f, -0.5f, 0.0f));
-    floorModel = glm::scale(floorModel, glm::vec3(20.0f, 0.1f, 20.0f));
-    renderFloor(floorModel, view, projection);
+    if (gpuCullingEnabled || sphereImpostorsEnabled) {
+        // Floor first, then all spheres in one batched draw
+        glm::mat4 floorModel = glm::mat4(1.0f);
+        floorModel = glm::translate(floorModel, glm::vec3(0.0f, -0.5f, 0.0f));
+        floorModel = glm::scale(floorModel, glm::vec3(20.0f, 0.1f, 20.0f));
+        renderFloor(floorModel, view, projection);
+        
+        // GPU-driven mode: frustum and occlusion culled on the GPU and drawn with one multi-draw call
+        if (gpuCullingEnabled) {
+            performDepthPrepass(view, projection, spheres, cubes, bullets, mainObjectPos);
+            renderGpuCulledSpheres(view, projection, spheres);
+            return;
+        }
+        
+        // Impostor mode: main sphere, cubes and bullets in one instanced draw
+        renderSphereImpostors(view, projection, spheres);
+        return;
+    }
     
-    // Render main sphere
-    glm::mat4 mainModel = glm::mat4(1.0f);
-    mainModel = glm::translate(mainModel, mainObjectPos);
-    renderSphere(mainModel, view, projection, currentMaterial, true);
+    // A glass main sphere (spheres[0], see buildRaytracingScene) is left to the transparent pass
+    bool mainSphereTransparent = oitSupported && !spheres.empty() && spheres[0].material.type == RT_MATERIAL_GLASS;
     
-    // Render spawned cubes (opaque)
-    for (const auto& cube : cubes) {
-        if (cube.isActive) {
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, cube.position);
-            renderSpawned(model, view, projection);
+    // Only objects inside the view frustum are queued; the queue orders them by
+    // program, material and front-to-back depth and the floor goes last
+    cullOpaqueObjects(view, projection, cubes, bullets, mainObjectPos, !mainSphereTransparent);
+    buildOpaqueRenderQueue(view, projection);
+    submitOpaqueRenderQueue(cubes, bullets, mainObjectPos, currentMaterial);
+}
+
+namespace {
+    // Sort-key program slots: spheres come before the floor so it is depth-rejected behind them
+    const uint32_t SORT_PROGRAM_MAIN = 0;
+    const uint32_t SORT_PROGRAM_FLOOR = 1;
+    
+    // Sort-key material slots for the main shader
+    const uint32_t SORT_MATERIAL_CURRENT = 0;
+    const uint32_t SORT_MATERIAL_SPAWNED = 1;
+    const uint32_t SORT_MATERIAL_BULLET = 2;
+    
+    // Packet payload for the floor (other payloads index cpuCullObjects)
+    const uint32_t FLOOR_PACKET = 0xFFFFFFFFu;
+}
+
+void GraphicsManager::buildOpaqueRenderQueue(const glm::mat4& view, const glm::mat4& projection) {
+    // Far plane distance from the projection matrix, for depth quantization
+    float farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+    
+    opaqueQueue.clear();
+    opaqueQueue.reserve(cpuVisibleObjects.size() + 1);
+    
+    for (uint32_t visibleIndex : cpuVisibleObjects) {
+        glm::vec3 center(cpuCullBounds.centerX[visibleIndex], cpuCullBounds.centerY[visibleIndex], cpuCullBounds.centerZ[visibleIndex]);
+        float depth = -(view * glm::vec4(center, 1.0f)).z;
+        
+        uint32_t material = SORT_MATERIAL_CURRENT;
+        switch (cpuCullObjects[visibleIndex].kind) {
+        case CulledObjectKind::MainSphere: material = SORT_MATERIAL_CURRENT; break;
+        case CulledObjectKind::Cube: material = SORT_MATERIAL_SPAWNED; break;
+        case CulledObjectKind::Bullet: material = SORT_MATERIAL_BULLET; break;
         }
+        opaqueQueue.push(RenderQueue::makeKey(RenderPass::Opaque, SORT_PROGRAM_MAIN, material, depth, farPlane), visibleIndex);
     }
     
-    // Render bullets (small objects, render last among opaques)
-    for (const auto& bullet : bullets) {
-        if (bullet.active) {
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, bullet.position);
+    opaqueQueue.push(RenderQueue::makeKey(RenderPass::Opaque, SORT_PROGRAM_FLOOR, 0, farPlane, farPlane), FLOOR_PACKET);
+    
+    renderQueueStats = RenderQueueStats();
+    renderQueueStats.drawCount = static_cast<uint32_t>(opaqueQueue.size());
+    opaqueQueue.countStateChanges(renderQueueStats.unsortedProgramSwitches, renderQueueStats.unsortedMaterialSwitches);
+    opaqueQueue.sort();
+    opaqueQueue.countStateChanges(renderQueueStats.programSwitches, renderQueueStats.materialSwitches);
+}
+
+void GraphicsManager::submitOpaqueRenderQueue(const std::vector<Cube>& cubes, const std::vector<Bullet>& bullets,
+                                              const glm::vec3& mainObjectPos, const Material& currentMaterial) {
+    // View, projection and lighting were set per program by setGlobalRenderState;
+    // only program, material and model changes are issued here
+    const uint32_t NONE = 0xFFFFFFFFu;
+    uint32_t boundProgram = NONE;
+    uint32_t boundMaterial = NONE;
+    GLint modelLocation = -1;
+    
+    for (const DrawPacket& packet : opaqueQueue.getPackets()) {
+        uint32_t program = RenderQueue::programFromKey(packet.key);
+        uint32_t material = RenderQueue::materialFromKey(packet.key);
+        
+        if (program != boundProgram) {
+            GLuint shader = (program == SORT_PROGRAM_FLOOR) ? floorShaderProgram : mainShaderProgram;
+            glState.useProgram(shader);
+            glState.bindVertexArray(program == SORT_PROGRAM_FLOOR ? floorVAO : sphereVAO);
+            modelLocation = glGetUniformLocation(shader, "model");
+            boundProgram = program;
+            boundMaterial = NONE;
+        }
+        
+        if (material != boundMaterial && program == SORT_PROGRAM_MAIN) {
+            switch (material) {
+            case SORT_MATERIAL_SPAWNED: setSpawnedMaterialUniforms(); break;
+            case SORT_MATERIAL_BULLET: setBulletMaterialUniforms(); break;
+            default: setMaterialUniforms(mainShaderProgram, currentMaterial, true); break;
+            }
+            boundMaterial = material;
+        }
+        
+        glm::mat4 model = glm::mat4(1.0f);
+        if (packet.objectIndex == FLOOR_PACKET) {
+            model = glm::translate(model, glm::vec3(0.0f, -0.5f, 0.0f));
+            model = glm::scale(model, glm::vec3(20.0f, 0.1f, 20.0f));
+            glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &model[0][0]);
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+            continue;
+        }
+        
+        const CulledObject& object = cpuCullObjects[packet.objectIndex];
+        switch (object.kind) {
+        case CulledObjectKind::MainSphere:
+            model = glm::translate(model, mainObjectPos);
+            break;
+        case CulledObjectKind::Cube:
+            model = glm::translate(model, cubes[object.index].position);
+            break;
+        case CulledObjectKind::Bullet:
+            model = glm::translate(model, bullets[object.index].position);
             model = glm::scale(model, glm::vec3(0.05f));
-            renderBullet(model, view, projection);
+            break;
+        }
+        glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &model[0][0]);
+        glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+    }
+}
+
+void GraphicsManager::cullOpaqueObjects(const glm::mat4& view, const glm::mat4& projection,
+                                        const std::vector<Cube>& cubes, const std::vector<Bullet>& bullets,
+                                        const glm::vec3& mainObjectPos, bool includeMainSphere) {
+    // Bounding radii of the sphere mesh (radius 0.5) at each object's scale
+    const float mainRadius = 0.5f;
+    const float cubeRadius = 0.5f;
+    const float bulletRadius = 0.5f * 0.05f;
+    
+    cpuCullBounds.clear();
+    cpuCullObjects.clear();
+    cpuCullBounds.reserve(1 + cubes.size() + bullets.size());
+    cpuCullObjects.reserve(1 + cubes.size() + bullets.size());
+    
+    if (includeMainSphere) {
+        cpuCullBounds.add(mainObjectPos, mainRadius);
+        cpuCullObjects.push_back({CulledObjectKind::MainSphere, 0});
+    }
+    
+    for (size_t i = 0; i < cubes.size(); i++) {
+        if (cubes[i].isActive) {
+            cpuCullBounds.add(cubes[i].position, cubeRadius);
+            cpuCullObjects.push_back({CulledObjectKind::Cube, static_cast<uint32_t>(i)});
         }
     }
+    
+    for (size_t i = 0; i < bullets.size(); i++) {
+        if (bullets[i].active) {
+            cpuCullBounds.add(bullets[i].position, bulletRadius);
+            cpuCullObjects.push_back({CulledObjectKind::Bullet, static_cast<uint32_t>(i)});
+        }
+    }
+    
+    Frustum frustum = FrustumCuller::extractFrustum(projection * view);
+    FrustumCuller::cullSpheres(frustum, cpuCullBounds, cpuVisibleObjects);
 }
 
 void GraphicsManager::renderTransparentObjects(const glm::mat4& view, const glm::mat4& projection,
                                               const std::vector<RTSphere>& spheres,
                                               const std::vector<Cube>& cubes,
                                               const std::vector<Bullet>& bullets) {
-    // Enable blending for transparent objects
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    
-    // Disable depth writing for transparent objects (but keep depth testing)
-    glDepthMask(GL_FALSE);
-    
-    // TODO: Sort transparent objects back-to front and render
-    // For now, no transparent objects in this scene
+    // The batched GPU paths already drew every sphere opaque
+    if (gpuCullingEnabled || sphereImpostorsEnabled || !oitSupported) {
+        return;
+    }
     
-    // Re-enable depth writing
-    glDepthMask(GL_TRUE);
+    // Glass spheres go through weighted blended OIT: one accumulation draw and one
+    // composite pass, no back-to-front sort
+    transparentSpheres.clear();
+    for (const auto& sphere : spheres) {
+        if (sphere.material.type == RT_MATERIAL_GLASS) {
+            transparentSpheres.push_back(sphere);
+        }
+    }
+    renderTransparentSpheres(view, projection, transparentSpheres);
 }
 
 void GraphicsManager::setGlobalRenderState(const glm::mat4& view, const glm::mat4& projection) {
@@ -932,20 +2954,22 @@ void GraphicsManager::setGlobalRenderState(const glm::mat4& view, const glm::mat
     glm::vec3 viewPos = glm::vec3(glm::inverse(view)[3]);
     
     // Set for main shader
-    glUseProgram(mainShaderProgram);
+    glState.useProgram(mainShaderProgram);
     glUniformMatrix4fv(glGetUniformLocation(mainShaderProgram, "view"), 1, GL_FALSE, &view[0][0]);
     glUniformMatrix4fv(glGetUniformLocation(mainShaderProgram, "projection"), 1, GL_FALSE, &projection[0][0]);
     glUniform3f(glGetUniformLocation(mainShaderProgram, "viewPos"), viewPos.x, viewPos.y, viewPos.z);
     glUniform3f(glGetUniformLocation(mainShaderProgram, "lightPos"), currentLightPos.x, currentLightPos.y, currentLightPos.z);
     glUniform3f(glGetUniformLocation(mainShaderProgram, "lightColor"), currentLightColor.x, currentLightColor.y, currentLightColor.z);
+    setShadowUniforms(mainShaderProgram);
     
     // Set for floor shader
-    glUseProgram(floorShaderProgram);
+    glState.useProgram(floorShaderProgram);
     glUniformMatrix4fv(glGetUniformLocation(floorShaderProgram, "view"), 1, GL_FALSE, &view[0][0]);
     glUniformMatrix4fv(glGetUniformLocation(floorShaderProgram, "projection"), 1, GL_FALSE, &projection[0][0]);
     glUniform3f(glGetUniformLocation(floorShaderProgram, "viewPos"), viewPos.x, viewPos.y, viewPos.z);
     glUniform3f(glGetUniformLocation(floorShaderProgram, "lightPos"), currentLightPos.x, currentLightPos.y, currentLightPos.z);
     glUniform3f(glGetUniformLocation(floorShaderProgram, "lightColor"), currentLightColor.x, currentLightColor.y, currentLightColor.z);
+    setShadowUniforms(floorShaderProgram);
 }
 
 void GraphicsManager::setMaterialUniforms(GLuint program, const Material& material, bool useEnhancedFeatures) {
@@ -983,27 +3007,39 @@ void GraphicsManager::renderForwardPlusPass(const glm::mat4& view, const glm::ma
                                            const std::vector<Bullet>& bullets,
                                            const glm::vec3& mainObjectPos,
                                            const Material& currentMaterial) {
+    // Both raster paths sample the main light's cascades
+    renderShadowMaps(view, projection, cubes, bullets, mainObjectPos);
+    
     if (!forwardPlusSupported) {
         // Fallback to traditional forward rendering
         renderForwardPass(view, projection, spheres, cubes, bullets, mainObjectPos, currentMaterial);
         return;
     }
     
+    GpuProfileScope forwardPlusScope(gpuProfiler, "Forward+");
+    
+    // Only the tiled path shades the point lights
+    renderPointShadows(view, projection, cubes, bullets, mainObjectPos);
+    
     // Simplified Forward+ without depth prepass for now
     // Just do light culling and tiled shading
     
     // 1. Light culling (compute shader) 
-    performLightCulling(view, projection);
+    {
+        GpuProfileScope cullingScope(gpuProfiler, "Light culling");
+        performLightCulling(view, projection);
+    }
     
     // 2. Regular forward rendering with tiled lighting
     // Skip the depth prepass and just render normally but with tiled lighting
+    GpuProfileScope shadingScope(gpuProfiler, "Tiled shading");
     
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glDepthMask(GL_TRUE);
+    glState.enable(GL_DEPTH_TEST);
+    glState.depthFunc(GL_LESS);
+    glState.depthMask(true);
     
     // Use tiled forward shader
-    glUseProgram(tiledForwardShader);
+    glState.useProgram(tiledForwardShader);
     
     // Set common uniforms
     glUniformMatrix4fv(glGetUniformLocation(tiledForwardShader, "view"), 1, GL_FALSE, &view[0][0]);
@@ -1014,6 +3050,8 @@ void GraphicsManager::renderForwardPlusPass(const glm::mat4& view, const glm::ma
     // Set view position for specular calculations
     glm::vec3 viewPos = glm::vec3(glm::inverse(view)[3]);
     glUniform3f(glGetUniformLocation(tiledForwardShader, "viewPos"), viewPos.x, viewPos.y, viewPos.z);
+    setShadowUniforms(tiledForwardShader);
+    glUniform1i(glGetUniformLocation(tiledForwardShader, "pointShadowCount"), pointShadowRecords);
     
     // Render floor
     glm::mat4 floorModel = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.5f, 0.0f));
@@ -1021,46 +3059,62 @@ void GraphicsManager::renderForwardPlusPass(const glm::mat4& view, const glm::ma
     glUniformMatrix4fv(glGetUniformLocation(tiledForwardShader, "model"), 1, GL_FALSE, &floorModel[0][0]);
     glUniform3f(glGetUniformLocation(tiledForwardShader, "objectColor"), 0.3f, 0.3f, 0.3f);
     glUniform1i(glGetUniformLocation(tiledForwardShader, "useMaterial"), 0);
-    glBindVertexArray(floorVAO);
+    glState.bindVertexArray(floorVAO);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
     
-    // Render main sphere
-    glm::mat4 mainModel = glm::translate(glm::mat4(1.0f), mainObjectPos);
-    glUniformMatrix4fv(glGetUniformLocation(tiledForwardShader, "model"), 1, GL_FALSE, &mainModel[0][0]);
-    
-    // Set material properties for main sphere
-    glUniform3f(glGetUniformLocation(tiledForwardShader, "material.ambient"), 
-               currentMaterial.ambient.x, currentMaterial.ambient.y, currentMaterial.ambient.z);
-    glUniform3f(glGetUniformLocation(tiledForwardShader, "material.diffuse"), 
-               currentMaterial.diffuse.x, currentMaterial.diffuse.y, currentMaterial.diffuse.z);
-    glUniform3f(glGetUniformLocation(tiledForwardShader, "material.specular"), 
-               currentMaterial.specular.x, currentMaterial.specular.y, currentMaterial.specular.z);
-    glUniform1f(glGetUniformLocation(tiledForwardShader, "material.shininess"), currentMaterial.shininess);
-    glUniform1i(glGetUniformLocation(tiledForwardShader, "useMaterial"), 1);
-    
-    glBindVertexArray(sphereVAO);
-    glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+    // GPU-driven mode: frustum and occlusion culled on the GPU and drawn with one multi-draw call
+    if (gpuCullingEnabled) {
+        performDepthPrepass(view, projection, spheres, cubes, bullets, mainObjectPos);
+        renderGpuCulledSpheres(view, projection, spheres);
+        return;
+    }
     
-    // Render spawned cubes
-    for (const auto& cube : cubes) {
-        if (cube.isActive) {
-            glm::mat4 model = glm::translate(glm::mat4(1.0f), cube.position);
+    // Impostor mode: all spheres in one instanced draw
+    if (sphereImpostorsEnabled) {
+        renderSphereImpostors(view, projection, spheres);
+        return;
+    }
+    
+    // Submit only frustum-visible objects
+    cullOpaqueObjects(view, projection, cubes, bullets, mainObjectPos);
+    glState.bindVertexArray(sphereVAO);
+    
+    for (uint32_t visibleIndex : cpuVisibleObjects) {
+        const CulledObject& object = cpuCullObjects[visibleIndex];
+        switch (object.kind) {
+        case CulledObjectKind::MainSphere: {
+            glm::mat4 mainModel = glm::translate(glm::mat4(1.0f), mainObjectPos);
+            glUniformMatrix4fv(glGetUniformLocation(tiledForwardShader, "model"), 1, GL_FALSE, &mainModel[0][0]);
+            
+            // Set material properties for main sphere
+            glUniform3f(glGetUniformLocation(tiledForwardShader, "material.ambient"), 
+                       currentMaterial.ambient.x, currentMaterial.ambient.y, currentMaterial.ambient.z);
+            glUniform3f(glGetUniformLocation(tiledForwardShader, "material.diffuse"), 
+                       currentMaterial.diffuse.x, currentMaterial.diffuse.y, currentMaterial.diffuse.z);
+            glUniform3f(glGetUniformLocation(tiledForwardShader, "material.specular"), 
+                       currentMaterial.specular.x, currentMaterial.specular.y, currentMaterial.specular.z);
+            glUniform1f(glGetUniformLocation(tiledForwardShader, "material.shininess"), currentMaterial.shininess);
+            glUniform1i(glGetUniformLocation(tiledForwardShader, "useMaterial"), 1);
+            glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+            break;
+        }
+        case CulledObjectKind::Cube: {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), cubes[object.index].position);
             glUniformMatrix4fv(glGetUniformLocation(tiledForwardShader, "model"), 1, GL_FALSE, &model[0][0]);
             glUniform3f(glGetUniformLocation(tiledForwardShader, "objectColor"), 0.3f, 0.8f, 0.3f);
             glUniform1i(glGetUniformLocation(tiledForwardShader, "useMaterial"), 0);
             glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+            break;
         }
-    }
-    
-    // Render bullets
-    for (const auto& bullet : bullets) {
-        if (bullet.active) {
-            glm::mat4 model = glm::translate(glm::mat4(1.0f), bullet.position);
+        case CulledObjectKind::Bullet: {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), bullets[object.index].position);
             model = glm::scale(model, glm::vec3(0.05f));
             glUniformMatrix4fv(glGetUniformLocation(tiledForwardShader, "model"), 1, GL_FALSE, &model[0][0]);
             glUniform3f(glGetUniformLocation(tiledForwardShader, "objectColor"), 1.0f, 1.0f, 0.0f);
             glUniform1i(glGetUniformLocation(tiledForwardShader, "useMaterial"), 0);
             glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+            break;
+        }
         }
     }
     
@@ -1071,33 +3125,308 @@ void GraphicsManager::renderForwardPlusPass(const glm::mat4& view, const glm::ma
     }
 }
 
+bool GraphicsManager::initShadowMaps() {
+    // Receivers always get the shadow sampler on its own unit; left at unit 0 it would clash
+    // with the main shader's cube map sampler even while shadows are off
+    for (GLuint program : { mainShaderProgram, floorShaderProgram }) {
+        glState.useProgram(program);
+        shadowMaps.setUniforms(program, SHADOW_TEXTURE_UNIT, false);
+    }
+
+    // Casters are drawn with the depth-only prepass shader
+    if (depthPrepassShader == 0) {
+        depthPrepassShader = loadShaders("depth_prepass_vertex.glsl", "depth_prepass_fragment.glsl");
+        if (depthPrepassShader == 0) {
+            std::cerr << "Failed to load depth prepass shaders" << std::endl;
+            return false;
+        }
+    }
+
+    bool initialized = shadowMaps.initialize(glState);
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+    return initialized;
+}
+
+void GraphicsManager::renderShadowMaps(const glm::mat4& view, const glm::mat4& projection,
+                                       const std::vector<Cube>& cubes, const std::vector<Bullet>& bullets,
+                                       const glm::vec3& mainObjectPos) {
+    if (!areShadowsEnabled()) {
+        return;
+    }
+    CPU_PROFILE_SCOPE("Shadow maps");
+    GpuProfileScope shadowScope(gpuProfiler, "Shadow maps");
+
+    // The main sphere joins the cached static layers once it comes to rest; while it moves it
+    // is drawn with the dynamic casters. Either change invalidates the cache
+    bool resting = mainObjectPos == lastMainObjectPos;
+    lastMainObjectPos = mainObjectPos;
+    if (resting != mainSphereStatic) {
+        mainSphereStatic = resting;
+        shadowMaps.invalidateStatic();
+    }
+
+    // The main light is a point light close to the scene; the cascades need a directional
+    // projection, so they shadow along the direction from the scene origin to the light
+    glm::vec3 lightDirection = glm::length(currentLightPos) > 0.0f ? glm::normalize(currentLightPos) : glm::vec3(0.0f, 1.0f, 0.0f);
+    shadowMaps.scheduleUpdates(view, projection, lightDirection, shadowUpdates);
+    if (shadowUpdates.empty()) {
+        return;
+    }
+
+    gatherShadowCasters(cubes, bullets, mainObjectPos, !mainSphereStatic);
+
+    glm::mat4 floorModel = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.5f, 0.0f));
+    floorModel = glm::scale(floorModel, glm::vec3(20.0f, 0.1f, 20.0f));
+    glm::mat4 mainModel = glm::translate(glm::mat4(1.0f), mainObjectPos);
+
+    glState.enable(GL_DEPTH_TEST);
+    glState.depthFunc(GL_LESS);
+    glState.enable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(2.0f, 4.0f);
+    glState.useProgram(depthPrepassShader);
+    GLint modelLocation = glGetUniformLocation(depthPrepassShader, "model");
+    ShadowStats& stats = shadowMaps.frameStats();
+
+    for (const ShadowCascadeUpdate& update : shadowUpdates) {
+        glUniformMatrix4fv(glGetUniformLocation(depthPrepassShader, "view"), 1, GL_FALSE, &update.lightView[0][0]);
+        glUniformMatrix4fv(glGetUniformLocation(depthPrepassShader, "projection"), 1, GL_FALSE, &update.lightProjection[0][0]);
+
+        if (update.rebuildStatic) {
+            shadowMaps.beginStaticLayer(glState, update);
+            glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &floorModel[0][0]);
+            glState.bindVertexArray(floorVAO);
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+            if (mainSphereStatic) {
+                glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &mainModel[0][0]);
+                glState.bindVertexArray(sphereVAO);
+                glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+            }
+        }
+
+        Frustum frustum = FrustumCuller::extractFrustum(update.lightProjection * update.lightView);
+        FrustumCuller::cullSpheres(frustum, shadowCasterBounds, shadowVisibleCasters);
+        if (!shadowMaps.beginCascade(glState, update, static_cast<uint32_t>(shadowVisibleCasters.size()))) {
+            continue;
+        }
+
+        glState.bindVertexArray(sphereVAO);
+        for (uint32_t caster : shadowVisibleCasters) {
+            glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &shadowCasterModels[caster][0][0]);
+            glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+        }
+        stats.casterDraws += static_cast<uint32_t>(shadowVisibleCasters.size());
+    }
+
+    glState.disable(GL_POLYGON_OFFSET_FILL);
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+    glViewport(0, 0, screenWidth, screenHeight);
+    shadowMaps.bindTexture(glState, GL_TEXTURE0 + SHADOW_TEXTURE_UNIT);
+    glState.activeTexture(GL_TEXTURE0);
+}
+
+void GraphicsManager::setShadowUniforms(GLuint program) {
+    shadowMaps.setUniforms(program, SHADOW_TEXTURE_UNIT, areShadowsEnabled());
+}
+
+void GraphicsManager::gatherShadowCasters(const std::vector<Cube>& cubes, const std::vector<Bullet>& bullets,
+                                          const glm::vec3& mainObjectPos, bool includeMainSphere) {
+    // Dynamic casters with the same models as the forward passes
+    shadowCasterBounds.clear();
+    shadowCasterModels.clear();
+    if (includeMainSphere) {
+        shadowCasterBounds.add(mainObjectPos, 0.5f);
+        shadowCasterModels.push_back(glm::translate(glm::mat4(1.0f), mainObjectPos));
+    }
+    for (const Cube& cube : cubes) {
+        if (cube.isActive) {
+            shadowCasterBounds.add(cube.position, 0.5f);
+            shadowCasterModels.push_back(glm::translate(glm::mat4(1.0f), cube.position));
+        }
+    }
+    for (const Bullet& bullet : bullets) {
+        if (bullet.active) {
+            shadowCasterBounds.add(bullet.position, 0.5f * 0.05f);
+            shadowCasterModels.push_back(glm::scale(glm::translate(glm::mat4(1.0f), bullet.position), glm::vec3(0.05f)));
+        }
+    }
+}
+
+namespace {
+    // Order-independent combination of the casters a point light sees: each caster hashes on
+    // its own and the hashes are summed, so only moved, new or removed casters change the sum
+    uint64_t hashCaster(float x, float y, float z, float radius) {
+        float values[4] = { x, y, z, radius };
+        uint32_t bits[4];
+        std::memcpy(bits, values, sizeof(bits));
+        uint64_t hash = 1469598103934665603ull;
+        for (uint32_t word : bits) {
+            hash = (hash ^ word) * 1099511628211ull;
+        }
+        return hash ^ (hash >> 29);
+    }
+}
+
+void GraphicsManager::renderPointShadows(const glm::mat4& view, const glm::mat4& projection,
+                                         const std::vector<Cube>& cubes, const std::vector<Bullet>& bullets,
+                                         const glm::vec3& mainObjectPos) {
+    pointShadowRecords = 0;
+    if (!areShadowsEnabled() || pointLights.empty()) {
+        return;
+    }
+    // The atlas is only allocated once a scene has point lights
+    if (!pointShadows.isInitialized()) {
+        if (pointShadowsInitAttempted) {
+            return;
+        }
+        pointShadowsInitAttempted = true;
+        bool initialized = pointShadows.initialize(glState);
+        glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+        glViewport(0, 0, screenWidth, screenHeight);
+        if (!initialized) {
+            std::cerr << "Point shadow atlas unavailable - point lights stay unshadowed" << std::endl;
+            return;
+        }
+    }
+    CPU_PROFILE_SCOPE("Point shadows");
+    GpuProfileScope pointShadowScope(gpuProfiler, "Point shadows");
+
+    // Light 0 is the main light (cascades); the point lights follow it in the light buffer
+    gatherShadowCasters(cubes, bullets, mainObjectPos, true);
+    pointShadowCasters.assign(pointLights.size() + 1, PointShadowCaster());
+    for (size_t i = 0; i < pointLights.size(); i++) {
+        const PointLight& light = pointLights[i];
+        PointShadowCaster& caster = pointShadowCasters[i + 1];
+        caster.position = light.position;
+        caster.radius = light.radius;
+        caster.enabled = true;
+        for (size_t c = 0; c < shadowCasterBounds.size(); c++) {
+            glm::vec3 center(shadowCasterBounds.centerX[c], shadowCasterBounds.centerY[c], shadowCasterBounds.centerZ[c]);
+            float radius = shadowCasterBounds.radius[c];
+            if (glm::length(center - light.position) < light.radius + radius) {
+                caster.casterHash += hashCaster(center.x, center.y, center.z, radius);
+            }
+        }
+    }
+    pointShadows.scheduleUpdates(view, projection, static_cast<float>(screenHeight), pointShadowCasters, pointShadowUpdates);
+
+    if (!pointShadowUpdates.empty()) {
+        glm::mat4 floorModel = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.5f, 0.0f));
+        floorModel = glm::scale(floorModel, glm::vec3(20.0f, 0.1f, 20.0f));
+
+        glState.enable(GL_DEPTH_TEST);
+        glState.depthFunc(GL_LESS);
+        glState.enable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(2.0f, 4.0f);
+        glState.useProgram(depthPrepassShader);
+        GLint viewLocation = glGetUniformLocation(depthPrepassShader, "view");
+        GLint projectionLocation = glGetUniformLocation(depthPrepassShader, "projection");
+        GLint modelLocation = glGetUniformLocation(depthPrepassShader, "model");
+        const glm::mat4 identity(1.0f);
+        glUniformMatrix4fv(viewLocation, 1, GL_FALSE, &identity[0][0]);
+        PointShadowStats& stats = pointShadows.frameStats();
+
+        for (const PointShadowUpdate& update : pointShadowUpdates) {
+            for (int face = 0; face < PointShadowAtlas::FACE_COUNT; face++) {
+                pointShadows.beginFace(glState, update, face);
+                glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, &update.faceViewProjections[face][0][0]);
+
+                glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &floorModel[0][0]);
+                glState.bindVertexArray(floorVAO);
+                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+
+                Frustum frustum = FrustumCuller::extractFrustum(update.faceViewProjections[face]);
+                FrustumCuller::cullSpheres(frustum, shadowCasterBounds, shadowVisibleCasters);
+                glState.bindVertexArray(sphereVAO);
+                for (uint32_t caster : shadowVisibleCasters) {
+                    glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &shadowCasterModels[caster][0][0]);
+                    glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+                }
+                stats.casterDraws += static_cast<uint32_t>(shadowVisibleCasters.size());
+            }
+        }
+
+        pointShadows.endUpdates(glState);
+        glState.disable(GL_POLYGON_OFFSET_FILL);
+        glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+        glViewport(0, 0, screenWidth, screenHeight);
+    }
+
+    // Receivers read the tiles through one record per light, streamed like the lights themselves
+    pointShadows.buildShaderData(pointShadowCasters.size(), pointShadowData);
+    StreamingAllocation shadowData = streamingBuffer.upload(glState, pointShadowData.data(),
+                                                            pointShadowData.size() * sizeof(PointShadowData), storageBufferAlignment);
+    if (shadowData.buffer) {
+        glState.bindBufferRange(GL_SHADER_STORAGE_BUFFER_LOCAL, 3, shadowData.buffer, shadowData.offset, shadowData.size);
+        pointShadowRecords = static_cast<GLint>(pointShadowData.size());
+    }
+    pointShadows.bindTexture(glState, GL_TEXTURE0 + POINT_SHADOW_TEXTURE_UNIT);
+    glState.activeTexture(GL_TEXTURE0);
+}
+
 void GraphicsManager::performDepthPrepass(const glm::mat4& view, const glm::mat4& projection,
                                          const std::vector<RTSphere>& spheres,
                                          const std::vector<Cube>& cubes,
                                          const std::vector<Bullet>& bullets,
                                          const glm::vec3& mainObjectPos) {
-    // This function is currently unused in the simplified Forward+ approach
+    // Occluder-only depth prepass for Hi-Z culling: the floor and the main sphere are the
+    // large occluders; small objects (cubes, bullets) are tested against them, not drawn here
+    GpuProfileScope prepassScope(gpuProfiler, "Depth prepass + Hi-Z");
+    hiZReady = false;
+    if (!hiZOcclusionEnabled) {
+        return;
+    }
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, occlusionDepthFBO);
+    glViewport(0, 0, screenWidth, screenHeight);
+    glState.enable(GL_DEPTH_TEST);
+    glState.depthFunc(GL_LESS);
+    glState.depthMask(true);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    
+    glState.useProgram(depthPrepassShader);
+    glUniformMatrix4fv(glGetUniformLocation(depthPrepassShader, "view"), 1, GL_FALSE, &view[0][0]);
+    glUniformMatrix4fv(glGetUniformLocation(depthPrepassShader, "projection"), 1, GL_FALSE, &projection[0][0]);
+    
+    glm::mat4 floorModel = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.5f, 0.0f));
+    floorModel = glm::scale(floorModel, glm::vec3(20.0f, 0.1f, 20.0f));
+    glUniformMatrix4fv(glGetUniformLocation(depthPrepassShader, "model"), 1, GL_FALSE, &floorModel[0][0]);
+    glState.bindVertexArray(floorVAO);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    
+    glm::mat4 mainModel = glm::translate(glm::mat4(1.0f), mainObjectPos);
+    glUniformMatrix4fv(glGetUniformLocation(depthPrepassShader, "model"), 1, GL_FALSE, &mainModel[0][0]);
+    glState.bindVertexArray(sphereVAO);
+    glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+    glViewport(0, 0, screenWidth, screenHeight);
+    
+    buildHiZPyramid();
+    hiZReady = true;
 }
 
 void GraphicsManager::performLightCulling(const glm::mat4& view, const glm::mat4& projection) {
-    // Update light data (for now, just use the main light)
-    std::vector<glm::vec3> lightPositions = {currentLightPos};
-    std::vector<glm::vec3> lightColors = {currentLightColor};
-    updateLightData(lightPositions, lightColors);
+    // The main light first, then the scene's point lights
+    frameLights.clear();
+    frameLights.push_back({ currentLightPos, 10.0f, currentLightColor, 1.0f });
+    frameLights.insert(frameLights.end(), pointLights.begin(), pointLights.end());
+    updateLightData(frameLights);
     
     // Use light culling compute shader
-    glUseProgram(lightCullingComputeShader);
+    glState.useProgram(lightCullingComputeShader);
     
     // Set uniforms
     glUniformMatrix4fv(glGetUniformLocation(lightCullingComputeShader, "view"), 1, GL_FALSE, &view[0][0]);
     glUniformMatrix4fv(glGetUniformLocation(lightCullingComputeShader, "projection"), 1, GL_FALSE, &projection[0][0]);
+    glm::mat4 inverseProjection = glm::inverse(projection);
+    glUniformMatrix4fv(glGetUniformLocation(lightCullingComputeShader, "inverseProjection"), 1, GL_FALSE, &inverseProjection[0][0]);
     glUniform2i(glGetUniformLocation(lightCullingComputeShader, "screenSize"), screenWidth, screenHeight);
     glUniform2i(glGetUniformLocation(lightCullingComputeShader, "numTiles"), numTilesX, numTilesY);
-    glUniform1i(glGetUniformLocation(lightCullingComputeShader, "numLights"), static_cast<int>(lightPositions.size()));
+    glUniform1i(glGetUniformLocation(lightCullingComputeShader, "numLights"), static_cast<int>(frameLights.size()));
     
     // Bind depth texture (we don't have proper depth prepass, so this might be empty)
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glState.activeTexture(GL_TEXTURE0);
+    glState.bindTexture(GL_TEXTURE_2D, depthTexture);
     glUniform1i(glGetUniformLocation(lightCullingComputeShader, "depthTexture"), 0);
     
     // Dispatch compute shader (one thread group per tile)
@@ -1116,28 +3445,12 @@ void GraphicsManager::renderTiledObjects(const glm::mat4& view, const glm::mat4&
     // This function is replaced by the simplified approach in renderForwardPlusPass
 }
 
-void GraphicsManager::updateLightData(const std::vector<glm::vec3>& lightPositions, const std::vector<glm::vec3>& lightColors) {
-    struct LightData {
-        glm::vec3 position;
-        float radius;
-        glm::vec3 color;
-        float intensity;
-    };
-    
-    std::vector<LightData> lights;
-    for (size_t i = 0; i < lightPositions.size() && i < lightColors.size(); i++) {
-        LightData light;
-        light.position = lightPositions[i];
-        light.radius = 10.0f; // Default light radius
-        light.color = lightColors[i];
-        light.intensity = 1.0f; // Default intensity
-        lights.push_back(light);
+void GraphicsManager::updateLightData(const std::vector<PointLight>& lights) {
+    // Lights stream in every frame; binding 0 points at this frame's copy
+    StreamingAllocation lightData = streamingBuffer.upload(glState, lights.data(), lights.size() * sizeof(PointLight), storageBufferAlignment);
+    if (lightData.buffer) {
+        glState.bindBufferRange(GL_SHADER_STORAGE_BUFFER_LOCAL, 0, lightData.buffer, lightData.offset, lightData.size);
     }
-    
-    // Update light data buffer
-    const GLenum GL_SHADER_STORAGE_BUFFER_LOCAL = 0x90D2;
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER_LOCAL, lightDataBuffer);
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER_LOCAL, 0, lights.size() * sizeof(LightData), lights.data());
 }
 
 void GraphicsManager::renderModern(const std::vector<RTSphere>& spheres, const glm::vec3& cameraPos, 
@@ -1160,363 +3473,94 @@ void GraphicsManager::renderModern(const std::vector<RTSphere>& spheres, const g
     }
 }
 
-void GraphicsManager::initFPSDisplay() {
-    fpsDisplayInitialized = true;
-    
-    // Create VAO and VBO for FPS display quads
-    glGenVertexArrays(1, &fpsVAO);
-    glGenBuffers(1, &fpsVBO);
-    
-    glBindVertexArray(fpsVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, fpsVBO);
-    
-    // Reserve space for quad vertices (will be updated per frame)
-    // Using position (3D) + normal (3D) + texcoord (2D) to match existing vertex format
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 48, nullptr, GL_DYNAMIC_DRAW); // 6 vertices * 8 components
-    
-    // Position attribute (3D to match sphere shader)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // Normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // Texture coord attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-    
-    std::cout << "FPS display initialized successfully!" << std::endl;
-}
-
-void GraphicsManager::renderFPS(float fps, float deltaTime) {
-    if (!fpsDisplayInitialized) {
+void GraphicsManager::renderStatsOverlay(const OverlayStats& stats) {
+    if (!textOverlay.isInitialized()) {
         return;
     }
     
-    // Save current OpenGL state
-    GLboolean depthTestEnabled = glIsEnabled(GL_DEPTH_TEST);
-    GLboolean blendEnabled = glIsEnabled(GL_BLEND);
-    GLint currentProgram;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
-    
-    // Setup for overlay rendering
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    
-    // Use the main shader with orthographic projection for overlay
-    glUseProgram(mainShaderProgram);
-    
-    // Set up orthographic projection for 2D overlay
-    glm::mat4 orthoProjection = glm::ortho(0.0f, (float)screenWidth, 0.0f, (float)screenHeight, -1.0f, 1.0f);
-    glm::mat4 orthoView = glm::mat4(1.0f);
-    glm::mat4 orthoModel = glm::mat4(1.0f);
-    
-    glUniformMatrix4fv(glGetUniformLocation(mainShaderProgram, "projection"), 1, GL_FALSE, &orthoProjection[0][0]);
-    glUniformMatrix4fv(glGetUniformLocation(mainShaderProgram, "view"), 1, GL_FALSE, &orthoView[0][0]);
-    glUniformMatrix4fv(glGetUniformLocation(mainShaderProgram, "model"), 1, GL_FALSE, &orthoModel[0][0]);
-    
-    // Disable material mode and set up for colored rendering
-    glUniform1i(glGetUniformLocation(mainShaderProgram, "useMaterial"), 0);
-    glUniform1i(glGetUniformLocation(mainShaderProgram, "shadingModel"), 0);
-    
-    glBindVertexArray(fpsVAO);
-    
-    // Calculate FPS text position
-    float bgX = 10.0f;  // Top left instead of top right
-    float bgY = screenHeight - 50.0f;
-    float bgWidth = 150.0f;
-    float bgHeight = 40.0f;
-    
-    // Background quad (dark semi-transparent)
-    glUniform3f(glGetUniformLocation(mainShaderProgram, "objectColor"), 0.0f, 0.0f, 0.0f);
-    
-    float bgVertices[] = {
-        // Triangle 1
-        bgX,          bgY,          0.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f,
-        bgX + bgWidth, bgY,          0.0f,  0.0f, 0.0f, 1.0f,  1.0f, 0.0f,
-        bgX,          bgY + bgHeight, 0.0f,  0.0f, 0.0f, 1.0f,  0.0f, 1.0f,
-        
-        // Triangle 2
-        bgX + bgWidth, bgY,          0.0f,  0.0f, 0.0f, 1.0f,  1.0f, 0.0f,
-        bgX + bgWidth, bgY + bgHeight, 0.0f,  0.0f, 0.0f, 1.0f,  1.0f, 1.0f,
-        bgX,          bgY + bgHeight, 0.0f,  0.0f, 0.0f, 1.0f,  0.0f, 1.0f
+    CPU_PROFILE_SCOPE("Stats overlay");
+    GpuProfileScope overlayScope(gpuProfiler, "Overlay");
+    
+    // Everything below is queued into one vertex stream: panel, text lines, timing bars
+    const float lineHeight = TextOverlay::GLYPH_HEIGHT + 2.0f;
+    const float padding = 6.0f;
+    const float panelX = 10.0f;
+    const float panelY = 10.0f;
+    const float barX = panelX + padding + 34 * TextOverlay::GLYPH_WIDTH;
+    const float pixelsPerMs = 40.0f;
+    const float maxBarWidth = 80.0f;
+    const glm::vec4 headerColor(0.3f, 1.0f, 0.3f, 1.0f);
+    const glm::vec4 textColor(0.9f, 0.9f, 0.9f, 1.0f);
+    const glm::vec4 palette[] = {
+        glm::vec4(0.9f, 0.4f, 0.3f, 1.0f), glm::vec4(0.3f, 0.8f, 0.4f, 1.0f), glm::vec4(0.3f, 0.6f, 1.0f, 1.0f),
+        glm::vec4(1.0f, 0.8f, 0.2f, 1.0f), glm::vec4(0.8f, 0.4f, 0.9f, 1.0f), glm::vec4(0.3f, 0.9f, 0.9f, 1.0f)
     };
     
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(bgVertices), bgVertices);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    
-    // Render FPS text using simple colored quads for digits
-    // Convert FPS to integer and extract digits
-    int fpsInt = static_cast<int>(fps);
-    std::string fpsText = "FPS:" + std::to_string(fpsInt);
-    
-    // Render simple text representation using colored bars
-    float textX = bgX + 10.0f;
-    float textY = bgY + 10.0f;
-    float charWidth = 12.0f;
-    float charHeight = 20.0f;
-    float charSpacing = 2.0f;
-    
-    // Set text color (bright green for visibility)
-    glUniform3f(glGetUniformLocation(mainShaderProgram, "objectColor"), 0.0f, 1.0f, 0.0f);
-    
-    // Render simple digit bars - create a 7-segment style display for each digit
-    // For simplicity, we'll render bars that approximate the number
-    
-    // First render "FPS:" text using simple bars
-    float currentX = textX;
-    
-    // Render digits using a simple bar pattern
-    // We'll use a simplified approach: render vertical bars for each digit
-    std::string digits = std::to_string(fpsInt);
-    currentX += 35.0f; // Offset for "FPS:" label
-    
-    for (char digitChar : digits) {
-        int digit = digitChar - '0';
+    const std::vector<GpuScopeTiming>& timings = gpuProfiler.getTimings();
+    size_t lineCount = 3 + (gpuProfiler.isSupported() ? 1 + timings.size() : 0);
+    textOverlay.addRect(panelX, panelY, barX + maxBarWidth + padding - panelX, lineCount * lineHeight + 2.0f * padding,
+                        glm::vec4(0.0f, 0.0f, 0.0f, 0.6f));
+    
+    char line[96];
+    float x = panelX + padding;
+    float y = panelY + padding;
+    float frameTimeMs = stats.deltaTime * 1000.0f;
+    
+    std::snprintf(line, sizeof(line), "FPS %d  frame %.2f ms", static_cast<int>(stats.fps), frameTimeMs);
+    textOverlay.addText(x, y, line, headerColor);
+    y += lineHeight;
+    
+    std::snprintf(line, sizeof(line), "Objects %zu  Lights %zu", stats.objectCount, stats.lightCount);
+    textOverlay.addText(x, y, line, textColor);
+    y += lineHeight;
+    
+    const GLStateCacheStats& glStats = glState.getFrameStats();
+    std::snprintf(line, sizeof(line), "GL calls %u issued, %u filtered", glStats.issuedCalls, glStats.filteredCalls);
+    textOverlay.addText(x, y, line, textColor);
+    y += lineHeight;
+    
+    // Per-pass GPU timings in console order, children indented, with a bar per pass (1 ms = 40 px)
+    if (gpuProfiler.isSupported()) {
+        std::snprintf(line, sizeof(line), "GPU %.2f ms", gpuProfiler.getFrameAverageMs());
+        textOverlay.addText(x, y, line, headerColor);
+        y += lineHeight;
         
-        // Create a simple pattern for each digit (using 7-segment inspired layout)
-        // This is a simplified version - we'll render bars based on digit value
-        
-        // Render bars for this digit
-        renderDigit(digit, currentX, textY, charWidth, charHeight);
-        currentX += charWidth + charSpacing;
+        for (size_t i = 0; i < timings.size(); i++, y += lineHeight) {
+            const GpuScopeTiming& timing = timings[i];
+            std::snprintf(line, sizeof(line), "%*s%-*.*s%7.2f ms", timing.depth * 2, "",
+                          22 - timing.depth * 2, 22 - timing.depth * 2, timing.name, timing.averageMs);
+            textOverlay.addText(x, y, line, textColor);
+            
+            float barWidth = std::min(std::max(static_cast<float>(timing.averageMs) * pixelsPerMs, 2.0f), maxBarWidth);
+            textOverlay.addRect(barX, y + 3.0f, barWidth, lineHeight - 6.0f, palette[i % (sizeof(palette) / sizeof(palette[0]))]);
+        }
     }
     
-    // Also render frame time
-    float frameTimeMs = deltaTime * 1000.0f;
-    float timeY = bgY + 5.0f;
+    // Overlay state; the previous depth/blend/cull state is restored from the cache, no queries
+    bool depthTestEnabled = glState.isEnabled(GL_DEPTH_TEST);
+    bool blendEnabled = glState.isEnabled(GL_BLEND);
+    bool cullFaceEnabled = glState.isEnabled(GL_CULL_FACE);
+    glState.disable(GL_DEPTH_TEST);
+    glState.disable(GL_CULL_FACE);
+    glState.enable(GL_BLEND);
+    glState.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    
+    textOverlay.render(glState, streamingBuffer, screenWidth, screenHeight);
     
-    // Restore OpenGL state
-    glUseProgram(currentProgram);
-    if (depthTestEnabled) glEnable(GL_DEPTH_TEST);
-    if (!blendEnabled) glDisable(GL_BLEND);
+    if (depthTestEnabled) glState.enable(GL_DEPTH_TEST);
+    if (cullFaceEnabled) glState.enable(GL_CULL_FACE);
+    if (!blendEnabled) glState.disable(GL_BLEND);
     
     // Print FPS to console periodically for precise measurement
     static float printTimer = 0.0f;
-    printTimer += deltaTime;
+    printTimer += stats.deltaTime;
     if (printTimer >= 1.0f) { // Print every second
         std::string renderMode = "Legacy OpenGL";
         if (useVulkanRenderer) {
             renderMode = "Modern Vulkan (Forward+)";
         }
-        std::cout << "FPS: " << static_cast<int>(fps) << " | Frame time: " 
+        std::cout << "FPS: " << static_cast<int>(stats.fps) << " | Frame time: " 
                   << std::fixed << std::setprecision(2) << frameTimeMs << "ms | Renderer: " << renderMode << std::endl;
         printTimer = 0.0f;
     }
 }
-
-// Helper function to render a single digit using simple bar patterns
-void GraphicsManager::renderDigit(int digit, float x, float y, float width, float height) {
-    // Simple 7-segment display pattern
-    // Segments: top, top-right, bottom-right, bottom, bottom-left, top-left, middle
-    
-    float segmentThickness = 3.0f;
-    float segmentWidth = width - 2.0f;
-    float segmentHeight = (height - 4.0f) / 2.0f;
-    
-    // Define which segments are on for each digit (top, topR, bottomR, bottom, bottomL, topL, middle)
-    bool segments[10][7] = {
-        {1,1,1,1,1,1,0}, // 0
-        {0,1,1,0,0,0,0}, // 1
-        {1,1,0,1,1,0,1}, // 2
-        {1,1,1,1,0,0,1}, // 3
-        {0,1,1,0,0,1,1}, // 4
-        {1,0,1,1,0,1,1}, // 5
-        {1,0,1,1,1,1,1}, // 6
-        {1,1,1,0,0,0,0}, // 7
-        {1,1,1,1,1,1,1}, // 8
-        {1,1,1,1,0,1,1}  // 9
-    };
-    
-    if (digit < 0 || digit > 9) return;
-    
-    // Render each segment
-    float vertices[48]; // 6 vertices * 8 components for each segment
-    
-    // Top segment
-    if (segments[digit][0]) {
-        float topY = y + height - segmentThickness;
-        vertices[0] = x; vertices[1] = topY; vertices[2] = 0.0f; 
-        vertices[3] = 0.0f; vertices[4] = 0.0f; vertices[5] = 1.0f; vertices[6] = 0.0f; vertices[7] = 0.0f;
-        
-        vertices[8] = x + segmentWidth; vertices[9] = topY; vertices[10] = 0.0f;
-        vertices[11] = 0.0f; vertices[12] = 0.0f; vertices[13] = 1.0f; vertices[14] = 1.0f; vertices[15] = 0.0f;
-        
-        vertices[16] = x; vertices[17] = y + height; vertices[18] = 0.0f;
-        vertices[19] = 0.0f; vertices[20] = 0.0f; vertices[21] = 1.0f; vertices[22] = 0.0f; vertices[23] = 1.0f;
-        
-        vertices[24] = x + segmentWidth; vertices[25] = topY; vertices[26] = 0.0f;
-        vertices[27] = 0.0f; vertices[28] = 0.0f; vertices[29] = 1.0f; vertices[30] = 1.0f; vertices[31] = 0.0f;
-        
-        vertices[32] = x + segmentWidth; vertices[33] = y + height; vertices[34] = 0.0f;
-        vertices[35] = 0.0f; vertices[36] = 0.0f; vertices[37] = 1.0f; vertices[38] = 1.0f; vertices[39] = 1.0f;
-        
-        vertices[40] = x; vertices[41] = y + height; vertices[42] = 0.0f;
-        vertices[43] = 0.0f; vertices[44] = 0.0f; vertices[45] = 1.0f; vertices[46] = 0.0f; vertices[47] = 1.0f;
-        
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-    }
-    
-    // Top-right segment
-    if (segments[digit][1]) {
-        float segX = x + segmentWidth - segmentThickness;
-        float segYTop = y + height / 2.0f + 1.0f;
-        float segYBottom = y + height;
-        
-        vertices[0] = segX; vertices[1] = segYTop; vertices[2] = 0.0f;
-        vertices[3] = 0.0f; vertices[4] = 0.0f; vertices[5] = 1.0f; vertices[6] = 0.0f; vertices[7] = 0.0f;
-        
-        vertices[8] = x + segmentWidth; vertices[9] = segYTop; vertices[10] = 0.0f;
-        vertices[11] = 0.0f; vertices[12] = 0.0f; vertices[13] = 1.0f; vertices[14] = 1.0f; vertices[15] = 0.0f;
-        
-        vertices[16] = segX; vertices[17] = segYBottom; vertices[18] = 0.0f;
-        vertices[19] = 0.0f; vertices[20] = 0.0f; vertices[21] = 1.0f; vertices[22] = 0.0f; vertices[23] = 1.0f;
-        
-        vertices[24] = x + segmentWidth; vertices[25] = segYTop; vertices[26] = 0.0f;
-        vertices[27] = 0.0f; vertices[28] = 0.0f; vertices[29] = 1.0f; vertices[30] = 1.0f; vertices[31] = 0.0f;
-        
-        vertices[32] = x + segmentWidth; vertices[33] = segYBottom; vertices[34] = 0.0f;
-        vertices[35] = 0.0f; vertices[36] = 0.0f; vertices[37] = 1.0f; vertices[38] = 1.0f; vertices[39] = 1.0f;
-        
-        vertices[40] = segX; vertices[41] = segYBottom; vertices[42] = 0.0f;
-        vertices[43] = 0.0f; vertices[44] = 0.0f; vertices[45] = 1.0f; vertices[46] = 0.0f; vertices[47] = 1.0f;
-        
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-    }
-    
-    // Bottom-right segment
-    if (segments[digit][2]) {
-        float segX = x + segmentWidth - segmentThickness;
-        float segYTop = y;
-        float segYBottom = y + height / 2.0f - 1.0f;
-        
-        vertices[0] = segX; vertices[1] = segYTop; vertices[2] = 0.0f;
-        vertices[3] = 0.0f; vertices[4] = 0.0f; vertices[5] = 1.0f; vertices[6] = 0.0f; vertices[7] = 0.0f;
-        
-        vertices[8] = x + segmentWidth; vertices[9] = segYTop; vertices[10] = 0.0f;
-        vertices[11] = 0.0f; vertices[12] = 0.0f; vertices[13] = 1.0f; vertices[14] = 1.0f; vertices[15] = 0.0f;
-        
-        vertices[16] = segX; vertices[17] = segYBottom; vertices[18] = 0.0f;
-        vertices[19] = 0.0f; vertices[20] = 0.0f; vertices[21] = 1.0f; vertices[22] = 0.0f; vertices[23] = 1.0f;
-        
-        vertices[24] = x + segmentWidth; vertices[25] = segYTop; vertices[26] = 0.0f;
-        vertices[27] = 0.0f; vertices[28] = 0.0f; vertices[29] = 1.0f; vertices[30] = 1.0f; vertices[31] = 0.0f;
-        
-        vertices[32] = x + segmentWidth; vertices[33] = segYBottom; vertices[34] = 0.0f;
-        vertices[35] = 0.0f; vertices[36] = 0.0f; vertices[37] = 1.0f; vertices[38] = 1.0f; vertices[39] = 1.0f;
-        
-        vertices[40] = segX; vertices[41] = segYBottom; vertices[42] = 0.0f;
-        vertices[43] = 0.0f; vertices[44] = 0.0f; vertices[45] = 1.0f; vertices[46] = 0.0f; vertices[47] = 1.0f;
-        
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-    }
-    
-    // Bottom segment
-    if (segments[digit][3]) {
-        float topY = y;
-        vertices[0] = x; vertices[1] = topY; vertices[2] = 0.0f;
-        vertices[3] = 0.0f; vertices[4] = 0.0f; vertices[5] = 1.0f; vertices[6] = 0.0f; vertices[7] = 0.0f;
-        
-        vertices[8] = x + segmentWidth; vertices[9] = topY; vertices[10] = 0.0f;
-        vertices[11] = 0.0f; vertices[12] = 0.0f; vertices[13] = 1.0f; vertices[14] = 1.0f; vertices[15] = 0.0f;
-        
-        vertices[16] = x; vertices[17] = topY + segmentThickness; vertices[18] = 0.0f;
-        vertices[19] = 0.0f; vertices[20] = 0.0f; vertices[21] = 1.0f; vertices[22] = 0.0f; vertices[23] = 1.0f;
-        
-        vertices[24] = x + segmentWidth; vertices[25] = topY; vertices[26] = 0.0f;
-        vertices[27] = 0.0f; vertices[28] = 0.0f; vertices[29] = 1.0f; vertices[30] = 1.0f; vertices[31] = 0.0f;
-        
-        vertices[32] = x + segmentWidth; vertices[33] = topY + segmentThickness; vertices[34] = 0.0f;
-        vertices[35] = 0.0f; vertices[36] = 0.0f; vertices[37] = 1.0f; vertices[38] = 1.0f; vertices[39] = 1.0f;
-        
-        vertices[40] = x; vertices[41] = topY + segmentThickness; vertices[42] = 0.0f;
-        vertices[43] = 0.0f; vertices[44] = 0.0f; vertices[45] = 1.0f; vertices[46] = 0.0f; vertices[47] = 1.0f;
-        
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-    }
-    
-    // Bottom-left segment
-    if (segments[digit][4]) {
-        float segX = x;
-        float segYTop = y;
-        float segYBottom = y + height / 2.0f - 1.0f;
-        
-        vertices[0] = segX; vertices[1] = segYTop; vertices[2] = 0.0f;
-        vertices[3] = 0.0f; vertices[4] = 0.0f; vertices[5] = 1.0f; vertices[6] = 0.0f; vertices[7] = 0.0f;
-        
-        vertices[8] = segX + segmentThickness; vertices[9] = segYTop; vertices[10] = 0.0f;
-        vertices[11] = 0.0f; vertices[12] = 0.0f; vertices[13] = 1.0f; vertices[14] = 1.0f; vertices[15] = 0.0f;
-        
-        vertices[16] = segX; vertices[17] = segYBottom; vertices[18] = 0.0f;
-        vertices[19] = 0.0f; vertices[20] = 0.0f; vertices[21] = 1.0f; vertices[22] = 0.0f; vertices[23] = 1.0f;
-        
-        vertices[24] = segX + segmentThickness; vertices[25] = segYTop; vertices[26] = 0.0f;
-        vertices[27] = 0.0f; vertices[28] = 0.0f; vertices[29] = 1.0f; vertices[30] = 1.0f; vertices[31] = 0.0f;
-        
-        vertices[32] = segX + segmentThickness; vertices[33] = segYBottom; vertices[34] = 0.0f;
-        vertices[35] = 0.0f; vertices[36] = 0.0f; vertices[37] = 1.0f; vertices[38] = 1.0f; vertices[39] = 1.0f;
-        
-        vertices[40] = segX; vertices[41] = segYBottom; vertices[42] = 0.0f;
-        vertices[43] = 0.0f; vertices[44] = 0.0f; vertices[45] = 1.0f; vertices[46] = 0.0f; vertices[47] = 1.0f;
-        
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-    }
-    
-    // Top-left segment
-    if (segments[digit][5]) {
-        float segX = x;
-        float segYTop = y + height / 2.0f + 1.0f;
-        float segYBottom = y + height;
-        
-        vertices[0] = segX; vertices[1] = segYTop; vertices[2] = 0.0f;
-        vertices[3] = 0.0f; vertices[4] = 0.0f; vertices[5] = 1.0f; vertices[6] = 0.0f; vertices[7] = 0.0f;
-        
-        vertices[8] = segX + segmentThickness; vertices[9] = segYTop; vertices[10] = 0.0f;
-        vertices[11] = 0.0f; vertices[12] = 0.0f; vertices[13] = 1.0f; vertices[14] = 1.0f; vertices[15] = 0.0f;
-        
-        vertices[16] = segX; vertices[17] = segYBottom; vertices[18] = 0.0f;
-        vertices[19] = 0.0f; vertices[20] = 0.0f; vertices[21] = 1.0f; vertices[22] = 0.0f; vertices[23] = 1.0f;
-        
-        vertices[24] = segX + segmentThickness; vertices[25] = segYTop; vertices[26] = 0.0f;
-        vertices[27] = 0.0f; vertices[28] = 0.0f; vertices[29] = 1.0f; vertices[30] = 1.0f; vertices[31] = 0.0f;
-        
-        vertices[32] = segX + segmentThickness; vertices[33] = segYBottom; vertices[34] = 0.0f;
-        vertices[35] = 0.0f; vertices[36] = 0.0f; vertices[37] = 1.0f; vertices[38] = 1.0f; vertices[39] = 1.0f;
-        
-        vertices[40] = segX; vertices[41] = segYBottom; vertices[42] = 0.0f;
-        vertices[43] = 0.0f; vertices[44] = 0.0f; vertices[45] = 1.0f; vertices[46] = 0.0f; vertices[47] = 1.0f;
-        
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-    }
-    
-    // Middle segment
-    if (segments[digit][6]) {
-        float midY = y + height / 2.0f - segmentThickness / 2.0f;
-        vertices[0] = x; vertices[1] = midY; vertices[2] = 0.0f;
-        vertices[3] = 0.0f; vertices[4] = 0.0f; vertices[5] = 1.0f; vertices[6] = 0.0f; vertices[7] = 0.0f;
-        
-        vertices[8] = x + segmentWidth; vertices[9] = midY; vertices[10] = 0.0f;
-        vertices[11] = 0.0f; vertices[12] = 0.0f; vertices[13] = 1.0f; vertices[14] = 1.0f; vertices[15] = 0.0f;
-        
-        vertices[16] = x; vertices[17] = midY + segmentThickness; vertices[18] = 0.0f;
-        vertices[19] = 0.0f; vertices[20] = 0.0f; vertices[21] = 1.0f; vertices[22] = 0.0f; vertices[23] = 1.0f;
-        
-        vertices[24] = x + segmentWidth; vertices[25] = midY; vertices[26] = 0.0f;
-        vertices[27] = 0.0f; vertices[28] = 0.0f; vertices[29] = 1.0f; vertices[30] = 1.0f; vertices[31] = 0.0f;
-        
-        vertices[32] = x + segmentWidth; vertices[33] = midY + segmentThickness; vertices[34] = 0.0f;
-        vertices[35] = 0.0f; vertices[36] = 0.0f; vertices[37] = 1.0f; vertices[38] = 1.0f; vertices[39] = 1.0f;
-        
-        vertices[40] = x; vertices[41] = midY + segmentThickness; vertices[42] = 0.0f;
-        vertices[43] = 0.0f; vertices[44] = 0.0f; vertices[45] = 1.0f; vertices[46] = 0.0f; vertices[47] = 1.0f;
-        
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-    }
-}
\ No newline at end of file
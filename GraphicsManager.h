@@ -5,6 +5,16 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include <string>
+#include "FrustumCuller.h"
+#include "RenderQueue.h"
+#include "GLStateCache.h"
+#include "GpuProfiler.h"
+#include "TextOverlay.h"
+#include "FrameCapture.h"
+#include "StreamingBuffer.h"
+#include "CascadedShadowMaps.h"
+#include "PointShadowAtlas.h"
+#include "BlueNoise.h"
 
 // Forward declarations
 struct Material;
@@ -15,8 +25,43 @@ struct Bullet;
 
 // OpenGL function pointers for compute shaders (in case GLAD doesn't load them)
 typedef void (APIENTRY *PFNGLDISPATCHCOMPUTEPROC)(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z);
+typedef void (APIENTRY *PFNGLDISPATCHCOMPUTEINDIRECTPROC)(GLintptr indirect);
 typedef void (APIENTRY *PFNGLBINDIMAGETEXTUREPROC)(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format);
 typedef void (APIENTRY *PFNGLMEMORYBARRIERPROC)(GLbitfield barriers);
+typedef void (APIENTRY *PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+typedef void (APIENTRY *PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC)(GLenum mode, GLenum type, const void* indirect, GLintptr drawcount, GLsizei maxdrawcount, GLsizei stride);
+typedef void (APIENTRY *PFNGLCLEARBUFFERDATAPROC)(GLenum target, GLenum internalformat, GLenum format, GLenum type, const void* data);
+
+// Random number source of the path tracer; values match the SAMPLER_* constants in sampler.glsl
+enum class RaytracingSampler {
+    WhiteNoise = 0,
+    Sobol = 1,
+    BlueNoise = 2
+};
+
+// Per-frame results of the GPU culling pass (read back a few frames late)
+struct OcclusionCullingStats {
+    uint32_t objectCount = 0;
+    uint32_t visibleCount = 0;
+    uint32_t frustumCulledCount = 0;
+    uint32_t occludedCount = 0;
+};
+
+// A point light of the tiled path, in the std430 layout of the light buffer
+struct PointLight {
+    glm::vec3 position;
+    float radius;
+    glm::vec3 color;
+    float intensity;
+};
+
+// Scene figures shown by the stats overlay
+struct OverlayStats {
+    float fps = 0.0f;
+    float deltaTime = 0.0f;
+    size_t objectCount = 0;
+    size_t lightCount = 0;
+};
 
 class GraphicsManager {
 public:
@@ -26,14 +71,19 @@ public:
     // Initialization
     bool initialize(unsigned int width, unsigned int height);
     void cleanup();
+    
+    // Resolves the GL 4.x entry points missing from the GLAD header; GLFW's by default,
+    // headless runs set the EGL one before initialize()
+    static void setProcAddressLoader(GLADloadproc loader) { procAddressLoader = loader; }
 
     // Shader management
     GLuint loadShaders(const char* vertex_file_path, const char* fragment_file_path);
     GLuint loadComputeShader(const char* compute_file_path);
 
     // Mesh creation
-    void createSphereMesh(std::vector<float>& vertices, std::vector<unsigned int>& indices, float radius, int segments);
-    void createFloorMesh(std::vector<float>& vertices, std::vector<unsigned int>& indices);
+    static void createSphereMesh(std::vector<float>& vertices, std::vector<unsigned int>& indices, float radius, int segments);
+    static void createFloorMesh(std::vector<float>& vertices, std::vector<unsigned int>& indices);
+    void optimizeMesh(const char* name, std::vector<float>& vertices, std::vector<unsigned int>& indices, size_t vertexStride);
 
     // Rendering
     void beginFrame();
@@ -90,6 +140,92 @@ public:
                         const glm::vec3& cameraFront, const glm::vec3& cameraUp, const glm::vec3& cameraRight,
                         const glm::vec3& lightPos, const glm::vec3& lightColor, float time,
                         int maxBounces, int numSamples, float exposure, bool enableToneMapping);
+    // Blue noise falls back to Sobol if its texture could not be created
+    void setRaytracingSampler(RaytracingSampler sampler);
+    RaytracingSampler getRaytracingSampler() const { return raytracingSampler; }
+    // A-trous iterations filtering the traced image (0 shows the raw samples), clamped to 0-5
+    void setDenoiseIterations(int iterations);
+    int getDenoiseIterations() const { return denoiserAvailable() ? denoiseIterations : 0; }
+    // Adaptive sampling: a base pass of a quarter of the samples (at least 2), then more only in
+    // the 16x16 tiles whose estimated tone-mapped RMSE is above the threshold, as many as bring
+    // it down to the threshold and at most up to numSamples; 0 traces all samples everywhere
+    void setAdaptiveErrorThreshold(float threshold);
+    float getAdaptiveErrorThreshold() const { return adaptiveErrorThreshold; }
+    // Persistent threads: this many work groups pull the 16x16 tiles from an atomic queue in
+    // Morton order; 0 dispatches one work group per tile, row by row
+    void setRaytracingPersistentGroups(int workGroups);
+    int getRaytracingPersistentGroups() const { return persistentWorkGroups; }
+    // RMSE vs spp of BSDF-only, NEE-only and NEE+MIS path tracing, of each sampler, of adaptive
+    // sampling and of the denoiser at 1 spp against a high-spp reference; false if the NEE+MIS
+    // error stops falling or Sobol and blue noise do not beat white noise
+    bool runRaytracingNoiseBenchmark(int maxSamples);
+    // Frame time of the row-major grid against persistent threads on scenes of uneven material
+    // cost; false if the dispatches' images differ
+    bool runRaytracingDispatchBenchmark(int frames);
+
+    // Ray-cast sphere impostors (one instanced quad per sphere instead of a tessellated mesh)
+    void setSphereImpostorsEnabled(bool enabled) { sphereImpostorsEnabled = enabled && impostorShader != 0; }
+    bool areSphereImpostorsEnabled() const { return sphereImpostorsEnabled; }
+    void renderSphereImpostors(const glm::mat4& view, const glm::mat4& projection, const std::vector<RTSphere>& spheres);
+    void runSphereBenchmark(int sphereCount, int frames);
+
+    // GPU-driven frustum culling (compute pass writes indirect draws, one multi-draw call)
+    bool isGpuCullingSupported() const { return gpuCullingSupported; }
+    void setGpuCullingEnabled(bool enabled) { gpuCullingEnabled = enabled && gpuCullingSupported; }
+    bool isGpuCullingEnabled() const { return gpuCullingEnabled; }
+    void renderGpuCulledSpheres(const glm::mat4& view, const glm::mat4& projection, const std::vector<RTSphere>& spheres);
+    bool runCullingValidation(int sphereCount);
+    
+    // Hi-Z occlusion culling on top of GPU-driven culling (occluder depth prepass + depth pyramid)
+    bool isHiZOcclusionSupported() const { return hiZSupported; }
+    void setHiZOcclusionEnabled(bool enabled) { hiZOcclusionEnabled = enabled && hiZSupported; }
+    bool isHiZOcclusionEnabled() const { return hiZOcclusionEnabled; }
+    const OcclusionCullingStats& getOcclusionStats() const { return occlusionStats; }
+    
+    // Weighted blended order-independent transparency (glass spheres in one unsorted pass)
+    bool isOITSupported() const { return oitSupported; }
+    void renderTransparentSpheres(const glm::mat4& view, const glm::mat4& projection, const std::vector<RTSphere>& spheres);
+    void runTransparencyBenchmark(int maxInstances, int frames);
+    
+    // State switches of the last sorted opaque submission
+    const RenderQueueStats& getRenderQueueStats() const { return renderQueueStats; }
+    
+    // Issued vs. filtered GL state calls of the last frame (see GLStateCache)
+    const GLStateCacheStats& getGLStateStats() const { return glState.getFrameStats(); }
+    
+    // Per-frame dynamic uploads through the streaming buffer (bytes, MB/s, fence waits)
+    const StreamingBufferStats& getStreamingStats() const { return streamingBuffer.getStats(); }
+    bool isStreamingPersistent() const { return streamingBuffer.isPersistent(); }
+    
+    // Per-pass GPU timings (timestamp queries, read back a few frames late)
+    const GpuProfiler& getGpuProfiler() const { return gpuProfiler; }
+    void resetGpuTimingTotals() { gpuProfiler.resetTotals(); }
+    
+    // Framebuffer that stands in for the window's (the headless FBO); 0 is the window
+    void setOutputFramebuffer(GLuint framebuffer);
+    
+    // Asynchronous capture of the output framebuffer (see FrameCapture); captureFrame() queues
+    // the current contents, stopFrameCapture() flushes everything to disk
+    bool startFrameCapture(const std::string& path, int frameRate);
+    void captureFrame();
+    void stopFrameCapture();
+    
+    // Cascaded shadow maps of the main light in the raster paths (forward, forward+, impostors)
+    void setShadowsEnabled(bool enabled) { shadowsEnabled = enabled; }
+    bool areShadowsEnabled() const { return shadowsEnabled && shadowMaps.isInitialized(); }
+    const ShadowStats& getShadowStats() const { return shadowMaps.getStats(); }
+    
+    // Point lights added to the main light in the Forward+ path, shadowed through the atlas
+    // with at most budget tiles redrawn per frame
+    void setPointLights(const std::vector<PointLight>& lights) { pointLights = lights; }
+    size_t getPointLightCount() const { return pointLights.size(); }
+    void setPointShadowBudget(int tiles) { pointShadows.setUpdateBudget(tiles); }
+    bool arePointShadowsActive() const { return areShadowsEnabled() && pointShadows.isInitialized() && !pointLights.empty(); }
+    const PointShadowStats& getPointShadowStats() const { return pointShadows.getStats(); }
+    
+    // Forward+ is off by default; initializes it on request (needs compute support)
+    bool enableForwardPlus();
+    bool isForwardPlusEnabled() const { return forwardPlusSupported; }
 
     // Lighting
     void setLightProperties(const glm::vec3& lightPos, const glm::vec3& lightColor);
@@ -98,10 +234,8 @@ public:
     bool isRaytracingSupported() const { return raytracingSupported; }
     int getSphereIndexCount() const { return sphereIndexCount; }
     
-    // FPS display
-    void renderFPS(float fps, float deltaTime);
-    void initFPSDisplay();
-    void renderDigit(int digit, float x, float y, float width, float height);
+    // Stats overlay: frame time, counts and per-pass GPU timings in a single draw call
+    void renderStatsOverlay(const OverlayStats& stats);
 
     // Modern renderer integration
     bool useModernRenderer() const { return useVulkanRenderer; }
@@ -134,8 +268,66 @@ private:
     GLuint depthTexture;
     GLuint lightListBuffer;
     GLuint visibleLightIndicesBuffer;
-    GLuint lightDataBuffer;
     bool forwardPlusSupported;
+    GLuint outputFramebuffer;
+    
+    // Sphere impostor resources
+    GLuint impostorShader;
+    GLuint impostorVAO, impostorQuadVBO;
+    bool sphereImpostorsEnabled;
+    
+    // GPU-driven culling resources
+    GLuint gpuCullingComputeShader;
+    GLuint gpuDrivenShader;
+    GLuint gpuDrivenVAO;
+    GLuint drawCommandBuffer, drawCountBuffer;
+    StreamingAllocation cullObjectData;    // this frame's objects, read by the culling shader and as instance data
+    size_t cullObjectCapacity;
+    bool gpuCullingSupported;
+    bool gpuCullingEnabled;
+    
+    // Hi-Z occlusion culling resources
+    static const int STATS_READBACK_FRAMES = 3;
+    GLuint hiZDownsampleShader;
+    GLuint occlusionDepthFBO, occlusionDepthTexture;
+    GLuint hiZTexture;
+    int hiZWidth, hiZHeight, hiZLevels;
+    bool hiZSupported;
+    bool hiZOcclusionEnabled;
+    bool hiZReady;
+    GLuint statsReadbackBuffers[STATS_READBACK_FRAMES];
+    GLsync statsFences[STATS_READBACK_FRAMES];
+    uint32_t statsObjectCounts[STATS_READBACK_FRAMES];
+    int statsFrameIndex;
+    OcclusionCullingStats occlusionStats;
+    
+    // Weighted blended OIT resources
+    GLuint oitAccumulateShader, oitCompositeShader;
+    GLuint oitFBO, oitAccumulationTexture, oitWeightTexture, oitDepthRenderbuffer;
+    GLuint oitVAO, oitCompositeVAO;
+    bool oitSupported;
+    bool oitDepthCopyVerified, oitDepthCopySupported;
+    std::vector<RTSphere> transparentSpheres;
+    
+    // CPU frustum culling for the per-object mesh path
+    enum class CulledObjectKind { MainSphere, Cube, Bullet };
+    struct CulledObject {
+        CulledObjectKind kind;
+        uint32_t index;
+    };
+    SphereBounds cpuCullBounds;
+    std::vector<CulledObject> cpuCullObjects;
+    std::vector<uint32_t> cpuVisibleObjects;
+    
+    // Shadowed GL state; every binding and fixed-function state change goes through it
+    GLStateCache glState;
+    
+    // GPU pass timings shown in the overlay
+    GpuProfiler gpuProfiler;
+    
+    // Sorted opaque submission for the per-object mesh path
+    RenderQueue opaqueQueue;
+    RenderQueueStats renderQueueStats;
     
     // Tiling parameters
     static const int TILE_SIZE = 16;
@@ -154,28 +346,160 @@ private:
     
     // OpenGL function pointers
     PFNGLDISPATCHCOMPUTEPROC pglDispatchCompute;
+    PFNGLDISPATCHCOMPUTEINDIRECTPROC pglDispatchComputeIndirect;
     PFNGLBINDIMAGETEXTUREPROC pglBindImageTexture;
     PFNGLMEMORYBARRIERPROC pglMemoryBarrier;
+    PFNGLMULTIDRAWELEMENTSINDIRECTPROC pglMultiDrawElementsIndirect;
+    PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC pglMultiDrawElementsIndirectCount;
+    PFNGLCLEARBUFFERDATAPROC pglClearBufferData;
+    
+    // Batched text and bars for the stats overlay
+    TextOverlay textOverlay;
+    
+    // PBO ring readback for --capture
+    FrameCapture frameCapture;
+    
+    // Main light shadows: cached static layers plus dynamic casters redrawn on a staggered schedule
+    static const GLint SHADOW_TEXTURE_UNIT = 4;
+    CascadedShadowMaps shadowMaps;
+    bool shadowsEnabled;
+    std::vector<ShadowCascadeUpdate> shadowUpdates;
+    SphereBounds shadowCasterBounds;          // dynamic casters, culled per cascade
+    std::vector<glm::mat4> shadowCasterModels;
+    std::vector<uint32_t> shadowVisibleCasters;
+    glm::vec3 lastMainObjectPos;
+    bool mainSphereStatic;                     // at rest, so it lives in the cached static layers
+    bool initShadowMaps();
+    void renderShadowMaps(const glm::mat4& view, const glm::mat4& projection,
+                          const std::vector<Cube>& cubes, const std::vector<Bullet>& bullets,
+                          const glm::vec3& mainObjectPos);
+    void setShadowUniforms(GLuint program);
     
-    // FPS display
-    GLuint fpsShaderProgram;
-    GLuint fpsVAO, fpsVBO;
-    bool fpsDisplayInitialized;
+    // Point light shadows: atlas tiles handed out by screen size, redrawn within a budget
+    static const GLint POINT_SHADOW_TEXTURE_UNIT = 5;
+    PointShadowAtlas pointShadows;
+    bool pointShadowsInitAttempted;
+    std::vector<PointLight> pointLights;
+    std::vector<PointLight> frameLights;            // main light first, then the point lights
+    std::vector<PointShadowCaster> pointShadowCasters;
+    std::vector<PointShadowUpdate> pointShadowUpdates;
+    std::vector<PointShadowData> pointShadowData;
+    GLint pointShadowRecords;                       // records bound for this frame's receivers
+    void gatherShadowCasters(const std::vector<Cube>& cubes, const std::vector<Bullet>& bullets,
+                             const glm::vec3& mainObjectPos, bool includeMainSphere);
+    void renderPointShadows(const glm::mat4& view, const glm::mat4& projection,
+                            const std::vector<Cube>& cubes, const std::vector<Bullet>& bullets,
+                            const glm::vec3& mainObjectPos);
+    
+    // Per-frame dynamic data: instances, lights, overlay vertices
+    static const GLsizeiptr STREAMING_REGION_SIZE = 4 * 1024 * 1024;
+    StreamingBuffer streamingBuffer;
+    GLint storageBufferAlignment;
+    // Points vec4Count consecutive vec4 attributes from firstLocation at a streamed allocation (VAO bound)
+    void bindInstanceAttributes(const StreamingAllocation& allocation, GLuint firstLocation, int vec4Count, GLsizei stride);
     
     // Modern renderer (Vulkan-based Forward+ with Ray Tracing)
     // std::unique_ptr<class ModernRenderer> modernRenderer_;
     bool useVulkanRenderer;
     
+    // Path tracer inputs; the light sampling strategies match raytracing.comp
+    static const int LIGHT_SAMPLING_BSDF = 0;
+    static const int LIGHT_SAMPLING_NEE = 1;
+    static const int LIGHT_SAMPLING_MIS = 2;
+    uint32_t raytracingFrameIndex;    // seeds the per-frame random numbers
+    RaytracingSampler raytracingSampler;
+    static const GLint BLUE_NOISE_TEXTURE_UNIT = 6;
+    BlueNoiseTexture blueNoise;
+    
+    // Denoiser: the trace writes linear radiance into color[0] and its first-hit features
+    // alongside, then denoise_atrous.comp ping-pongs between color[0] and color[1] with the last
+    // iteration writing the displayed texture
+    struct DenoiseTargets {
+        GLuint color[2] = { 0, 0 };    // RGBA32F
+        GLuint normalDepth = 0;        // RGBA16F, normal and hit distance
+        GLuint albedo = 0;             // RGBA16F
+    };
+    static const int MAX_DENOISE_ITERATIONS = 5;
+    GLuint denoiseShader;
+    DenoiseTargets denoiseTargets;
+    int denoiseIterations;
+    bool denoiserAvailable() const { return denoiseShader != 0 && denoiseTargets.color[0] != 0; }
+    bool initDenoiser();
+    void cleanupDenoiser();
+    bool createDenoiseTargets(int width, int height, DenoiseTargets& targets);
+    void destroyDenoiseTargets(DenoiseTargets& targets);
+    // Image units 0-2 of raytracing.comp: radiance, normal and depth, albedo
+    void bindDenoiseTargets(const DenoiseTargets& targets);
+    void runDenoiser(const DenoiseTargets& targets, int iterations, GLuint output, bool outputLinear);
+    
+    // Adaptive sampling: the tile list raytracing.comp appends to, led by the refinement pass's
+    // indirect dispatch arguments, sized for the screen
+    static const GLuint ADAPTIVE_TILE_BINDING = 6;
+    GLuint adaptiveTileBuffer;
+    float adaptiveErrorThreshold;
+    bool initAdaptiveSampling();
+    static int adaptiveBaseSamples(int numSamples);
+    // Traces into image unit 0 with the other raytracing uniforms set; adaptively if the
+    // threshold is above 0 and numSamples leaves samples over after the base pass
+    void dispatchRaytrace(int width, int height, int numSamples, float errorThreshold);
+    
+    // Persistent threads: the queue head raytracing.comp pops tiles with, then the tiles of a
+    // tileQueueWidth x tileQueueHeight image in Morton order
+    static const GLuint TILE_QUEUE_BINDING = 7;
+    // Tiles a persistent work group takes per dispatch before it exits
+    static const GLuint PERSISTENT_TILES_PER_GROUP = 16;
+    GLuint tileQueueBuffer;
+    int tileQueueWidth;
+    int tileQueueHeight;
+    int persistentWorkGroups;
+    // Rebuilds the tile order when the image size changes and resets the queue head
+    void prepareTileQueue(int width, int height);
+    // The pass over all tiles: a grid of work groups or the persistent ones
+    void dispatchTiles(int width, int height);
+    
+    void setRaytracingUniforms(const std::vector<RTSphere>& spheres, const glm::vec3& cameraPos,
+                               const glm::vec3& cameraFront, const glm::vec3& cameraUp, const glm::vec3& cameraRight,
+                               const glm::vec3& lightPos, const glm::vec3& lightColor, float time,
+                               int maxBounces, int numSamples);
+    
     // Helper functions
     void setupSphereBuffers(const std::vector<float>& vertices, const std::vector<unsigned int>& indices);
     void setupFloorBuffers(const std::vector<float>& vertices, const std::vector<unsigned int>& indices);
     bool checkComputeShaderSupport();
     void setMaterialUniforms(GLuint program, const Material& material, bool useEnhancedFeatures);
     bool loadComputeShaderFunctions();
+    bool initSphereImpostors();
+    bool hasExtension(const char* name) const;
+    static GLADloadproc procAddressLoader;
+    
+    // GPU-driven culling helpers
+    bool initGpuCulling();
+    void cleanupGpuCulling();
+    void dispatchGpuCulling(const glm::mat4& view, const glm::mat4& projection, const std::vector<RTSphere>& spheres);
+    bool initHiZ();
+    void cleanupHiZ();
+    void buildHiZPyramid();
+    void queueCullingStatsReadback(uint32_t objectCount);
+    void collectCullingStats();
+    bool initOIT();
+    void cleanupOIT();
+    
+    // Fills cpuVisibleObjects with the main sphere (unless it is drawn as transparent), cubes and
+    // bullets that intersect the view frustum
+    void cullOpaqueObjects(const glm::mat4& view, const glm::mat4& projection,
+                           const std::vector<Cube>& cubes, const std::vector<Bullet>& bullets,
+                           const glm::vec3& mainObjectPos, bool includeMainSphere = true);
+    
+    // Sort-keyed opaque submission (program, material, front-to-back depth)
+    void buildOpaqueRenderQueue(const glm::mat4& view, const glm::mat4& projection);
+    void submitOpaqueRenderQueue(const std::vector<Cube>& cubes, const std::vector<Bullet>& bullets,
+                                 const glm::vec3& mainObjectPos, const Material& currentMaterial);
+    void setSpawnedMaterialUniforms();
+    void setBulletMaterialUniforms();
     
     // Forward+ helper functions
     bool initForwardPlus();
     void setupForwardPlusBuffers();
-    void updateLightData(const std::vector<glm::vec3>& lightPositions, const std::vector<glm::vec3>& lightColors);
+    void updateLightData(const std::vector<PointLight>& lights);
     void cleanupForwardPlus();
 };
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "HeadlessContext.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <vector>
+
+#ifdef VIBE3D_HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+namespace {
+    bool hasEGLExtension(const char* extensions, const char* name) {
+        if (!extensions) {
+            return false;
+        }
+        size_t length = std::strlen(name);
+        for (const char* found = std::strstr(extensions, name); found; found = std::strstr(found + length, name)) {
+            bool startsWord = found == extensions || found[-1] == ' ';
+            bool endsWord = found[length] == ' ' || found[length] == '\0';
+            if (startsWord && endsWord) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+#endif
+
+HeadlessContext::HeadlessContext()
+    : width(0), height(0)
+    , display(nullptr)
+    , context(nullptr)
+    , framebuffer(0)
+    , colorRenderbuffer(0)
+    , depthRenderbuffer(0)
+{
+}
+
+HeadlessContext::~HeadlessContext() {
+    cleanup();
+}
+
+#ifdef VIBE3D_HEADLESS_EGL
+
+bool HeadlessContext::initialize(unsigned int requestedWidth, unsigned int requestedHeight) {
+    width = requestedWidth;
+    height = requestedHeight;
+
+    // Surfaceless platform first: no X11/Wayland connection and no pbuffer needed
+    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (hasEGLExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay) {
+            eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+    }
+    if (eglDisplay == EGL_NO_DISPLAY) {
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint major = 0, minor = 0;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        std::cerr << "Failed to initialize EGL display for headless rendering" << std::endl;
+        return false;
+    }
+    display = eglDisplay;
+
+    if (!hasEGLExtension(eglQueryString(eglDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+        std::cerr << "EGL_KHR_surfaceless_context not supported - headless rendering unavailable" << std::endl;
+        return false;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cerr << "EGL cannot bind the desktop OpenGL API" << std::endl;
+        return false;
+    }
+
+    // The surface type defaults to window, which surfaceless displays have no configs for
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount) || configCount == 0) {
+        std::cerr << "No EGL config supports desktop OpenGL" << std::endl;
+        return false;
+    }
+
+    // Same version and profile the windowed path asks GLFW for
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+    if (eglContext == EGL_NO_CONTEXT) {
+        std::cerr << "Failed to create an OpenGL 4.3 core context via EGL" << std::endl;
+        return false;
+    }
+    context = eglContext;
+
+    if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) {
+        std::cerr << "Failed to make the headless context current" << std::endl;
+        return false;
+    }
+
+    std::cout << "Headless EGL " << major << "." << minor << " context created ("
+              << width << "x" << height << " offscreen framebuffer)" << std::endl;
+    return true;
+}
+
+void* HeadlessContext::getProcAddress(const char* name) {
+    return (void*)eglGetProcAddress(name);
+}
+
+#else
+
+bool HeadlessContext::initialize(unsigned int, unsigned int) {
+    std::cerr << "Headless rendering needs EGL - rebuild on a system where CMake finds OpenGL::EGL" << std::endl;
+    return false;
+}
+
+void* HeadlessContext::getProcAddress(const char*) {
+    return nullptr;
+}
+
+#endif
+
+bool HeadlessContext::createFramebuffer() {
+    glGenRenderbuffers(1, &colorRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Headless framebuffer incomplete" << std::endl;
+        return false;
+    }
+    glViewport(0, 0, width, height);
+    return true;
+}
+
+bool HeadlessContext::writeScreenshot(const std::string& path) const {
+    if (!framebuffer) {
+        return false;
+    }
+
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 3);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open screenshot file " << path << std::endl;
+        return false;
+    }
+
+    // GL rows are bottom-up, PPM rows top-down
+    out << "P6\n" << width << " " << height << "\n255\n";
+    for (unsigned int row = height; row-- > 0;) {
+        out.write(reinterpret_cast<const char*>(&pixels[static_cast<size_t>(row) * width * 3]), width * 3);
+    }
+    std::cout << "Screenshot written to " << path << std::endl;
+    return out.good();
+}
+
+void HeadlessContext::cleanup() {
+    if (framebuffer) {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &colorRenderbuffer);
+        glDeleteRenderbuffers(1, &depthRenderbuffer);
+        framebuffer = 0;
+        colorRenderbuffer = 0;
+        depthRenderbuffer = 0;
+    }
+
+#ifdef VIBE3D_HEADLESS_EGL
+    if (display) {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (context) {
+            eglDestroyContext(display, context);
+        }
+        eglTerminate(display);
+    }
+#endif
+    display = nullptr;
+    context = nullptr;
+}
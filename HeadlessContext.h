@@ -0,0 +1,35 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+
+// Windowless OpenGL 4.3 core context for automated runs ("--headless"). The context comes from
+// EGL on Mesa's surfaceless platform (falling back to the default display), so it needs neither
+// a display server nor a GPU: llvmpipe is enough. An FBO stands in for the window framebuffer.
+// Requires a build with EGL (VIBE3D_HEADLESS_EGL); otherwise initialize() reports the missing support.
+class HeadlessContext {
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    // Creates the context and makes it current; load GL with getProcAddress afterwards
+    bool initialize(unsigned int width, unsigned int height);
+    // Creates the RGBA8 + depth/stencil framebuffer the renderer draws into (needs loaded GL)
+    bool createFramebuffer();
+    void cleanup();
+
+    static void* getProcAddress(const char* name);
+
+    GLuint getFramebuffer() const { return framebuffer; }
+
+    // Writes the framebuffer's color attachment as a binary PPM
+    bool writeScreenshot(const std::string& path) const;
+
+private:
+    unsigned int width, height;
+    void* display;    // EGLDisplay
+    void* context;    // EGLContext
+    GLuint framebuffer;
+    GLuint colorRenderbuffer;
+    GLuint depthRenderbuffer;
+};
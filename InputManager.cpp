@@ -1,9 +1,18 @@
 #include "InputManager.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <cmath>
+#include <cstring>
+#include <iostream>
 
 InputManager* InputManager::instance = nullptr;
 
+namespace {
+    // Log layout: magic, version, then per frame the time (float), the button mask with bit 31
+    // set when the cursor moved, and in that case the cursor x and y (floats). Host byte order.
+    const char INPUT_LOG_MAGIC[4] = { 'V', '3', 'D', 'I' };
+    const uint32_t INPUT_LOG_VERSION = 1;
+}
+
 InputManager::InputManager() 
     : cameraFront(0.0f, 0.0f, -1.0f)
     , cameraUp(0.0f, 1.0f, 0.0f)
@@ -14,99 +23,236 @@ InputManager::InputManager()
     , cameraSpeed(6.5f)
     , materialKeyPressed(false)
     , raytracingKeyPressed(false)
+    , impostorKeyPressed(false)
+    , gpuCullingKeyPressed(false)
+    , occlusionKeyPressed(false)
+    , traceKeyPressed(false)
+    , cursorPending(false)
+    , pendingCursorX(0.0f), pendingCursorY(0.0f)
+    , replayIndex(0)
+    , replaying(false)
 {
     instance = this;
 }
 
+InputManager::~InputManager() {
+    stopRecording();
+    if (instance == this) {
+        instance = nullptr;
+    }
+}
+
 void InputManager::initialize(GLFWwindow* window) {
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     glfwSetCursorPosCallback(window, mouse_callback);
 }
 
-void InputManager::processInput(GLFWwindow* window, float deltaTime) {
-    // This function can be used for any general input processing
-    // Most specific input handling is done through the individual functions
+bool InputManager::beginFrame(GLFWwindow* window, float& time) {
+    if (replaying) {
+        if (replayIndex >= replayFrames.size()) {
+            return false;
+        }
+        snapshot = replayFrames[replayIndex++];
+        time = snapshot.time;
+    } else {
+        snapshot = pollSnapshot(window, time);
+        if (recordFile.is_open()) {
+            // Cursor coordinates follow only on frames where the mouse moved
+            uint32_t packed = snapshot.buttons | (snapshot.cursorMoved ? 0x80000000u : 0u);
+            recordFile.write(reinterpret_cast<const char*>(&snapshot.time), sizeof(float));
+            recordFile.write(reinterpret_cast<const char*>(&packed), sizeof(uint32_t));
+            if (snapshot.cursorMoved) {
+                recordFile.write(reinterpret_cast<const char*>(&snapshot.cursorX), sizeof(float));
+                recordFile.write(reinterpret_cast<const char*>(&snapshot.cursorY), sizeof(float));
+            }
+        }
+    }
+    
+    if (snapshot.cursorMoved) {
+        handleMouseMovement(snapshot.cursorX, snapshot.cursorY);
+    }
+    return true;
+}
+
+InputSnapshot InputManager::pollSnapshot(GLFWwindow* window, float time) {
+    static const int keys[InputButtonCount] = {
+        GLFW_KEY_W, GLFW_KEY_S, GLFW_KEY_A, GLFW_KEY_D, GLFW_KEY_SPACE,
+        GLFW_MOUSE_BUTTON_LEFT,    // read with glfwGetMouseButton
+        GLFW_KEY_E, GLFW_KEY_M, GLFW_KEY_R, GLFW_KEY_I, GLFW_KEY_G, GLFW_KEY_O, GLFW_KEY_T,
+        GLFW_KEY_EQUAL, GLFW_KEY_MINUS, GLFW_KEY_ESCAPE
+    };
+    
+    InputSnapshot polled;
+    polled.time = time;
+    if (window) {
+        for (uint32_t button = 0; button < InputButtonCount; button++) {
+            int state = button == InputShoot ? glfwGetMouseButton(window, keys[button])
+                                             : glfwGetKey(window, keys[button]);
+            if (state == GLFW_PRESS) {
+                polled.buttons |= 1u << button;
+            }
+        }
+    }
+    
+    // Mouse events between two frames collapse into one movement to the last position
+    polled.cursorMoved = cursorPending;
+    polled.cursorX = pendingCursorX;
+    polled.cursorY = pendingCursorY;
+    cursorPending = false;
+    return polled;
+}
+
+bool InputManager::startRecording(const std::string& path) {
+    recordFile.open(path, std::ios::binary | std::ios::trunc);
+    if (!recordFile.is_open()) {
+        std::cerr << "Failed to open input log " << path << " for writing" << std::endl;
+        return false;
+    }
+    recordFile.write(INPUT_LOG_MAGIC, 4);
+    recordFile.write(reinterpret_cast<const char*>(&INPUT_LOG_VERSION), sizeof(uint32_t));
+    std::cout << "Recording input to " << path << std::endl;
+    return true;
 }
 
-glm::vec3 InputManager::getCameraMovement(GLFWwindow* window, float deltaTime) const {
+void InputManager::stopRecording() {
+    if (recordFile.is_open()) {
+        recordFile.close();
+    }
+}
+
+bool InputManager::startReplay(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open input log " << path << std::endl;
+        return false;
+    }
+    
+    char magic[4];
+    uint32_t version = 0;
+    if (!file.read(magic, 4) || std::memcmp(magic, INPUT_LOG_MAGIC, 4) != 0
+        || !file.read(reinterpret_cast<char*>(&version), sizeof(uint32_t)) || version != INPUT_LOG_VERSION) {
+        std::cerr << path << " is not a version " << INPUT_LOG_VERSION << " input log" << std::endl;
+        return false;
+    }
+    
+    // The whole log is decoded up front so replay does no file I/O inside measured frames
+    replayFrames.clear();
+    InputSnapshot frame;
+    uint32_t packed;
+    while (file.read(reinterpret_cast<char*>(&frame.time), sizeof(float))
+           && file.read(reinterpret_cast<char*>(&packed), sizeof(uint32_t))) {
+        frame.buttons = packed & ~0x80000000u;
+        frame.cursorMoved = (packed & 0x80000000u) != 0;
+        if (frame.cursorMoved
+            && !(file.read(reinterpret_cast<char*>(&frame.cursorX), sizeof(float))
+                 && file.read(reinterpret_cast<char*>(&frame.cursorY), sizeof(float)))) {
+            break;
+        }
+        replayFrames.push_back(frame);
+    }
+    
+    replayIndex = 0;
+    replaying = true;
+    std::cout << "Replaying " << replayFrames.size() << " input frames from " << path << std::endl;
+    return true;
+}
+
+glm::vec3 InputManager::getCameraMovement(float deltaTime) const {
     glm::vec3 movement(0.0f);
     float speed = cameraSpeed * deltaTime;
     
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+    if (snapshot.isDown(InputMoveForward))
         movement += speed * cameraFront;
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+    if (snapshot.isDown(InputMoveBack))
         movement -= speed * cameraFront;
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+    if (snapshot.isDown(InputMoveLeft))
         movement -= glm::normalize(glm::cross(cameraFront, cameraUp)) * speed;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+    if (snapshot.isDown(InputMoveRight))
         movement += glm::normalize(glm::cross(cameraFront, cameraUp)) * speed;
         
     return movement;
 }
 
-bool InputManager::shouldJump(GLFWwindow* window) const {
-    return glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+bool InputManager::shouldJump() const {
+    return snapshot.isDown(InputJump);
 }
 
-bool InputManager::shouldShoot(GLFWwindow* window) const {
-    return glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+bool InputManager::shouldShoot() const {
+    return snapshot.isDown(InputShoot);
 }
 
-bool InputManager::shouldSpawnCube(GLFWwindow* window) const {
-    return glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS;
+bool InputManager::shouldSpawnCube() const {
+    return snapshot.isDown(InputSpawnCube);
 }
 
-bool InputManager::shouldCycleMaterial(GLFWwindow* window) {
-    if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS && !materialKeyPressed) {
-        materialKeyPressed = true;
+bool InputManager::consumePress(InputButton button, bool& pressedFlag) {
+    if (snapshot.isDown(button) && !pressedFlag) {
+        pressedFlag = true;
         return true;
     }
-    if (glfwGetKey(window, GLFW_KEY_M) == GLFW_RELEASE) {
-        materialKeyPressed = false;
+    if (!snapshot.isDown(button)) {
+        pressedFlag = false;
     }
     return false;
 }
 
-bool InputManager::shouldToggleRaytracing(GLFWwindow* window) {
-    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS && !raytracingKeyPressed) {
-        raytracingKeyPressed = true;
-        return true;
-    }
-    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_RELEASE) {
-        raytracingKeyPressed = false;
-    }
-    return false;
+bool InputManager::shouldCycleMaterial() {
+    return consumePress(InputCycleMaterial, materialKeyPressed);
+}
+
+bool InputManager::shouldToggleRaytracing() {
+    return consumePress(InputToggleRaytracing, raytracingKeyPressed);
 }
 
-bool InputManager::shouldIncreaseExposure(GLFWwindow* window) const {
-    return glfwGetKey(window, GLFW_KEY_EQUAL) == GLFW_PRESS; // + key
+bool InputManager::shouldToggleImpostors() {
+    return consumePress(InputToggleImpostors, impostorKeyPressed);
 }
 
-bool InputManager::shouldDecreaseExposure(GLFWwindow* window) const {
-    return glfwGetKey(window, GLFW_KEY_MINUS) == GLFW_PRESS; // - key
+bool InputManager::shouldToggleGpuCulling() {
+    return consumePress(InputToggleGpuCulling, gpuCullingKeyPressed);
 }
 
-bool InputManager::shouldExit(GLFWwindow* window) const {
-    return glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS;
+bool InputManager::shouldToggleOcclusionCulling() {
+    return consumePress(InputToggleOcclusion, occlusionKeyPressed);
 }
 
-void InputManager::handleMouseMovement(double xpos, double ypos) {
+bool InputManager::shouldExportTrace() {
+    return consumePress(InputExportTrace, traceKeyPressed);
+}
+
+bool InputManager::shouldIncreaseExposure() const {
+    return snapshot.isDown(InputExposureUp); // + key
+}
+
+bool InputManager::shouldDecreaseExposure() const {
+    return snapshot.isDown(InputExposureDown); // - key
+}
+
+bool InputManager::shouldExit() const {
+    return snapshot.isDown(InputExit);
+}
+
+void InputManager::handleMouseMovement(float xpos, float ypos) {
     if (firstMouse) {
-        lastX = static_cast<float>(xpos);
-        lastY = static_cast<float>(ypos);
+        lastX = xpos;
+        lastY = ypos;
         firstMouse = false;
     }
 
-    float xoffset = static_cast<float>(xpos) - lastX;
-    float yoffset = lastY - static_cast<float>(ypos);
-    lastX = static_cast<float>(xpos);
-    lastY = static_cast<float>(ypos);
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
 
     xoffset *= mouseSensitivity;
     yoffset *= mouseSensitivity;
 
-    yaw += xoffset;
-    pitch += yoffset;
+    setCameraOrientation(yaw + xoffset, pitch + yoffset);
+}
+
+void InputManager::setCameraOrientation(float newYaw, float newPitch) {
+    yaw = newYaw;
+    pitch = newPitch;
 
     if (pitch > 89.0f)
         pitch = 89.0f;
@@ -126,7 +272,10 @@ void InputManager::setCameraProperties(float sensitivity, float speed) {
 }
 
 void InputManager::mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    // Applied by the next beginFrame(), so live and replayed sessions take the same path
     if (instance) {
-        instance->handleMouseMovement(xpos, ypos);
+        instance->cursorPending = true;
+        instance->pendingCursorX = static_cast<float>(xpos);
+        instance->pendingCursorY = static_cast<float>(ypos);
     }
 }
\ No newline at end of file
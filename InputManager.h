@@ -2,33 +2,90 @@
 
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
 
+// Keys and buttons sampled once per frame; bit i of InputSnapshot::buttons is button i
+enum InputButton : uint32_t {
+    InputMoveForward,
+    InputMoveBack,
+    InputMoveLeft,
+    InputMoveRight,
+    InputJump,
+    InputShoot,
+    InputSpawnCube,
+    InputCycleMaterial,
+    InputToggleRaytracing,
+    InputToggleImpostors,
+    InputToggleGpuCulling,
+    InputToggleOcclusion,
+    InputExportTrace,
+    InputExposureUp,
+    InputExposureDown,
+    InputExit,
+    InputButtonCount
+};
+
+// Everything the game reads from GLFW in one frame. The cursor position is the last one the
+// mouse callback reported during the frame (already float, as handleMouseMovement uses it).
+struct InputSnapshot {
+    float time = 0.0f;          // frame time in seconds, the base of deltaTime
+    uint32_t buttons = 0;
+    bool cursorMoved = false;
+    float cursorX = 0.0f;
+    float cursorY = 0.0f;
+
+    bool isDown(InputButton button) const { return (buttons >> button) & 1u; }
+};
+
+// All queries read the current frame's snapshot, which beginFrame() either polls from GLFW or
+// takes from a replay log. Recording writes each polled snapshot to a compact binary log
+// ("--record-input"); replaying it ("--replay-input") reproduces the session bit-exactly,
+// frame times included, as long as the rest of the run is deterministic.
 class InputManager {
 public:
     InputManager();
+    ~InputManager();
     
     // Initialization
     void initialize(GLFWwindow* window);
     
-    // Input processing
-    void processInput(GLFWwindow* window, float deltaTime);
+    // Samples this frame's input. time is the live frame time and is replaced by the recorded
+    // one while replaying. Returns false once the replay log is exhausted.
+    bool beginFrame(GLFWwindow* window, float& time);
+    
+    // Recording and replay; both must start before the first beginFrame()
+    bool startRecording(const std::string& path);
+    bool startReplay(const std::string& path);
+    void stopRecording();
+    bool isRecording() const { return recordFile.is_open(); }
+    bool isReplaying() const { return replaying; }
+    size_t getReplayFrameCount() const { return replayFrames.size(); }
     
     // Camera controls
-    glm::vec3 getCameraMovement(GLFWwindow* window, float deltaTime) const;
-    bool shouldJump(GLFWwindow* window) const;
+    glm::vec3 getCameraMovement(float deltaTime) const;
+    bool shouldJump() const;
     
     // Action inputs
-    bool shouldShoot(GLFWwindow* window) const;
-    bool shouldSpawnCube(GLFWwindow* window) const;
-    bool shouldCycleMaterial(GLFWwindow* window);
-    bool shouldToggleRaytracing(GLFWwindow* window);
-    bool shouldIncreaseExposure(GLFWwindow* window) const;
-    bool shouldDecreaseExposure(GLFWwindow* window) const;
-    bool shouldExit(GLFWwindow* window) const;
+    bool shouldShoot() const;
+    bool shouldSpawnCube() const;
+    bool shouldCycleMaterial();
+    bool shouldToggleRaytracing();
+    bool shouldToggleImpostors();
+    bool shouldToggleGpuCulling();
+    bool shouldToggleOcclusionCulling();
+    bool shouldExportTrace();
+    bool shouldIncreaseExposure() const;
+    bool shouldDecreaseExposure() const;
+    bool shouldExit() const;
     
     // Mouse handling
-    void handleMouseMovement(double xpos, double ypos);
+    void handleMouseMovement(float xpos, float ypos);
     glm::vec3 getCameraFront() const { return cameraFront; }
+    // Degrees; pitch is clamped to +-89
+    void setCameraOrientation(float newYaw, float newPitch);
     
     // Camera settings
     void setCameraProperties(float sensitivity, float speed);
@@ -46,6 +103,25 @@ private:
     // Input state tracking
     bool materialKeyPressed;
     bool raytracingKeyPressed;
+    bool impostorKeyPressed;
+    bool gpuCullingKeyPressed;
+    bool occlusionKeyPressed;
+    bool traceKeyPressed;
+    
+    // Per-frame input
+    InputSnapshot snapshot;
+    bool cursorPending;
+    float pendingCursorX, pendingCursorY;
+    
+    // Input log
+    std::ofstream recordFile;
+    std::vector<InputSnapshot> replayFrames;
+    size_t replayIndex;
+    bool replaying;
+    
+    InputSnapshot pollSnapshot(GLFWwindow* window, float time);
+    // Rising edge of a button, tracked across frames in pressedFlag
+    bool consumePress(InputButton button, bool& pressedFlag);
     
     // Static callback functions
     static void mouse_callback(GLFWwindow* window, double xpos, double ypos);
@@ -0,0 +1,384 @@
+#include "MeshOptimizer.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Forsyth scoring parameters (see "Linear-Speed Vertex Cache Optimisation")
+    const int FORSYTH_CACHE_SIZE = 32;
+    const float CACHE_DECAY_POWER = 1.5f;
+    const float LAST_TRIANGLE_SCORE = 0.75f;
+    const float VALENCE_BOOST_SCALE = 2.0f;
+    const float VALENCE_BOOST_POWER = 0.5f;
+
+    // Cache size used when splitting clusters for overdraw ordering
+    const unsigned int OVERDRAW_CACHE_SIZE = 16;
+
+    float forsythVertexScore(int cachePosition, unsigned int remainingValence) {
+        if (remainingValence == 0) {
+            return -1.0f; // No triangles left to use this vertex
+        }
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // Vertices of the triangle just emitted get a fixed score so the
+                // algorithm doesn't favour immediately reusing the same edge
+                score = LAST_TRIANGLE_SCORE;
+            } else {
+                float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+            }
+        }
+
+        // Boost vertices with few triangles left so lone triangles don't get stranded
+        score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingValence), -VALENCE_BOOST_POWER);
+        return score;
+    }
+
+    glm::vec3 vertexPosition(const std::vector<float>& vertices, size_t vertexStride, unsigned int index) {
+        const float* v = &vertices[index * vertexStride];
+        return glm::vec3(v[0], v[1], v[2]);
+    }
+
+    // Simple FIFO cache simulation using insertion timestamps
+    struct FifoCache {
+        std::vector<unsigned int> timestamps;
+        unsigned int time;
+        unsigned int size;
+
+        FifoCache(size_t vertexCount, unsigned int cacheSize)
+            : timestamps(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {}
+
+        // Returns true on a cache miss
+        bool access(unsigned int vertex) {
+            if (time - timestamps[vertex] > size) {
+                timestamps[vertex] = time++;
+                return true;
+            }
+            return false;
+        }
+
+        void reset() {
+            time += size + 1;
+        }
+    };
+}
+
+MeshOptimizationReport MeshOptimizer::optimize(std::vector<float>& vertices, std::vector<unsigned int>& indices,
+                                               size_t vertexStride, float overdrawThreshold) {
+    MeshOptimizationReport report;
+    size_t vertexCount = vertices.size() / vertexStride;
+
+    report.before = analyzeVertexCache(indices, vertexCount);
+
+    optimizeVertexCache(indices, vertexCount);
+    optimizeOverdraw(indices, vertices, vertexStride, overdrawThreshold);
+    optimizeVertexFetch(vertices, indices, vertexStride);
+
+    report.after = analyzeVertexCache(indices, vertexCount);
+    return report;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) {
+        return;
+    }
+
+    // Build vertex -> triangle adjacency (CSR layout)
+    std::vector<unsigned int> valence(vertexCount, 0);
+    for (unsigned int index : indices) {
+        valence[index]++;
+    }
+
+    std::vector<unsigned int> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + valence[v];
+    }
+
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<unsigned int> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) {
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+        }
+    }
+
+    // Initial scores
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        vertexScore[v] = forsythVertexScore(-1, valence[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScore[t] = vertexScore[indices[t * 3 + 0]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+    }
+
+    std::vector<unsigned int> cache;
+    std::vector<unsigned int> newCache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    newCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+
+    // Start from the globally best triangle
+    size_t bestTriangle = std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin();
+    size_t scanCursor = 0;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        if (bestTriangle == static_cast<size_t>(-1)) {
+            // Nothing adjacent to the cache is left; continue with the next unemitted triangle
+            while (emitted[scanCursor]) {
+                scanCursor++;
+            }
+            bestTriangle = scanCursor;
+        }
+
+        const unsigned int* tri = &indices[bestTriangle * 3];
+        emitted[bestTriangle] = true;
+
+        newCache.clear();
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = tri[k];
+            result.push_back(v);
+
+            // Remove the emitted triangle from the vertex's live adjacency list
+            unsigned int begin = adjacencyOffset[v];
+            unsigned int end = begin + valence[v];
+            for (unsigned int a = begin; a < end; a++) {
+                if (adjacency[a] == bestTriangle) {
+                    std::swap(adjacency[a], adjacency[end - 1]);
+                    break;
+                }
+            }
+            valence[v]--;
+
+            newCache.push_back(v);
+        }
+
+        // Older cache entries move down behind the triangle just emitted
+        for (unsigned int v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                newCache.push_back(v);
+            }
+        }
+
+        // Vertices pushed out of the cache lose their cache bonus
+        for (size_t i = FORSYTH_CACHE_SIZE; i < newCache.size(); i++) {
+            cachePosition[newCache[i]] = -1;
+            vertexScore[newCache[i]] = forsythVertexScore(-1, valence[newCache[i]]);
+        }
+        if (newCache.size() > static_cast<size_t>(FORSYTH_CACHE_SIZE)) {
+            newCache.resize(FORSYTH_CACHE_SIZE);
+        }
+        cache.swap(newCache);
+
+        for (size_t i = 0; i < cache.size(); i++) {
+            cachePosition[cache[i]] = static_cast<int>(i);
+            vertexScore[cache[i]] = forsythVertexScore(static_cast<int>(i), valence[cache[i]]);
+        }
+
+        // Rescore live triangles touching the cache and pick the best one
+        bestTriangle = static_cast<size_t>(-1);
+        float bestScore = -1.0f;
+        for (unsigned int v : cache) {
+            unsigned int begin = adjacencyOffset[v];
+            unsigned int end = begin + valence[v];
+            for (unsigned int a = begin; a < end; a++) {
+                unsigned int t = adjacency[a];
+                float score = vertexScore[indices[t * 3 + 0]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                triangleScore[t] = score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(result);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<float>& vertices,
+                                     size_t vertexStride, float threshold) {
+    size_t triangleCount = indices.size() / 3;
+    size_t vertexCount = vertices.size() / vertexStride;
+    if (triangleCount < 2 || vertexCount == 0) {
+        return;
+    }
+
+    // Hard boundaries: triangles where every vertex missed the cache, i.e. the
+    // vertex cache order already restarted there and splitting costs nothing
+    std::vector<unsigned int> hardBoundaries;
+    {
+        FifoCache cache(vertexCount, OVERDRAW_CACHE_SIZE);
+        for (size_t t = 0; t < triangleCount; t++) {
+            int misses = 0;
+            for (int k = 0; k < 3; k++) {
+                misses += cache.access(indices[t * 3 + k]) ? 1 : 0;
+            }
+            if (t == 0 || misses == 3) {
+                hardBoundaries.push_back(static_cast<unsigned int>(t));
+            }
+        }
+        hardBoundaries.push_back(static_cast<unsigned int>(triangleCount));
+    }
+
+    // Soft boundaries: split hard clusters further wherever the running ACMR of the
+    // current cluster is within threshold of the whole cluster's ACMR
+    std::vector<unsigned int> clusters;
+    {
+        FifoCache cache(vertexCount, OVERDRAW_CACHE_SIZE);
+        for (size_t c = 0; c + 1 < hardBoundaries.size(); c++) {
+            unsigned int start = hardBoundaries[c];
+            unsigned int end = hardBoundaries[c + 1];
+
+            cache.reset();
+            unsigned int clusterMisses = 0;
+            for (unsigned int t = start; t < end; t++) {
+                for (int k = 0; k < 3; k++) {
+                    clusterMisses += cache.access(indices[t * 3 + k]) ? 1 : 0;
+                }
+            }
+            float clusterAcmr = static_cast<float>(clusterMisses) / (end - start);
+
+            cache.reset();
+            clusters.push_back(start);
+            unsigned int softStart = start;
+            unsigned int softMisses = 0;
+            for (unsigned int t = start; t < end; t++) {
+                for (int k = 0; k < 3; k++) {
+                    softMisses += cache.access(indices[t * 3 + k]) ? 1 : 0;
+                }
+
+                float runningAcmr = static_cast<float>(softMisses) / (t - softStart + 1);
+                if (t + 1 < end && runningAcmr <= clusterAcmr * threshold) {
+                    clusters.push_back(t + 1);
+                    softStart = t + 1;
+                    softMisses = 0;
+                    cache.reset();
+                }
+            }
+        }
+        clusters.push_back(static_cast<unsigned int>(triangleCount));
+    }
+
+    // Mesh centroid
+    glm::vec3 meshCentroid(0.0f);
+    for (size_t v = 0; v < vertexCount; v++) {
+        meshCentroid += vertexPosition(vertices, vertexStride, static_cast<unsigned int>(v));
+    }
+    meshCentroid /= static_cast<float>(vertexCount);
+
+    // Sort clusters by how much they face away from the mesh centre: outer clusters
+    // occlude inner ones, so drawing them first lets early-Z reject the rest
+    struct ClusterSortEntry {
+        float key;
+        unsigned int start;
+        unsigned int end;
+    };
+    std::vector<ClusterSortEntry> sortEntries;
+    sortEntries.reserve(clusters.size() - 1);
+
+    for (size_t c = 0; c + 1 < clusters.size(); c++) {
+        glm::vec3 centroid(0.0f);
+        glm::vec3 normal(0.0f);
+        float totalArea = 0.0f;
+
+        for (unsigned int t = clusters[c]; t < clusters[c + 1]; t++) {
+            glm::vec3 p0 = vertexPosition(vertices, vertexStride, indices[t * 3 + 0]);
+            glm::vec3 p1 = vertexPosition(vertices, vertexStride, indices[t * 3 + 1]);
+            glm::vec3 p2 = vertexPosition(vertices, vertexStride, indices[t * 3 + 2]);
+
+            glm::vec3 areaNormal = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(areaNormal);
+
+            centroid += (p0 + p1 + p2) * (area / 3.0f);
+            normal += areaNormal;
+            totalArea += area;
+        }
+
+        float key = 0.0f;
+        float normalLength = glm::length(normal);
+        if (totalArea > 0.0f && normalLength > 0.0f) {
+            centroid /= totalArea;
+            key = glm::dot(centroid - meshCentroid, normal / normalLength);
+        }
+
+        sortEntries.push_back({ key, clusters[c], clusters[c + 1] });
+    }
+
+    std::stable_sort(sortEntries.begin(), sortEntries.end(),
+                     [](const ClusterSortEntry& a, const ClusterSortEntry& b) { return a.key > b.key; });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (const auto& entry : sortEntries) {
+        result.insert(result.end(), indices.begin() + entry.start * 3, indices.begin() + entry.end * 3);
+    }
+
+    indices.swap(result);
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<float>& vertices, std::vector<unsigned int>& indices,
+                                        size_t vertexStride) {
+    size_t vertexCount = vertices.size() / vertexStride;
+    const unsigned int unused = ~0u;
+
+    std::vector<unsigned int> remap(vertexCount, unused);
+    unsigned int nextVertex = 0;
+
+    for (unsigned int& index : indices) {
+        if (remap[index] == unused) {
+            remap[index] = nextVertex++;
+        }
+        index = remap[index];
+    }
+
+    // Keep unreferenced vertices at the end so the vertex count is unchanged
+    for (size_t v = 0; v < vertexCount; v++) {
+        if (remap[v] == unused) {
+            remap[v] = nextVertex++;
+        }
+    }
+
+    std::vector<float> result(vertices.size());
+    for (size_t v = 0; v < vertexCount; v++) {
+        std::copy(vertices.begin() + v * vertexStride, vertices.begin() + (v + 1) * vertexStride,
+                  result.begin() + remap[v] * vertexStride);
+    }
+
+    vertices.swap(result);
+}
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                                   unsigned int cacheSize) {
+    VertexCacheStats stats;
+    stats.triangleCount = static_cast<unsigned int>(indices.size() / 3);
+    if (stats.triangleCount == 0 || vertexCount == 0) {
+        return stats;
+    }
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    unsigned int uniqueVertices = 0;
+
+    for (unsigned int index : indices) {
+        if (cache.access(index)) {
+            stats.vertexTransforms++;
+        }
+        if (!referenced[index]) {
+            referenced[index] = true;
+            uniqueVertices++;
+        }
+    }
+
+    stats.acmr = static_cast<float>(stats.vertexTransforms) / stats.triangleCount;
+    stats.atvr = static_cast<float>(stats.vertexTransforms) / uniqueVertices;
+    return stats;
+}
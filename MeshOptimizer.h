@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// Post-transform vertex cache statistics for an indexed triangle list
+struct VertexCacheStats {
+    float acmr = 0.0f;              // Average cache miss ratio (vertex shader invocations per triangle, 0.5 - 3.0)
+    float atvr = 0.0f;              // Average transformed vertex ratio (invocations per referenced vertex, 1.0 is ideal)
+    unsigned int vertexTransforms = 0;
+    unsigned int triangleCount = 0;
+};
+
+struct MeshOptimizationReport {
+    VertexCacheStats before;
+    VertexCacheStats after;
+};
+
+// Reorders index/vertex buffers for the GPU: post-transform cache reuse (Forsyth),
+// overdraw-aware cluster ordering and vertex fetch locality.
+// Vertices are interleaved floats with the position in the first three components.
+class MeshOptimizer {
+public:
+    // Run all stages in the recommended order and report cache statistics before/after
+    static MeshOptimizationReport optimize(std::vector<float>& vertices, std::vector<unsigned int>& indices,
+                                           size_t vertexStride, float overdrawThreshold = 1.05f);
+
+    // Reorder triangles for post-transform cache reuse (Tom Forsyth's linear-speed algorithm)
+    static void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+    // Split a cache-optimized index buffer into clusters and sort them so outward-facing
+    // clusters are drawn first; threshold bounds the allowed ACMR degradation (1.05 = 5%)
+    static void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<float>& vertices,
+                                 size_t vertexStride, float threshold = 1.05f);
+
+    // Reorder vertices in order of first use and remap indices to match
+    static void optimizeVertexFetch(std::vector<float>& vertices, std::vector<unsigned int>& indices,
+                                    size_t vertexStride);
+
+    // Simulate a FIFO post-transform cache of the given size
+    static VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                               unsigned int cacheSize = 16);
+};
@@ -1,4 +1,5 @@
 #include "PhysicsManager.h"
+#include "CpuProfiler.h"
 #include <iostream>
 #include <algorithm>
 
@@ -115,6 +116,8 @@ bool PhysicsManager::canShoot(float currentTime) const {
 }
 
 void PhysicsManager::updateSimplePhysics(float deltaTime) {
+    CPU_PROFILE_SCOPE("updateSimplePhysics");
+    
     const float floorY = -0.5f;
     const float bounceRestitution = 0.3f;
     
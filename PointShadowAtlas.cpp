@@ -0,0 +1,342 @@
+#include "PointShadowAtlas.h"
+#include "GLStateCache.h"
+#include "FrustumCuller.h"
+#include <iostream>
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+    // Tiles are 3x2 faces; face sizes per tier, and the projected light radius in pixels a
+    // light needs to get a tier. The three bands fill the atlas: 4x2 tiles of 256, 8x2 of
+    // 128 and 16x4 of 64, 88 shadowed lights at most
+    const int TIER_FACE_SIZES[PointShadowAtlas::TIER_COUNT] = { 256, 128, 64 };
+    const int TIER_ROWS[PointShadowAtlas::TIER_COUNT] = { 2, 2, 4 };
+    const float TIER_MIN_IMPORTANCE[PointShadowAtlas::TIER_COUNT] = { 200.0f, 80.0f, 0.0f };
+    // A light only changes tier once it is this far past a threshold, so lights near one
+    // don't trade tiles (and redraws) every frame
+    const float TIER_HYSTERESIS = 1.25f;
+    // Never-rendered tiles go first; lights off screen still get spare budget
+    const float NEW_TILE_PRIORITY = 4.0f;
+    const float OFFSCREEN_IMPORTANCE = 1.0f;
+    const float FACE_NEAR_PLANE = 0.05f;
+
+    // Cube face order +X, -X, +Y, -Y, +Z, -Z; the shader picks the face by the major axis
+    const glm::vec3 FACE_DIRECTIONS[PointShadowAtlas::FACE_COUNT] = {
+        glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+        glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f)
+    };
+    const glm::vec3 FACE_UPS[PointShadowAtlas::FACE_COUNT] = {
+        glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f),
+        glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)
+    };
+}
+
+PointShadowAtlas::PointShadowAtlas()
+    : atlasTexture(0)
+    , atlasFBO(0)
+    , updateBudget(4)
+{
+    int originY = 0;
+    for (int t = 0; t < TIER_COUNT; t++) {
+        tiers[t].faceSize = TIER_FACE_SIZES[t];
+        tiers[t].originY = originY;
+        tiers[t].columns = ATLAS_WIDTH / (3 * TIER_FACE_SIZES[t]);
+        tiers[t].rows = TIER_ROWS[t];
+        tiers[t].minImportance = TIER_MIN_IMPORTANCE[t];
+        originY += TIER_ROWS[t] * 2 * TIER_FACE_SIZES[t];
+    }
+}
+
+bool PointShadowAtlas::initialize(GLStateCache& glState) {
+    // Hardware depth compare with bilinear filtering, one 2x2 PCF tap per lookup
+    glGenTextures(1, &atlasTexture);
+    glState.bindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, ATLAS_WIDTH, ATLAS_HEIGHT, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glState.bindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &atlasFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, atlasFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, atlasTexture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Point shadow atlas framebuffer incomplete: " << status << std::endl;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        cleanup();
+        return false;
+    }
+    glViewport(0, 0, ATLAS_WIDTH, ATLAS_HEIGHT);
+    glState.depthMask(true);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    int capacity = 0;
+    for (Tier& tier : tiers) {
+        // Popped from the back, so slot 0 goes first
+        tier.freeSlots.clear();
+        for (int slot = tier.columns * tier.rows - 1; slot >= 0; slot--) {
+            tier.freeSlots.push_back(slot);
+        }
+        capacity += tier.columns * tier.rows;
+    }
+
+    std::cout << "Point shadow atlas: " << ATLAS_WIDTH << "x" << ATLAS_HEIGHT << ", " << capacity
+              << " cube tiles (faces " << TIER_FACE_SIZES[0] << "/" << TIER_FACE_SIZES[1] << "/" << TIER_FACE_SIZES[2]
+              << "), " << updateBudget << " tile updates per frame" << std::endl;
+    return true;
+}
+
+void PointShadowAtlas::cleanup() {
+    if (atlasFBO) {
+        glDeleteFramebuffers(1, &atlasFBO);
+        atlasFBO = 0;
+    }
+    if (atlasTexture) {
+        glDeleteTextures(1, &atlasTexture);
+        atlasTexture = 0;
+    }
+    tiles.clear();
+    for (Tier& tier : tiers) {
+        tier.freeSlots.clear();
+    }
+}
+
+void PointShadowAtlas::releaseTile(LightTile& tile) {
+    if (tile.tier >= 0) {
+        tiers[tile.tier].freeSlots.push_back(tile.slot);
+    }
+    tile.tier = -1;
+    tile.slot = -1;
+    tile.rendered = false;
+}
+
+glm::ivec2 PointShadowAtlas::tileOrigin(int tier, int slot) const {
+    const Tier& t = tiers[tier];
+    return glm::ivec2((slot % t.columns) * 3 * t.faceSize, t.originY + (slot / t.columns) * 2 * t.faceSize);
+}
+
+int PointShadowAtlas::tierFor(float importance, int currentTier) const {
+    int desired = TIER_COUNT - 1;
+    for (int t = 0; t < TIER_COUNT; t++) {
+        if (importance >= tiers[t].minImportance) {
+            desired = t;
+            break;
+        }
+    }
+    if (currentTier >= 0 && desired != currentTier) {
+        float lower = tiers[currentTier].minImportance / TIER_HYSTERESIS;
+        float upper = currentTier > 0 ? tiers[currentTier - 1].minImportance * TIER_HYSTERESIS : 1e30f;
+        if (importance >= lower && importance < upper) {
+            return currentTier;
+        }
+    }
+    return desired;
+}
+
+void PointShadowAtlas::scheduleUpdates(const glm::mat4& view, const glm::mat4& projection, float viewportHeight,
+                                       const std::vector<PointShadowCaster>& lights,
+                                       std::vector<PointShadowUpdate>& updates) {
+    updates.clear();
+    stats.budget = static_cast<uint32_t>(updateBudget);
+    if (!isInitialized()) {
+        return;
+    }
+
+    for (size_t i = lights.size(); i < tiles.size(); i++) {
+        releaseTile(tiles[i]);
+    }
+    tiles.resize(lights.size());
+
+    // Importance is the light's projected radius in pixels; lights off screen have none
+    Frustum frustum = FrustumCuller::extractFrustum(projection * view);
+    float pixelScale = projection[1][1] * viewportHeight * 0.5f;
+    order.clear();
+    for (size_t i = 0; i < lights.size(); i++) {
+        const PointShadowCaster& light = lights[i];
+        LightTile& tile = tiles[i];
+        tile.importance = 0.0f;
+        if (!light.enabled || light.radius <= 0.0f) {
+            releaseTile(tile);
+            continue;
+        }
+        if (FrustumCuller::isSphereVisible(frustum, light.position, light.radius)) {
+            float distance = glm::length(glm::vec3(view * glm::vec4(light.position, 1.0f)));
+            tile.importance = light.radius * pixelScale / std::max(distance, light.radius);
+        }
+        order.push_back(static_cast<int>(i));
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return tiles[a].importance > tiles[b].importance;
+    });
+
+    // Target tiers, most important first; a full pool sends the light down a tier. Lights off
+    // screen keep their tile while the pool has room, so it is still valid when they return
+    int used[TIER_COUNT] = {};
+    std::vector<int> target(lights.size(), -1);
+    for (int i : order) {
+        LightTile& tile = tiles[i];
+        if (tile.importance <= 0.0f) {
+            continue;
+        }
+        int t = tierFor(tile.importance, tile.tier);
+        while (t < TIER_COUNT && used[t] >= tiers[t].columns * tiers[t].rows) {
+            t++;
+        }
+        if (t < TIER_COUNT) {
+            target[i] = t;
+            used[t]++;
+        } else {
+            stats.unshadowedLights++;
+        }
+    }
+    for (int i : order) {
+        int t = tiles[i].tier;
+        if (tiles[i].importance <= 0.0f && t >= 0 && used[t] < tiers[t].columns * tiers[t].rows) {
+            target[i] = t;
+            used[t]++;
+        }
+    }
+
+    // Free every tile that changes hands before handing out new ones
+    for (size_t i = 0; i < tiles.size(); i++) {
+        if (tiles[i].tier >= 0 && tiles[i].tier != target[i]) {
+            releaseTile(tiles[i]);
+        }
+    }
+    for (int i : order) {
+        LightTile& tile = tiles[i];
+        if (target[i] >= 0 && tile.tier < 0) {
+            tile.tier = target[i];
+            tile.slot = tiers[tile.tier].freeSlots.back();
+            tiers[tile.tier].freeSlots.pop_back();
+            tile.framesStale = 0;
+            stats.tilesAllocated++;
+        }
+    }
+
+    // Stale tiles: new, light moved, or the casters inside its radius changed
+    dueLights.clear();
+    int occupiedArea = 0;
+    for (int i : order) {
+        LightTile& tile = tiles[i];
+        if (tile.tier < 0) {
+            continue;
+        }
+        stats.shadowedLights++;
+        stats.tierTiles[tile.tier]++;
+        occupiedArea += 6 * tiers[tile.tier].faceSize * tiers[tile.tier].faceSize;
+
+        const PointShadowCaster& light = lights[i];
+        bool stale = !tile.rendered || light.position != tile.renderedPosition
+                  || light.radius != tile.renderedRadius || light.casterHash != tile.renderedCasterHash;
+        if (!stale) {
+            tile.framesStale = 0;
+            stats.tilesReused++;
+            continue;
+        }
+        tile.framesStale++;
+        dueLights.push_back(i);
+    }
+    stats.occupancy = static_cast<float>(occupiedArea) / (static_cast<float>(ATLAS_WIDTH) * ATLAS_HEIGHT);
+
+    // Importance times frames waited, so nothing starves behind a light that moves every frame
+    auto priority = [this](int i) {
+        const LightTile& tile = tiles[i];
+        float weight = tile.rendered ? 1.0f : NEW_TILE_PRIORITY;
+        return (tile.importance + OFFSCREEN_IMPORTANCE) * tile.framesStale * weight;
+    };
+    std::stable_sort(dueLights.begin(), dueLights.end(), [&priority](int a, int b) {
+        return priority(a) > priority(b);
+    });
+    size_t dueCount = std::min(dueLights.size(), static_cast<size_t>(updateBudget));
+    stats.tilesPending = static_cast<uint32_t>(dueLights.size() - dueCount);
+
+    // Face matrices map world space straight to the face's rectangle in the atlas
+    const glm::mat4 bias = glm::translate(glm::mat4(1.0f), glm::vec3(0.5f)) * glm::scale(glm::mat4(1.0f), glm::vec3(0.5f));
+    for (size_t d = 0; d < dueCount; d++) {
+        int i = dueLights[d];
+        const PointShadowCaster& light = lights[i];
+        LightTile& tile = tiles[i];
+        int faceSize = tiers[tile.tier].faceSize;
+        glm::ivec2 origin = tileOrigin(tile.tier, tile.slot);
+        glm::mat4 faceProjection = glm::perspective(glm::radians(90.0f), 1.0f, FACE_NEAR_PLANE, light.radius);
+
+        PointShadowUpdate update;
+        update.light = i;
+        for (int face = 0; face < FACE_COUNT; face++) {
+            glm::mat4 faceView = glm::lookAt(light.position, light.position + FACE_DIRECTIONS[face], FACE_UPS[face]);
+            update.faceViewProjections[face] = faceProjection * faceView;
+
+            glm::vec2 faceOrigin(float(origin.x + (face % 3) * faceSize), float(origin.y + (face / 3) * faceSize));
+            glm::mat4 rect = glm::translate(glm::mat4(1.0f), glm::vec3(faceOrigin.x / ATLAS_WIDTH, faceOrigin.y / ATLAS_HEIGHT, 0.0f))
+                           * glm::scale(glm::mat4(1.0f), glm::vec3(float(faceSize) / ATLAS_WIDTH, float(faceSize) / ATLAS_HEIGHT, 1.0f));
+            tile.faceMatrices[face] = rect * bias * update.faceViewProjections[face];
+        }
+        updates.push_back(update);
+
+        tile.rendered = true;
+        tile.renderedPosition = light.position;
+        tile.renderedRadius = light.radius;
+        tile.renderedCasterHash = light.casterHash;
+        tile.framesStale = 0;
+        stats.tilesRendered++;
+    }
+}
+
+void PointShadowAtlas::beginFace(GLStateCache& glState, const PointShadowUpdate& update, int face) {
+    const LightTile& tile = tiles[update.light];
+    int faceSize = tiers[tile.tier].faceSize;
+    glm::ivec2 origin = tileOrigin(tile.tier, tile.slot);
+    GLint x = origin.x + (face % 3) * faceSize;
+    GLint y = origin.y + (face / 3) * faceSize;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, atlasFBO);
+    glViewport(x, y, faceSize, faceSize);
+    glScissor(x, y, faceSize, faceSize);
+    glState.enable(GL_SCISSOR_TEST);
+    glState.depthMask(true);
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void PointShadowAtlas::endUpdates(GLStateCache& glState) {
+    glState.disable(GL_SCISSOR_TEST);
+}
+
+void PointShadowAtlas::buildShaderData(size_t lightCount, std::vector<PointShadowData>& data) const {
+    data.resize(lightCount);
+    for (size_t i = 0; i < lightCount; i++) {
+        PointShadowData& record = data[i];
+        record.params = glm::vec4(0.0f);
+        if (i >= tiles.size() || tiles[i].tier < 0 || !tiles[i].rendered) {
+            continue;
+        }
+        const LightTile& tile = tiles[i];
+        int faceSize = tiers[tile.tier].faceSize;
+        glm::ivec2 origin = tileOrigin(tile.tier, tile.slot);
+        for (int face = 0; face < FACE_COUNT; face++) {
+            record.faceMatrices[face] = tile.faceMatrices[face];
+        }
+        record.tileRect = glm::vec4(float(origin.x) / ATLAS_WIDTH, float(origin.y) / ATLAS_HEIGHT,
+                                    float(faceSize) / ATLAS_WIDTH, float(faceSize) / ATLAS_HEIGHT);
+        // A texel spans 2 / faceSize world units per unit of distance along the face axis
+        record.params = glm::vec4(1.0f, 2.0f / faceSize, 0.0f, 0.0f);
+    }
+}
+
+void PointShadowAtlas::bindTexture(GLStateCache& glState, GLenum unit) const {
+    glState.activeTexture(unit);
+    glState.bindTexture(GL_TEXTURE_2D, atlasTexture);
+}
+
+void PointShadowAtlas::endFrame() {
+    lastStats = stats;
+    stats = PointShadowStats();
+}
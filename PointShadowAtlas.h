@@ -0,0 +1,124 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class GLStateCache;
+
+// What the last frame's point shadow pass did
+struct PointShadowStats {
+    static const int TIER_COUNT = 3;
+
+    uint32_t budget = 0;               // tiles that may be redrawn per frame
+    uint32_t tilesRendered = 0;        // tiles redrawn this frame (6 faces each)
+    uint32_t tilesReused = 0;          // tiles whose light and casters were unchanged
+    uint32_t tilesPending = 0;         // stale tiles left for a later frame by the budget
+    uint32_t tilesAllocated = 0;       // tiles handed to a light or moved to another tier
+    uint32_t shadowedLights = 0;       // lights holding a tile
+    uint32_t unshadowedLights = 0;     // visible lights that found no free tile
+    uint32_t tierTiles[TIER_COUNT] = {};
+    uint32_t casterDraws = 0;
+    float occupancy = 0.0f;            // fraction of the atlas area held by tiles
+};
+
+// A point light that wants a shadow; index i is light i of the light buffer
+struct PointShadowCaster {
+    glm::vec3 position = glm::vec3(0.0f);
+    float radius = 0.0f;
+    uint64_t casterHash = 0;    // order-independent hash of the casters inside the radius
+    bool enabled = false;       // lights without a shadow (the main light) leave this off
+};
+
+// A tile the renderer has to redraw this frame
+struct PointShadowUpdate {
+    int light = 0;
+    glm::mat4 faceViewProjections[6];
+};
+
+// Per-light record read by tiled_forward_fragment.glsl (std430, PointShadowBuffer)
+struct PointShadowData {
+    glm::mat4 faceMatrices[6];    // world to atlas coordinates and depth, per cube face
+    glm::vec4 tileRect;           // xy atlas origin of the tile, zw size of one face
+    glm::vec4 params;             // x 1 if the tile holds a shadow, y face texel angle
+};
+
+// Shadow atlas for the tiled path's point lights. Each shadowed light owns a tile of six cube
+// faces (3x2) in one depth texture; tiles come in three face sizes, and lights are handed
+// tiles in order of their projected size on screen, dropping to a smaller tier when a pool is
+// full. A tile is only redrawn when its light moved, the casters inside its radius changed or
+// it was newly allocated, and no more than the update budget of tiles is redrawn per frame:
+// stale tiles wait their turn by importance times frames waited, and keep showing the shadow
+// they were last rendered with in the meantime.
+class PointShadowAtlas {
+public:
+    static const int ATLAS_WIDTH = 3072;
+    static const int ATLAS_HEIGHT = 2048;
+    static const int TIER_COUNT = PointShadowStats::TIER_COUNT;
+    static const int FACE_COUNT = 6;
+
+    PointShadowAtlas();
+
+    bool initialize(GLStateCache& glState);
+    void cleanup();
+    bool isInitialized() const { return atlasTexture != 0; }
+
+    void setUpdateBudget(int tiles) { updateBudget = tiles > 0 ? tiles : 1; }
+    int getUpdateBudget() const { return updateBudget; }
+
+    // Hands out tiles by importance (projected size through view and projection on a viewport
+    // viewportHeight pixels tall) and picks the tiles due this frame, at most the budget
+    void scheduleUpdates(const glm::mat4& view, const glm::mat4& projection, float viewportHeight,
+                         const std::vector<PointShadowCaster>& lights, std::vector<PointShadowUpdate>& updates);
+
+    // Render target for one face of a scheduled tile: sets viewport and scissor, clears the face
+    void beginFace(GLStateCache& glState, const PointShadowUpdate& update, int face);
+    // Ends the pass (scissor off); the updated tiles are sampled from the next upload on
+    void endUpdates(GLStateCache& glState);
+
+    // One record per light, in light buffer order
+    void buildShaderData(size_t lightCount, std::vector<PointShadowData>& data) const;
+    void bindTexture(GLStateCache& glState, GLenum unit) const;
+
+    PointShadowStats& frameStats() { return stats; }
+    const PointShadowStats& getStats() const { return lastStats; }
+    void endFrame();
+
+private:
+    struct Tier {
+        int faceSize;
+        int originY;        // tiles of a tier fill a band of the atlas, row by row
+        int columns;
+        int rows;
+        float minImportance;    // projected radius in pixels a light needs for this tier
+        std::vector<int> freeSlots;
+    };
+
+    struct LightTile {
+        int tier = -1;
+        int slot = -1;
+        bool rendered = false;
+        glm::vec3 renderedPosition = glm::vec3(0.0f);
+        float renderedRadius = 0.0f;
+        uint64_t renderedCasterHash = 0;
+        glm::mat4 faceMatrices[FACE_COUNT];    // as last rendered
+        float importance = 0.0f;
+        uint32_t framesStale = 0;
+    };
+
+    void releaseTile(LightTile& tile);
+    glm::ivec2 tileOrigin(int tier, int slot) const;
+    int tierFor(float importance, int currentTier) const;
+
+    GLuint atlasTexture;
+    GLuint atlasFBO;
+    int updateBudget;
+    Tier tiers[TIER_COUNT];
+    std::vector<LightTile> tiles;    // per light
+    std::vector<int> order;
+    std::vector<int> dueLights;
+
+    PointShadowStats stats;
+    PointShadowStats lastStats;
+};
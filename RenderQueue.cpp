@@ -0,0 +1,75 @@
+#include "RenderQueue.h"
+#include <algorithm>
+
+uint64_t RenderQueue::makeKey(RenderPass pass, uint32_t program, uint32_t material, float depth, float maxDepth) {
+    float normalized = maxDepth > 0.0f ? std::min(std::max(depth / maxDepth, 0.0f), 1.0f) : 0.0f;
+    uint32_t quantized = static_cast<uint32_t>(static_cast<double>(normalized) * 4294967295.0);
+    if (pass == RenderPass::Transparent) {
+        quantized = ~quantized;
+    }
+
+    return (static_cast<uint64_t>(static_cast<uint32_t>(pass) & 0xF) << 60)
+         | (static_cast<uint64_t>(program & ((1u << PROGRAM_BITS) - 1)) << 48)
+         | (static_cast<uint64_t>(material & ((1u << MATERIAL_BITS) - 1)) << 32)
+         | quantized;
+}
+
+void RenderQueue::sort() {
+    const size_t count = packets.size();
+    if (count < 2) {
+        return;
+    }
+
+    // One read of the keys builds the histograms for all eight byte positions
+    size_t histograms[8][256] = {};
+    for (const DrawPacket& packet : packets) {
+        for (int byte = 0; byte < 8; byte++) {
+            histograms[byte][(packet.key >> (byte * 8)) & 0xFF]++;
+        }
+    }
+
+    scratch.resize(count);
+    DrawPacket* source = packets.data();
+    DrawPacket* destination = scratch.data();
+
+    for (int byte = 0; byte < 8; byte++) {
+        size_t* histogram = histograms[byte];
+
+        // All keys share this byte: the pass would not reorder anything
+        if (histogram[(source[0].key >> (byte * 8)) & 0xFF] == count) {
+            continue;
+        }
+
+        size_t offsets[256];
+        size_t sum = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            offsets[bucket] = sum;
+            sum += histogram[bucket];
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            size_t bucket = (source[i].key >> (byte * 8)) & 0xFF;
+            destination[offsets[bucket]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != packets.data()) {
+        std::copy(source, source + count, packets.data());
+    }
+}
+
+void RenderQueue::countStateChanges(uint32_t& programSwitches, uint32_t& materialSwitches) const {
+    programSwitches = 0;
+    materialSwitches = 0;
+    for (size_t i = 0; i < packets.size(); i++) {
+        uint32_t program = programFromKey(packets[i].key);
+        uint32_t material = materialFromKey(packets[i].key);
+        if (i == 0 || program != programFromKey(packets[i - 1].key)) {
+            programSwitches++;
+            materialSwitches++;
+        } else if (material != materialFromKey(packets[i - 1].key)) {
+            materialSwitches++;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Render passes in submission order (top bits of the sort key)
+enum class RenderPass : uint32_t {
+    Opaque = 0,
+    Transparent = 1
+};
+
+// One queued draw: the sort key and an index the submitter resolves to the object
+struct DrawPacket {
+    uint64_t key;
+    uint32_t objectIndex;
+};
+
+// Per-frame submission statistics
+struct RenderQueueStats {
+    uint32_t drawCount = 0;
+    uint32_t programSwitches = 0;
+    uint32_t materialSwitches = 0;
+    uint32_t unsortedProgramSwitches = 0;  // what container order would have cost
+    uint32_t unsortedMaterialSwitches = 0;
+};
+
+// Draw packets sorted by a 64-bit key so consecutive draws share state:
+//   [63..60] pass  [59..48] program  [47..32] material  [31..0] quantized view depth
+// Opaque depth sorts front to back for early-Z; transparent depth is inverted (back to front).
+class RenderQueue {
+public:
+    static const int PROGRAM_BITS = 12;
+    static const int MATERIAL_BITS = 16;
+
+    static uint64_t makeKey(RenderPass pass, uint32_t program, uint32_t material, float depth, float maxDepth);
+    static uint32_t programFromKey(uint64_t key) { return static_cast<uint32_t>(key >> 48) & ((1u << PROGRAM_BITS) - 1); }
+    static uint32_t materialFromKey(uint64_t key) { return static_cast<uint32_t>(key >> 32) & ((1u << MATERIAL_BITS) - 1); }
+
+    void clear() { packets.clear(); }
+    void reserve(size_t count) { packets.reserve(count); }
+    void push(uint64_t key, uint32_t objectIndex) { packets.push_back({key, objectIndex}); }
+
+    // LSD radix sort (8 bits per pass); passes where every key has the same byte are skipped
+    void sort();
+
+    const std::vector<DrawPacket>& getPackets() const { return packets; }
+    size_t size() const { return packets.size(); }
+
+    // Program/material transitions in the current packet order
+    void countStateChanges(uint32_t& programSwitches, uint32_t& materialSwitches) const;
+
+private:
+    std::vector<DrawPacket> packets;
+    std::vector<DrawPacket> scratch;
+};
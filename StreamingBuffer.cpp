@@ -0,0 +1,226 @@
+#include "StreamingBuffer.h"
+#include "GLStateCache.h"
+#include <iostream>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+
+// GL 4.4 enums not in the GL 3.3 GLAD header
+namespace {
+    const GLbitfield GL_MAP_PERSISTENT_BIT_LOCAL = 0x0040;
+    const GLbitfield GL_MAP_COHERENT_BIT_LOCAL = 0x0080;
+
+    // Regions start at multiples of this, so region-relative alignment is absolute alignment
+    const GLsizeiptr REGION_GRANULARITY = 64 * 1024;
+    const GLuint64 FENCE_TIMEOUT_NS = 1000000000ull;
+
+    GLsizeiptr alignUp(GLsizeiptr value, GLsizeiptr alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+StreamingBuffer::StreamingBuffer()
+    : bufferStorage(nullptr)
+    , buffer(0)
+    , regionSize(0)
+    , mappedData(nullptr)
+    , region(0)
+    , head(0)
+    , regionAcquired(false)
+    , currentFrameBytes(0)
+    , currentFrameUploads(0)
+{
+    for (GLsync& fence : regionFences) {
+        fence = nullptr;
+    }
+}
+
+bool StreamingBuffer::initialize(GLStateCache& glState, GLsizeiptr initialRegionSize,
+                                 PFNGLBUFFERSTORAGEPROC_LOCAL bufferStorageProc) {
+    bufferStorage = bufferStorageProc;
+    if (!createStorage(glState, initialRegionSize)) {
+        return false;
+    }
+    std::cout << "Streaming buffer: " << REGION_COUNT << " x " << regionSize / 1024 << " KB regions, "
+              << (isPersistent() ? "persistent coherent mapping" : "unsynchronized mapping per upload") << std::endl;
+    return true;
+}
+
+bool StreamingBuffer::createStorage(GLStateCache& glState, GLsizeiptr newRegionSize) {
+    // The old buffer may still be read by queued commands; it is deleted once its fence signals
+    if (buffer) {
+        retiredBuffers.push_back({ buffer, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+        buffer = 0;
+        mappedData = nullptr;
+    }
+    for (GLsync& fence : regionFences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    regionSize = alignUp(std::max(newRegionSize, REGION_GRANULARITY), REGION_GRANULARITY);
+    GLsizeiptr totalSize = regionSize * REGION_COUNT;
+
+    glGenBuffers(1, &buffer);
+    glState.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    if (bufferStorage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT_LOCAL | GL_MAP_COHERENT_BIT_LOCAL;
+        bufferStorage(GL_COPY_WRITE_BUFFER, totalSize, nullptr, flags);
+        mappedData = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, totalSize, flags));
+        if (!mappedData) {
+            // Immutable storage can't be respecified; start over with a mutable buffer
+            std::cerr << "Persistent mapping failed - streaming buffer falls back to unsynchronized mapping" << std::endl;
+            glState.bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            glDeleteBuffers(1, &buffer);
+            glGenBuffers(1, &buffer);
+            glState.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            bufferStorage = nullptr;
+        }
+    }
+    if (!bufferStorage) {
+        glBufferData(GL_COPY_WRITE_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+    }
+    GLint64 allocatedSize = 0;
+    glGetBufferParameteri64v(GL_COPY_WRITE_BUFFER, GL_BUFFER_SIZE, &allocatedSize);
+    glState.bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if (allocatedSize < totalSize) {
+        std::cerr << "Failed to allocate " << totalSize / 1024 << " KB streaming buffer" << std::endl;
+        return false;
+    }
+
+    // A fresh buffer has nothing in flight
+    region = 0;
+    head = 0;
+    regionAcquired = true;
+    return true;
+}
+
+void StreamingBuffer::cleanup() {
+    for (GLsync& fence : regionFences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (buffer) {
+        // Deleting the buffer also releases the persistent mapping
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+        mappedData = nullptr;
+    }
+    releaseRetiredBuffers(true);
+}
+
+StreamingAllocation StreamingBuffer::upload(GLStateCache& glState, const void* data, size_t bytes, size_t alignment) {
+    StreamingAllocation allocation;
+    if (!buffer || bytes == 0) {
+        return allocation;
+    }
+    GLsizeiptr size = static_cast<GLsizeiptr>(bytes);
+    GLsizeiptr align = std::max<GLsizeiptr>(static_cast<GLsizeiptr>(alignment), 1);
+
+    if (!regionAcquired) {
+        acquireRegion();
+    }
+    GLsizeiptr offset = alignUp(head, align);
+    if (offset + size > regionSize) {
+        if (size + align > regionSize) {
+            stats.growths++;
+            std::cout << "Streaming buffer: growing for a " << size / 1024 << " KB upload" << std::endl;
+            if (!createStorage(glState, std::max(regionSize * 2, size + align))) {
+                return allocation;
+            }
+        } else {
+            advanceRegion();
+            acquireRegion();
+        }
+        offset = alignUp(head, align);
+    }
+
+    GLintptr absoluteOffset = region * regionSize + offset;
+    auto copyStart = std::chrono::steady_clock::now();
+    if (mappedData) {
+        std::memcpy(mappedData + absoluteOffset, data, bytes);
+    } else {
+        glState.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        void* destination = glMapBufferRange(GL_COPY_WRITE_BUFFER, absoluteOffset, size,
+                                             GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+        if (destination) {
+            std::memcpy(destination, data, bytes);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        }
+        glState.bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        if (!destination) {
+            return allocation;
+        }
+    }
+    stats.totalCopySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - copyStart).count();
+    stats.totalBytes += bytes;
+    currentFrameBytes += bytes;
+    currentFrameUploads++;
+
+    head = offset + size;
+    allocation.buffer = buffer;
+    allocation.offset = absoluteOffset;
+    allocation.size = size;
+    return allocation;
+}
+
+void StreamingBuffer::endFrame(GLStateCache& glState) {
+    if (!buffer) {
+        return;
+    }
+    // A frame without uploads keeps its region
+    if (regionAcquired && head > 0) {
+        advanceRegion();
+    }
+
+    stats.frameBytes = currentFrameBytes;
+    stats.frameUploads = currentFrameUploads;
+    currentFrameBytes = 0;
+    currentFrameUploads = 0;
+
+    if (!retiredBuffers.empty()) {
+        releaseRetiredBuffers(false);
+        glState.invalidate();
+    }
+}
+
+void StreamingBuffer::advanceRegion() {
+    regionFences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    region = (region + 1) % REGION_COUNT;
+    head = 0;
+    regionAcquired = false;
+}
+
+void StreamingBuffer::acquireRegion() {
+    GLsync& fence = regionFences[region];
+    if (fence) {
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            stats.fenceWaits++;
+            do {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS);
+            } while (status == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    regionAcquired = true;
+}
+
+void StreamingBuffer::releaseRetiredBuffers(bool wait) {
+    auto idle = [wait](const RetiredBuffer& retired) {
+        GLenum status = glClientWaitSync(retired.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? FENCE_TIMEOUT_NS : 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            return false;
+        }
+        glDeleteSync(retired.fence);
+        glDeleteBuffers(1, &retired.buffer);
+        return true;
+    };
+    retiredBuffers.erase(std::remove_if(retiredBuffers.begin(), retiredBuffers.end(), idle), retiredBuffers.end());
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class GLStateCache;
+
+// glBufferStorage (GL 4.4 / ARB_buffer_storage) is not in the GL 3.3 GLAD header
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC_LOCAL)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+// Where an upload landed; bind buffer at offset (vertex attributes, SSBO ranges)
+struct StreamingAllocation {
+    GLuint buffer = 0;
+    GLintptr offset = 0;
+    GLsizeiptr size = 0;
+};
+
+// Upload counters: the last completed frame and the running totals behind the throughput
+struct StreamingBufferStats {
+    uint64_t frameBytes = 0;
+    uint32_t frameUploads = 0;
+    uint64_t totalBytes = 0;
+    double totalCopySeconds = 0.0;    // CPU time spent writing uploads
+    uint32_t fenceWaits = 0;          // region reuses that had to wait for the GPU
+    uint32_t growths = 0;
+
+    double throughputMBps() const { return totalCopySeconds > 0.0 ? totalBytes / totalCopySeconds / 1.0e6 : 0.0; }
+};
+
+// One buffer for all per-frame dynamic data (instances, lights, overlay vertices), split into
+// REGION_COUNT frame regions. Each frame bump-allocates from its region and endFrame() fences it;
+// a region is only written again after its fence signaled, so uploads never race the GPU and,
+// with REGION_COUNT frames of latency, practically never wait. With GL 4.4 / ARB_buffer_storage
+// the buffer is mapped once, persistent and coherent, and uploads are plain memcpys; otherwise
+// each upload maps its range unsynchronized, which the fences make safe as well.
+class StreamingBuffer {
+public:
+    static const int REGION_COUNT = 3;
+
+    StreamingBuffer();
+
+    // bufferStorage may be null (unsynchronized-map fallback)
+    bool initialize(GLStateCache& glState, GLsizeiptr regionSize, PFNGLBUFFERSTORAGEPROC_LOCAL bufferStorage);
+    void cleanup();
+    bool isInitialized() const { return buffer != 0; }
+    bool isPersistent() const { return mappedData != nullptr; }
+
+    // Copies bytes into the current region. alignment is the offset alignment the binding needs
+    // (1 for vertex data, GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT for SSBO ranges). A region that
+    // runs out moves on to the next one; an upload larger than a region grows the buffer.
+    StreamingAllocation upload(GLStateCache& glState, const void* data, size_t bytes, size_t alignment);
+
+    // Fences the current region and moves to the next one; deletes buffers retired by growth
+    void endFrame(GLStateCache& glState);
+
+    const StreamingBufferStats& getStats() const { return stats; }
+
+private:
+    struct RetiredBuffer {
+        GLuint buffer;
+        GLsync fence;
+    };
+
+    bool createStorage(GLStateCache& glState, GLsizeiptr newRegionSize);
+    void advanceRegion();
+    // Waits (counting the wait) until the GPU is done with the current region
+    void acquireRegion();
+    void releaseRetiredBuffers(bool wait);
+
+    PFNGLBUFFERSTORAGEPROC_LOCAL bufferStorage;
+    GLuint buffer;
+    GLsizeiptr regionSize;
+    uint8_t* mappedData;    // persistent mapping, null in the fallback path
+
+    int region;
+    GLsizeiptr head;        // next free byte in the current region
+    bool regionAcquired;
+    GLsync regionFences[REGION_COUNT];
+    std::vector<RetiredBuffer> retiredBuffers;    // replaced by growth, deleted once idle
+
+    StreamingBufferStats stats;
+    uint64_t currentFrameBytes;
+    uint32_t currentFrameUploads;
+};
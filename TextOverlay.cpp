@@ -0,0 +1,272 @@
+#include "TextOverlay.h"
+#include "GLStateCache.h"
+#include "StreamingBuffer.h"
+#include <iostream>
+#include <algorithm>
+#include <cstddef>
+
+namespace {
+    // Printable ASCII (32-126), one byte per row with the leftmost pixel in the high bit;
+    // rasterized from DejaVu Sans Mono at 11 px
+    const int FIRST_GLYPH = 32;
+    const int GLYPH_COUNT = 95;
+    const uint8_t FONT_GLYPHS[GLYPH_COUNT][TextOverlay::GLYPH_HEIGHT] = {
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // space
+        { 0x00, 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00 }, // !
+        { 0x00, 0x00, 0x28, 0x28, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // "
+        { 0x00, 0x00, 0x14, 0x24, 0x7E, 0x28, 0x28, 0xFC, 0x50, 0x50, 0x00, 0x00, 0x00 }, // #
+        { 0x00, 0x00, 0x10, 0x3C, 0x50, 0x50, 0x38, 0x14, 0x14, 0x78, 0x10, 0x10, 0x00 }, // $
+        { 0x00, 0x00, 0x60, 0x90, 0x64, 0x08, 0x20, 0x5C, 0x14, 0x1C, 0x00, 0x00, 0x00 }, // %
+        { 0x00, 0x00, 0x38, 0x40, 0x60, 0x60, 0x54, 0x8C, 0xCC, 0x7C, 0x00, 0x00, 0x00 }, // &
+        { 0x00, 0x00, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '
+        { 0x00, 0x08, 0x10, 0x10, 0x30, 0x20, 0x20, 0x30, 0x10, 0x10, 0x08, 0x00, 0x00 }, // (
+        { 0x00, 0x20, 0x30, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x30, 0x20, 0x00, 0x00 }, // )
+        { 0x00, 0x00, 0x10, 0x54, 0x38, 0x38, 0x54, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00 }, // *
+        { 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0xFC, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00 }, // +
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x20, 0x00, 0x00 }, // ,
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // -
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00 }, // .
+        { 0x00, 0x00, 0x0C, 0x08, 0x08, 0x10, 0x10, 0x20, 0x20, 0x40, 0x40, 0x00, 0x00 }, // /
+        { 0x00, 0x00, 0x38, 0x6C, 0x44, 0x44, 0x54, 0x44, 0x6C, 0x38, 0x00, 0x00, 0x00 }, // 0
+        { 0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7C, 0x00, 0x00, 0x00 }, // 1
+        { 0x00, 0x00, 0x78, 0x4C, 0x0C, 0x08, 0x10, 0x30, 0x60, 0x7C, 0x00, 0x00, 0x00 }, // 2
+        { 0x00, 0x00, 0x38, 0x4C, 0x0C, 0x38, 0x0C, 0x04, 0x4C, 0x78, 0x00, 0x00, 0x00 }, // 3
+        { 0x00, 0x00, 0x18, 0x18, 0x28, 0x48, 0x48, 0xFC, 0x08, 0x08, 0x00, 0x00, 0x00 }, // 4
+        { 0x00, 0x00, 0x78, 0x40, 0x40, 0x78, 0x0C, 0x04, 0x0C, 0x78, 0x00, 0x00, 0x00 }, // 5
+        { 0x00, 0x00, 0x38, 0x60, 0x40, 0x78, 0x4C, 0x44, 0x4C, 0x38, 0x00, 0x00, 0x00 }, // 6
+        { 0x00, 0x00, 0x7C, 0x08, 0x08, 0x08, 0x10, 0x10, 0x30, 0x20, 0x00, 0x00, 0x00 }, // 7
+        { 0x00, 0x00, 0x38, 0x4C, 0x4C, 0x38, 0x4C, 0x44, 0x4C, 0x38, 0x00, 0x00, 0x00 }, // 8
+        { 0x00, 0x00, 0x38, 0x4C, 0x44, 0x4C, 0x3C, 0x04, 0x08, 0x78, 0x00, 0x00, 0x00 }, // 9
+        { 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00 }, // :
+        { 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x10, 0x10, 0x20, 0x00, 0x00 }, // ;
+        { 0x00, 0x00, 0x00, 0x00, 0x04, 0x38, 0xC0, 0x38, 0x04, 0x00, 0x00, 0x00, 0x00 }, // <
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0xFC, 0x00, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00 }, // =
+        { 0x00, 0x00, 0x00, 0x00, 0xC0, 0x38, 0x0C, 0x38, 0xC0, 0x00, 0x00, 0x00, 0x00 }, // >
+        { 0x00, 0x00, 0x78, 0x0C, 0x08, 0x10, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00 }, // ?
+        { 0x00, 0x00, 0x38, 0x44, 0x44, 0x9C, 0xA4, 0xA4, 0x9C, 0x40, 0x60, 0x38, 0x00 }, // @
+        { 0x00, 0x00, 0x30, 0x30, 0x28, 0x28, 0x48, 0x7C, 0x44, 0xC4, 0x00, 0x00, 0x00 }, // A
+        { 0x00, 0x00, 0x78, 0x4C, 0x4C, 0x78, 0x44, 0x44, 0x44, 0x78, 0x00, 0x00, 0x00 }, // B
+        { 0x00, 0x00, 0x38, 0x64, 0x40, 0x40, 0x40, 0x40, 0x64, 0x38, 0x00, 0x00, 0x00 }, // C
+        { 0x00, 0x00, 0x70, 0x48, 0x44, 0x44, 0x44, 0x44, 0x48, 0x70, 0x00, 0x00, 0x00 }, // D
+        { 0x00, 0x00, 0x7C, 0x40, 0x40, 0x7C, 0x40, 0x40, 0x40, 0x7C, 0x00, 0x00, 0x00 }, // E
+        { 0x00, 0x00, 0x7C, 0x40, 0x40, 0x7C, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00 }, // F
+        { 0x00, 0x00, 0x38, 0x64, 0x40, 0x40, 0x4C, 0x44, 0x64, 0x38, 0x00, 0x00, 0x00 }, // G
+        { 0x00, 0x00, 0x44, 0x44, 0x44, 0x7C, 0x44, 0x44, 0x44, 0x44, 0x00, 0x00, 0x00 }, // H
+        { 0x00, 0x00, 0x7C, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7C, 0x00, 0x00, 0x00 }, // I
+        { 0x00, 0x00, 0x38, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x70, 0x00, 0x00, 0x00 }, // J
+        { 0x00, 0x00, 0x44, 0x48, 0x50, 0x70, 0x50, 0x48, 0x4C, 0x44, 0x00, 0x00, 0x00 }, // K
+        { 0x00, 0x00, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7C, 0x00, 0x00, 0x00 }, // L
+        { 0x00, 0x00, 0xCC, 0xEC, 0xEC, 0xF4, 0xD4, 0xC4, 0xC4, 0xC4, 0x00, 0x00, 0x00 }, // M
+        { 0x00, 0x00, 0x44, 0x64, 0x64, 0x54, 0x54, 0x5C, 0x4C, 0x4C, 0x00, 0x00, 0x00 }, // N
+        { 0x00, 0x00, 0x38, 0x4C, 0x44, 0x44, 0x44, 0x44, 0x4C, 0x38, 0x00, 0x00, 0x00 }, // O
+        { 0x00, 0x00, 0x78, 0x4C, 0x44, 0x4C, 0x78, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00 }, // P
+        { 0x00, 0x00, 0x38, 0x4C, 0x44, 0x44, 0x44, 0x44, 0x4C, 0x38, 0x08, 0x00, 0x00 }, // Q
+        { 0x00, 0x00, 0x78, 0x4C, 0x4C, 0x4C, 0x78, 0x48, 0x44, 0x44, 0x00, 0x00, 0x00 }, // R
+        { 0x00, 0x00, 0x38, 0x40, 0x40, 0x60, 0x18, 0x04, 0x4C, 0x78, 0x00, 0x00, 0x00 }, // S
+        { 0x00, 0x00, 0xFC, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 }, // T
+        { 0x00, 0x00, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x4C, 0x38, 0x00, 0x00, 0x00 }, // U
+        { 0x00, 0x00, 0xC4, 0x44, 0x4C, 0x48, 0x28, 0x28, 0x30, 0x30, 0x00, 0x00, 0x00 }, // V
+        { 0x00, 0x00, 0x86, 0x84, 0x94, 0xF4, 0x64, 0x6C, 0x6C, 0x4C, 0x00, 0x00, 0x00 }, // W
+        { 0x00, 0x00, 0x44, 0x68, 0x28, 0x10, 0x30, 0x28, 0x4C, 0xC4, 0x00, 0x00, 0x00 }, // X
+        { 0x00, 0x00, 0xC4, 0x4C, 0x28, 0x30, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 }, // Y
+        { 0x00, 0x00, 0x7C, 0x04, 0x08, 0x10, 0x10, 0x20, 0x40, 0x7C, 0x00, 0x00, 0x00 }, // Z
+        { 0x00, 0x38, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x38, 0x00, 0x00 }, // [
+        { 0x00, 0x00, 0x40, 0x40, 0x20, 0x20, 0x10, 0x10, 0x08, 0x08, 0x0C, 0x00, 0x00 }, // backslash
+        { 0x00, 0x30, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x30, 0x00, 0x00 }, // ]
+        { 0x00, 0x00, 0x30, 0x28, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // ^
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFE }, // _
+        { 0x00, 0x20, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // `
+        { 0x00, 0x00, 0x00, 0x00, 0x78, 0x0C, 0x7C, 0x44, 0x4C, 0x7C, 0x00, 0x00, 0x00 }, // a
+        { 0x00, 0x40, 0x40, 0x40, 0x78, 0x6C, 0x44, 0x44, 0x6C, 0x78, 0x00, 0x00, 0x00 }, // b
+        { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x60, 0x40, 0x40, 0x60, 0x3C, 0x00, 0x00, 0x00 }, // c
+        { 0x00, 0x04, 0x04, 0x04, 0x3C, 0x4C, 0x4C, 0x4C, 0x4C, 0x3C, 0x00, 0x00, 0x00 }, // d
+        { 0x00, 0x00, 0x00, 0x00, 0x38, 0x44, 0x7C, 0x40, 0x40, 0x3C, 0x00, 0x00, 0x00 }, // e
+        { 0x00, 0x1C, 0x10, 0x10, 0x7C, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 }, // f
+        { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x4C, 0x4C, 0x4C, 0x4C, 0x3C, 0x08, 0x78, 0x00 }, // g
+        { 0x00, 0x40, 0x40, 0x40, 0x78, 0x6C, 0x44, 0x44, 0x44, 0x44, 0x00, 0x00, 0x00 }, // h
+        { 0x00, 0x10, 0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x7C, 0x00, 0x00, 0x00 }, // i
+        { 0x00, 0x10, 0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x70, 0x00 }, // j
+        { 0x00, 0x40, 0x40, 0x40, 0x4C, 0x58, 0x70, 0x78, 0x48, 0x44, 0x00, 0x00, 0x00 }, // k
+        { 0x00, 0x70, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x1C, 0x00, 0x00, 0x00 }, // l
+        { 0x00, 0x00, 0x00, 0x00, 0x7C, 0x54, 0x54, 0x54, 0x54, 0x54, 0x00, 0x00, 0x00 }, // m
+        { 0x00, 0x00, 0x00, 0x00, 0x78, 0x6C, 0x44, 0x44, 0x44, 0x44, 0x00, 0x00, 0x00 }, // n
+        { 0x00, 0x00, 0x00, 0x00, 0x38, 0x4C, 0x44, 0x44, 0x4C, 0x38, 0x00, 0x00, 0x00 }, // o
+        { 0x00, 0x00, 0x00, 0x00, 0x78, 0x6C, 0x44, 0x44, 0x6C, 0x78, 0x40, 0x40, 0x00 }, // p
+        { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x4C, 0x44, 0x44, 0x4C, 0x3C, 0x04, 0x04, 0x00 }, // q
+        { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x30, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00 }, // r
+        { 0x00, 0x00, 0x00, 0x00, 0x38, 0x40, 0x70, 0x18, 0x0C, 0x78, 0x00, 0x00, 0x00 }, // s
+        { 0x00, 0x00, 0x20, 0x20, 0x7C, 0x20, 0x20, 0x20, 0x30, 0x1C, 0x00, 0x00, 0x00 }, // t
+        { 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x44, 0x44, 0x4C, 0x3C, 0x00, 0x00, 0x00 }, // u
+        { 0x00, 0x00, 0x00, 0x00, 0x44, 0x4C, 0x68, 0x28, 0x38, 0x30, 0x00, 0x00, 0x00 }, // v
+        { 0x00, 0x00, 0x00, 0x00, 0x86, 0x84, 0x54, 0x74, 0x6C, 0x68, 0x00, 0x00, 0x00 }, // w
+        { 0x00, 0x00, 0x00, 0x00, 0x4C, 0x28, 0x30, 0x30, 0x68, 0x44, 0x00, 0x00, 0x00 }, // x
+        { 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x28, 0x28, 0x30, 0x10, 0x30, 0x60, 0x00 }, // y
+        { 0x00, 0x00, 0x00, 0x00, 0x7C, 0x08, 0x10, 0x20, 0x20, 0x7C, 0x00, 0x00, 0x00 }, // z
+        { 0x00, 0x1C, 0x10, 0x10, 0x10, 0x60, 0x30, 0x10, 0x10, 0x10, 0x1C, 0x00, 0x00 }, // {
+        { 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00 }, // |
+        { 0x00, 0x60, 0x10, 0x10, 0x10, 0x1C, 0x10, 0x10, 0x10, 0x10, 0x60, 0x00, 0x00 }, // }
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00 }  // ~
+    };
+
+    // Atlas layout: 16 x 6 cells; the cell after '~' is solid and used for rectangles
+    const int ATLAS_COLUMNS = 16;
+    const int ATLAS_ROWS = 6;
+    const int ATLAS_WIDTH = ATLAS_COLUMNS * TextOverlay::GLYPH_WIDTH;
+    const int ATLAS_HEIGHT = ATLAS_ROWS * TextOverlay::GLYPH_HEIGHT;
+    const int SOLID_CELL = GLYPH_COUNT;
+
+    uint32_t packChannel(float value) {
+        return static_cast<uint32_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+    }
+
+    uint32_t packColor(const glm::vec4& color) {
+        return packChannel(color.x) | packChannel(color.y) << 8 | packChannel(color.z) << 16 | packChannel(color.w) << 24;
+    }
+
+    void cellUV(int cell, float& u0, float& v0, float& u1, float& v1) {
+        u0 = static_cast<float>((cell % ATLAS_COLUMNS) * TextOverlay::GLYPH_WIDTH) / ATLAS_WIDTH;
+        v0 = static_cast<float>((cell / ATLAS_COLUMNS) * TextOverlay::GLYPH_HEIGHT) / ATLAS_HEIGHT;
+        u1 = u0 + static_cast<float>(TextOverlay::GLYPH_WIDTH) / ATLAS_WIDTH;
+        v1 = v0 + static_cast<float>(TextOverlay::GLYPH_HEIGHT) / ATLAS_HEIGHT;
+    }
+}
+
+TextOverlay::TextOverlay()
+    : program(0)
+    , vao(0)
+    , atlasTexture(0)
+    , lastQuadCount(0)
+{
+}
+
+bool TextOverlay::initialize(GLuint overlayProgram, GLStateCache& glState) {
+    if (overlayProgram == 0) {
+        std::cerr << "Text overlay shader missing - overlay disabled" << std::endl;
+        return false;
+    }
+    program = overlayProgram;
+
+    // Expand the 1-bit glyphs into the R8 atlas (row 0 of the texture is the top of the cells)
+    std::vector<uint8_t> atlas(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+    for (int cell = 0; cell <= SOLID_CELL; cell++) {
+        int cellX = (cell % ATLAS_COLUMNS) * GLYPH_WIDTH;
+        int cellY = (cell / ATLAS_COLUMNS) * GLYPH_HEIGHT;
+        for (int row = 0; row < GLYPH_HEIGHT; row++) {
+            uint8_t bits = cell == SOLID_CELL ? 0xFF : FONT_GLYPHS[cell][row];
+            for (int column = 0; column < GLYPH_WIDTH; column++) {
+                atlas[(cellY + row) * ATLAS_WIDTH + cellX + column] = (bits & (0x80 >> column)) ? 255 : 0;
+            }
+        }
+    }
+
+    glGenTextures(1, &atlasTexture);
+    glState.activeTexture(GL_TEXTURE0);
+    glState.bindTexture(GL_TEXTURE_2D, atlasTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, atlas.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Attribute pointers are set per frame, where the vertices land in the streaming buffer
+    glGenVertexArrays(1, &vao);
+    glState.bindVertexArray(vao);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+
+    glState.useProgram(program);
+    glUniform1i(glGetUniformLocation(program, "fontAtlas"), 0);
+
+    std::cout << "Text overlay initialized (" << ATLAS_WIDTH << "x" << ATLAS_HEIGHT << " font atlas)" << std::endl;
+    return true;
+}
+
+void TextOverlay::cleanup() {
+    if (vao) {
+        glDeleteVertexArrays(1, &vao);
+        vao = 0;
+    }
+    if (atlasTexture) {
+        glDeleteTextures(1, &atlasTexture);
+        atlasTexture = 0;
+    }
+    if (program) {
+        glDeleteProgram(program);
+        program = 0;
+    }
+    vertices.clear();
+}
+
+void TextOverlay::addQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, uint32_t color) {
+    vertices.push_back({x0, y0, u0, v0, color});
+    vertices.push_back({x1, y0, u1, v0, color});
+    vertices.push_back({x0, y1, u0, v1, color});
+    vertices.push_back({x1, y0, u1, v0, color});
+    vertices.push_back({x1, y1, u1, v1, color});
+    vertices.push_back({x0, y1, u0, v1, color});
+}
+
+void TextOverlay::addRect(float x, float y, float width, float height, const glm::vec4& color) {
+    // Sample the middle of the solid cell so filtering never reaches a neighbour
+    float u0, v0, u1, v1;
+    cellUV(SOLID_CELL, u0, v0, u1, v1);
+    float u = (u0 + u1) * 0.5f;
+    float v = (v0 + v1) * 0.5f;
+    addQuad(x, y, x + width, y + height, u, v, u, v, packColor(color));
+}
+
+float TextOverlay::addText(float x, float y, const char* text, const glm::vec4& color, float scale) {
+    uint32_t packed = packColor(color);
+    float glyphWidth = GLYPH_WIDTH * scale;
+    float glyphHeight = GLYPH_HEIGHT * scale;
+    float penX = x;
+
+    for (const char* c = text; *c; ++c) {
+        if (*c == '\n') {
+            penX = x;
+            y += glyphHeight;
+            continue;
+        }
+        int glyph = static_cast<unsigned char>(*c) - FIRST_GLYPH;
+        if (glyph > 0 && glyph < GLYPH_COUNT) {
+            float u0, v0, u1, v1;
+            cellUV(glyph, u0, v0, u1, v1);
+            addQuad(penX, y, penX + glyphWidth, y + glyphHeight, u0, v0, u1, v1, packed);
+        }
+        penX += glyphWidth;
+    }
+    return penX;
+}
+
+void TextOverlay::render(GLStateCache& glState, StreamingBuffer& streamingBuffer,
+                         unsigned int screenWidth, unsigned int screenHeight) {
+    lastQuadCount = static_cast<uint32_t>(vertices.size() / 6);
+    if (vertices.empty() || !isInitialized()) {
+        vertices.clear();
+        return;
+    }
+
+    StreamingAllocation allocation = streamingBuffer.upload(glState, vertices.data(), vertices.size() * sizeof(Vertex), sizeof(float));
+    if (!allocation.buffer) {
+        vertices.clear();
+        return;
+    }
+
+    glState.bindVertexArray(vao);
+    glState.bindBuffer(GL_ARRAY_BUFFER, allocation.buffer);
+    const char* base = reinterpret_cast<const char*>(allocation.offset);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, x));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, u));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), base + offsetof(Vertex, color));
+
+    glState.useProgram(program);
+    glUniform2f(glGetUniformLocation(program, "screenSize"), static_cast<float>(screenWidth), static_cast<float>(screenHeight));
+    glState.activeTexture(GL_TEXTURE0);
+    glState.bindTexture(GL_TEXTURE_2D, atlasTexture);
+
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
+    vertices.clear();
+}
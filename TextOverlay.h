@@ -0,0 +1,51 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class GLStateCache;
+class StreamingBuffer;
+
+// Screen-space text and rectangles batched into the shared streaming buffer and drawn with a
+// single glDrawArrays. Glyphs come from a baked 8x13 bitmap font (printable ASCII) in an R8
+// atlas; rectangles sample a solid atlas cell so they share the draw call.
+class TextOverlay {
+public:
+    static const int GLYPH_WIDTH = 8;
+    static const int GLYPH_HEIGHT = 13;
+
+    TextOverlay();
+
+    // Takes ownership of program (text_overlay_vertex/fragment.glsl)
+    bool initialize(GLuint program, GLStateCache& glState);
+    void cleanup();
+    bool isInitialized() const { return program != 0; }
+
+    // Queue for the next render(); pixel coordinates from the top-left corner of the screen
+    void addRect(float x, float y, float width, float height, const glm::vec4& color);
+    // Returns the x coordinate after the last glyph; '\n' starts a new line at x
+    float addText(float x, float y, const char* text, const glm::vec4& color, float scale = 1.0f);
+
+    // Uploads and draws everything queued since the last call, then clears the queue
+    void render(GLStateCache& glState, StreamingBuffer& streamingBuffer, unsigned int screenWidth, unsigned int screenHeight);
+
+    uint32_t getLastQuadCount() const { return lastQuadCount; }
+
+private:
+    struct Vertex {
+        float x, y;
+        float u, v;
+        uint32_t color;    // RGBA8, normalized in the vertex fetch
+    };
+
+    void addQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, uint32_t color);
+
+    GLuint program;
+    GLuint vao;
+    GLuint atlasTexture;
+
+    std::vector<Vertex> vertices;    // reused every frame
+    uint32_t lastQuadCount;
+};
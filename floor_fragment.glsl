@@ -12,6 +12,32 @@ uniform vec3 lightColor;
 // Enhanced floor features
 uniform float time;
 
+// Cascaded shadow map of the main light (CascadedShadowMaps); no cascades means unshadowed
+const int MAX_SHADOW_CASCADES = 3;
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 shadowMatrices[MAX_SHADOW_CASCADES];
+uniform float shadowTexelSizes[MAX_SHADOW_CASCADES];
+uniform int shadowCascadeCount;
+
+// Fraction of the main light reaching worldPos, from the finest cascade that covers it
+float mainLightShadow(vec3 worldPos, vec3 normal) {
+    for (int cascade = 0; cascade < shadowCascadeCount; cascade++) {
+        // A normal offset of a texel and a half keeps curved surfaces free of acne
+        vec4 coord = shadowMatrices[cascade] * vec4(worldPos + normal * shadowTexelSizes[cascade] * 1.5, 1.0);
+        if (all(greaterThan(coord.xyz, vec3(0.0))) && all(lessThan(coord.xyz, vec3(1.0)))) {
+            // Four bilinear compare taps, 4x4 texel PCF footprint
+            float texel = 1.0 / float(textureSize(shadowMap, 0).x);
+            float lit = 0.0;
+            lit += texture(shadowMap, vec4(coord.xy + vec2(-texel, -texel), float(cascade), coord.z));
+            lit += texture(shadowMap, vec4(coord.xy + vec2( texel, -texel), float(cascade), coord.z));
+            lit += texture(shadowMap, vec4(coord.xy + vec2(-texel,  texel), float(cascade), coord.z));
+            lit += texture(shadowMap, vec4(coord.xy + vec2( texel,  texel), float(cascade), coord.z));
+            return lit * 0.25;
+        }
+    }
+    return 1.0;
+}
+
 // Calculate Fresnel reflection
 float calculateFresnel(vec3 viewDir, vec3 normal, float ior) {
     float cosTheta = max(dot(viewDir, normal), 0.0);
@@ -68,7 +94,8 @@ void main()
     fogFactor = clamp(fogFactor, 0.0, 1.0);
     
     // Combine all lighting effects
-    vec3 result = (ambient + diffuse + specular) * gridColor + envReflection;
+    float shadow = mainLightShadow(FragPos, norm);
+    vec3 result = (ambient + (diffuse + specular) * shadow) * gridColor + envReflection;
     
     // Apply fog
     vec3 fogColor = vec3(0.7, 0.8, 0.9);
@@ -34,6 +34,32 @@ uniform float roughnessFactor;
 uniform samplerCube skybox;
 uniform bool hasEnvironmentMap;
 
+// Cascaded shadow map of the main light (CascadedShadowMaps); no cascades means unshadowed
+const int MAX_SHADOW_CASCADES = 3;
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 shadowMatrices[MAX_SHADOW_CASCADES];
+uniform float shadowTexelSizes[MAX_SHADOW_CASCADES];
+uniform int shadowCascadeCount;
+
+// Fraction of the main light reaching worldPos, from the finest cascade that covers it
+float mainLightShadow(vec3 worldPos, vec3 normal) {
+    for (int cascade = 0; cascade < shadowCascadeCount; cascade++) {
+        // A normal offset of a texel and a half keeps curved surfaces free of acne
+        vec4 coord = shadowMatrices[cascade] * vec4(worldPos + normal * shadowTexelSizes[cascade] * 1.5, 1.0);
+        if (all(greaterThan(coord.xyz, vec3(0.0))) && all(lessThan(coord.xyz, vec3(1.0)))) {
+            // Four bilinear compare taps, 4x4 texel PCF footprint
+            float texel = 1.0 / float(textureSize(shadowMap, 0).x);
+            float lit = 0.0;
+            lit += texture(shadowMap, vec4(coord.xy + vec2(-texel, -texel), float(cascade), coord.z));
+            lit += texture(shadowMap, vec4(coord.xy + vec2( texel, -texel), float(cascade), coord.z));
+            lit += texture(shadowMap, vec4(coord.xy + vec2(-texel,  texel), float(cascade), coord.z));
+            lit += texture(shadowMap, vec4(coord.xy + vec2( texel,  texel), float(cascade), coord.z));
+            return lit * 0.25;
+        }
+    }
+    return 1.0;
+}
+
 // Calculate Fresnel reflection
 float calculateFresnel(vec3 viewDir, vec3 normal, float ior) {
     float cosTheta = max(dot(viewDir, normal), 0.0);
@@ -42,7 +68,7 @@ float calculateFresnel(vec3 viewDir, vec3 normal, float ior) {
 }
 
 // Enhanced PBR-like shading
-vec3 calculateEnhancedShading(vec3 albedo, vec3 normal, vec3 viewDir, vec3 lightDir, float metallic, float roughness) {
+vec3 calculateEnhancedShading(vec3 albedo, vec3 normal, vec3 viewDir, vec3 lightDir, float metallic, float roughness, float shadow) {
     // Ambient
     vec3 ambient = 0.03 * albedo * (1.0 - ambientOcclusion);
     
@@ -82,7 +108,7 @@ vec3 calculateEnhancedShading(vec3 albedo, vec3 normal, vec3 viewDir, vec3 light
     vec3 kD = vec3(1.0) - kS;
     kD *= 1.0 - metallic;
     
-    return ambient + (kD * diffuse + specular) * NdotL;
+    return ambient + (kD * diffuse + specular) * NdotL * shadow;
 }
 
 void main()
@@ -90,6 +116,7 @@ void main()
     vec3 norm = normalize(Normal);
     vec3 lightDir = normalize(lightPos - FragPos);
     vec3 viewDir = normalize(viewPos - FragPos);
+    float shadow = mainLightShadow(FragPos, norm);
     
     if (useMaterial) {
         // Enhanced material-based rendering
@@ -103,7 +130,8 @@ void main()
                 viewDir, 
                 lightDir, 
                 metallicFactor, 
-                roughnessFactor
+                roughnessFactor,
+                shadow
             );
             
             // Add environment reflections for metallic surfaces
@@ -124,7 +152,7 @@ void main()
             float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
             vec3 specular = lightColor * (spec * material.specular);
             
-            result = ambient + diffuse + specular;
+            result = ambient + (diffuse + specular) * shadow;
         }
         
         // Apply ambient occlusion
@@ -164,7 +192,7 @@ void main()
         }
 
         // Combine results with ambient occlusion
-        vec3 result = (ambient + diffuse + specular) * objectColor;
+        vec3 result = (ambient + (diffuse + specular) * shadow) * objectColor;
         result *= (1.0 - ambientOcclusion * 0.3);
         
         FragColor = vec4(result, 1.0);
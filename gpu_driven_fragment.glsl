@@ -0,0 +1,24 @@
+#version 430 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+flat in vec3 ObjectColor;
+
+uniform vec3 lightPos;
+uniform vec3 viewPos;
+uniform vec3 lightColor;
+
+void main()
+{
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    
+    vec3 ambient = 0.2 * lightColor;
+    vec3 diffuse = max(dot(norm, lightDir), 0.0) * lightColor;
+    vec3 specular = 0.5 * pow(max(dot(norm, halfwayDir), 0.0), 32.0) * lightColor;
+    
+    FragColor = vec4((ambient + diffuse + specular) * ObjectColor, 1.0);
+}
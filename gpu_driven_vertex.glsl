@@ -0,0 +1,25 @@
+#version 430 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+
+// Per-instance object data, fetched at the draw's baseInstance
+layout (location = 3) in vec4 aCenterRadius;
+layout (location = 4) in vec4 aColor;
+
+out vec3 FragPos;
+out vec3 Normal;
+flat out vec3 ObjectColor;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    // Sphere mesh has radius 0.5
+    FragPos = aCenterRadius.xyz + aPos * (aCenterRadius.w * 2.0);
+    Normal = aNormal;
+    ObjectColor = aColor.rgb;
+    
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
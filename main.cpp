@@ -2,12 +2,22 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
 #include <iostream>
 
 #include "GraphicsManager.h"
 #include "MaterialSystem.h"
 #include "PhysicsManager.h"
 #include "InputManager.h"
+#include "Benchmarks.h"
+#include "CpuProfiler.h"
+#include "HeadlessContext.h"
+#include "BenchmarkScript.h"
+#include <string>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
 
 // Application settings
 const unsigned int SCR_WIDTH = 800;
@@ -33,6 +43,9 @@ struct AppState {
     // Lighting
     glm::vec3 lightPos = glm::vec3(1.2f, 1.0f, 2.0f);
     glm::vec3 lightColor = glm::vec3(1.0f, 1.0f, 1.0f);
+    // Point lights around the scene for the Forward+ path (--point-lights); every fourth orbits
+    int pointLightCount = 0;
+    std::vector<PointLight> pointLights;
     
     // Timing
     float deltaTime = 0.0f;
@@ -42,6 +55,10 @@ struct AppState {
     float fps = 0.0f;
     float fpsUpdateTimer = 0.0f;
     int frameCount = 0;
+    
+    // CPU trace written by the T key and, with --trace, on exit
+    std::string tracePath = "vibe3d_trace.json";
+    bool exportTraceOnExit = false;
 };
 
 // Manager instances
@@ -54,40 +71,152 @@ InputManager* input = nullptr;
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 bool initializeApplication();
 void cleanupApplication();
-void updateApplication(GLFWwindow* window, AppState& state);
+void updateApplication(GLFWwindow* window, AppState& state, bool processInput);
+bool handleInput(GLFWwindow* window, AppState& state);
+bool applyRenderMode(const std::string& mode, AppState& state);
+void applyBenchmarkFrame(const BenchmarkScript& script, AppState& state, float previousTime, float time);
+void updatePointLights(AppState& state);
 void renderApplication(const AppState& state);
 void printApplicationInfo();
 std::vector<RTSphere> buildRaytracingScene(const AppState& state);
 
-int main() {
-    // Initialize GLFW
-    if (!glfwInit()) {
-        std::cerr << "Failed to initialize GLFW" << std::endl;
+int main(int argc, char** argv) {
+    // Command line options
+    int sphereBenchmarkCount = 0;
+    int transparencyBenchmarkCount = 0;
+    int cullingValidationCount = 0;
+    int raytracingNoiseSamples = 0;
+    int raytracingDispatchFrames = 0;
+    std::string tracePath;
+    bool headless = false;
+    int headlessFrames = 300;
+    std::string renderMode;
+    std::string screenshotPath;
+    std::string benchmarkPath;
+    std::string benchmarkOutputPath = "benchmark_results.json";
+    std::string recordInputPath;
+    std::string replayInputPath;
+    std::string capturePath;
+    bool shadows = true;
+    int pointLightCount = 0;
+    int shadowBudget = 4;
+    std::string raytracingSamplerName;
+    int denoiseIterations = -1;    // -1 keeps the default
+    int raytracingSamples = 1;
+    float adaptiveThreshold = -1.0f;    // below 0 keeps the default
+    int persistentGroups = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--microbench" && i + 1 < argc) {
+            return Benchmarks::run(argv[++i]) ? 0 : 1;
+        } else if (arg == "--sphere-bench" && i + 1 < argc) {
+            sphereBenchmarkCount = std::stoi(argv[++i]);
+        } else if (arg == "--oit-bench" && i + 1 < argc) {
+            transparencyBenchmarkCount = std::stoi(argv[++i]);
+        } else if (arg == "--cull-test" && i + 1 < argc) {
+            cullingValidationCount = std::stoi(argv[++i]);
+        } else if (arg == "--rt-noise-bench" && i + 1 < argc) {
+            raytracingNoiseSamples = std::stoi(argv[++i]);
+        } else if (arg == "--rt-dispatch-bench" && i + 1 < argc) {
+            raytracingDispatchFrames = std::stoi(argv[++i]);
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--frames" && i + 1 < argc) {
+            headlessFrames = std::stoi(argv[++i]);
+        } else if (arg == "--render-mode" && i + 1 < argc) {
+            renderMode = argv[++i];
+        } else if (arg == "--screenshot" && i + 1 < argc) {
+            screenshotPath = argv[++i];
+        } else if (arg == "--benchmark" && i + 1 < argc) {
+            benchmarkPath = argv[++i];
+        } else if (arg == "--benchmark-output" && i + 1 < argc) {
+            benchmarkOutputPath = argv[++i];
+        } else if (arg == "--record-input" && i + 1 < argc) {
+            recordInputPath = argv[++i];
+        } else if (arg == "--replay-input" && i + 1 < argc) {
+            replayInputPath = argv[++i];
+        } else if (arg == "--capture" && i + 1 < argc) {
+            capturePath = argv[++i];
+        } else if (arg == "--no-shadows") {
+            shadows = false;
+        } else if (arg == "--point-lights" && i + 1 < argc) {
+            pointLightCount = std::max(std::stoi(argv[++i]), 0);
+        } else if (arg == "--shadow-budget" && i + 1 < argc) {
+            shadowBudget = std::stoi(argv[++i]);
+        } else if (arg == "--rt-sampler" && i + 1 < argc) {
+            raytracingSamplerName = argv[++i];
+        } else if (arg == "--denoise" && i + 1 < argc) {
+            denoiseIterations = std::stoi(argv[++i]);
+        } else if (arg == "--rt-spp" && i + 1 < argc) {
+            raytracingSamples = std::max(std::stoi(argv[++i]), 1);
+        } else if (arg == "--rt-adaptive" && i + 1 < argc) {
+            adaptiveThreshold = std::stof(argv[++i]);
+        } else if (arg == "--rt-persistent" && i + 1 < argc) {
+            persistentGroups = std::max(std::stoi(argv[++i]), 0);
+        }
+    }
+    
+    // Scripted benchmark: fixed timestep, scripted camera and events, no live input
+    BenchmarkScript benchmarkScript;
+    bool benchmarking = !benchmarkPath.empty();
+    if (benchmarking && !benchmarkScript.load(benchmarkPath)) {
+        return -1;
+    }
+    if (benchmarking && renderMode.empty()) {
+        renderMode = benchmarkScript.getRenderMode();
+    }
+    if (benchmarking && (!recordInputPath.empty() || !replayInputPath.empty())) {
+        std::cerr << "--benchmark scripts replace live input and cannot be combined with input recording or replay" << std::endl;
         return -1;
     }
     
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // Headless runs render into an offscreen framebuffer and have no window or input
+    GLFWwindow* window = nullptr;
+    HeadlessContext headlessContext;
+    if (headless) {
+        if (!headlessContext.initialize(SCR_WIDTH, SCR_HEIGHT)) {
+            return -1;
+        }
+        if (!gladLoadGLLoader((GLADloadproc)HeadlessContext::getProcAddress)) {
+            std::cerr << "Failed to initialize GLAD" << std::endl;
+            return -1;
+        }
+        GraphicsManager::setProcAddressLoader((GLADloadproc)HeadlessContext::getProcAddress);
+        if (!headlessContext.createFramebuffer()) {
+            return -1;
+        }
+    } else {
+        // Initialize GLFW
+        if (!glfwInit()) {
+            std::cerr << "Failed to initialize GLFW" << std::endl;
+            return -1;
+        }
+        
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
 #ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
 
-    // Create window
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Vibe3D Game - Raytracing Edition", NULL, NULL);
-    if (window == NULL) {
-        std::cerr << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        // Create window
+        window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Vibe3D Game - Raytracing Edition", NULL, NULL);
+        if (window == NULL) {
+            std::cerr << "Failed to create GLFW window" << std::endl;
+            glfwTerminate();
+            return -1;
+        }
+        glfwMakeContextCurrent(window);
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-    // Initialize GLAD
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cerr << "Failed to initialize GLAD" << std::endl;
-        return -1;
+        // Initialize GLAD
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+            std::cerr << "Failed to initialize GLAD" << std::endl;
+            return -1;
+        }
     }
 
     // Initialize application
@@ -96,31 +225,144 @@ int main() {
         glfwTerminate();
         return -1;
     }
+    if (headless) {
+        graphics->setOutputFramebuffer(headlessContext.getFramebuffer());
+    }
+    graphics->setShadowsEnabled(shadows);
+    graphics->setPointShadowBudget(shadowBudget);
+    if (!raytracingSamplerName.empty()) {
+        if (raytracingSamplerName == "white") {
+            graphics->setRaytracingSampler(RaytracingSampler::WhiteNoise);
+        } else if (raytracingSamplerName == "sobol") {
+            graphics->setRaytracingSampler(RaytracingSampler::Sobol);
+        } else if (raytracingSamplerName == "bluenoise") {
+            graphics->setRaytracingSampler(RaytracingSampler::BlueNoise);
+        } else {
+            std::cerr << "Unknown raytracing sampler: " << raytracingSamplerName << " (available: white, sobol, bluenoise)" << std::endl;
+            cleanupApplication();
+            glfwTerminate();
+            return -1;
+        }
+    }
+    if (denoiseIterations >= 0) {
+        graphics->setDenoiseIterations(denoiseIterations);
+    }
+    if (adaptiveThreshold >= 0.0f) {
+        graphics->setAdaptiveErrorThreshold(adaptiveThreshold);
+    }
+    graphics->setRaytracingPersistentGroups(persistentGroups);
 
-    // Setup input
-    input->initialize(window);
-    
-    // Uncap framerate - disable V-Sync
-    glfwSwapInterval(0);
+    if (window) {
+        // Setup input
+        input->initialize(window);
+        
+        // Uncap framerate - disable V-Sync
+        glfwSwapInterval(0);
+    }
     
     // Print application info
     printApplicationInfo();
 
     // Configure OpenGL state
     glEnable(GL_DEPTH_TEST);
+    
+    // Mesh vs impostor sphere benchmark
+    if (sphereBenchmarkCount > 0) {
+        graphics->runSphereBenchmark(sphereBenchmarkCount, 10);
+        cleanupApplication();
+        glfwTerminate();
+        return 0;
+    }
+    
+    // Frame-time cost of weighted blended OIT per 1k transparent instances
+    if (transparencyBenchmarkCount > 0) {
+        graphics->runTransparencyBenchmark(transparencyBenchmarkCount, 10);
+        cleanupApplication();
+        glfwTerminate();
+        return 0;
+    }
+    
+    // GPU culling vs CPU reference check
+    if (cullingValidationCount > 0) {
+        bool passed = graphics->runCullingValidation(cullingValidationCount);
+        cleanupApplication();
+        glfwTerminate();
+        return passed ? 0 : 1;
+    }
+    
+    // Path tracer noise vs spp per light sampling strategy
+    if (raytracingNoiseSamples > 0) {
+        bool passed = graphics->runRaytracingNoiseBenchmark(raytracingNoiseSamples);
+        cleanupApplication();
+        glfwTerminate();
+        return passed ? 0 : 1;
+    }
+    
+    // Row-major grid vs persistent-thread raytracing dispatch
+    if (raytracingDispatchFrames > 0) {
+        bool passed = graphics->runRaytracingDispatchBenchmark(raytracingDispatchFrames);
+        cleanupApplication();
+        glfwTerminate();
+        return passed ? 0 : 1;
+    }
 
     // Application state
     AppState state;
+    state.pointLightCount = pointLightCount;
+    state.numSamples = raytracingSamples;
     
     // Check if raytracing is supported
     if (!graphics->isRaytracingSupported()) {
         state.useRaytracing = false;
     }
+    
+    if (!renderMode.empty() && !applyRenderMode(renderMode, state)) {
+        cleanupApplication();
+        glfwTerminate();
+        return -1;
+    }
+    
+    // Input log: recorded from the live session, or replayed in place of GLFW polling
+    if ((!replayInputPath.empty() && !input->startReplay(replayInputPath))
+        || (replayInputPath.empty() && !recordInputPath.empty() && !input->startRecording(recordInputPath))) {
+        cleanupApplication();
+        glfwTerminate();
+        return -1;
+    }
+    bool processInput = !benchmarking && (window || input->isReplaying());
+    
+    // Frame capture; benchmark captures play back at the scripted rate
+    int captureFrameRate = benchmarking ? static_cast<int>(1.0f / benchmarkScript.getDeltaTime() + 0.5f) : 60;
+    if (!capturePath.empty() && !graphics->startFrameCapture(capturePath, captureFrameRate)) {
+        cleanupApplication();
+        glfwTerminate();
+        return -1;
+    }
+    
+    if (!tracePath.empty()) {
+        state.tracePath = tracePath;
+        state.exportTraceOnExit = true;
+    }
+    CpuProfiler::setThreadName("Main thread");
 
-    // Main loop
-    while (!glfwWindowShouldClose(window)) {
-        // Calculate delta time
-        float currentFrame = static_cast<float>(glfwGetTime());
+    // Main loop; headless and benchmark runs stop after a fixed number of frames, replays at the end of the log
+    auto startTime = std::chrono::steady_clock::now();
+    int renderedFrames = 0;
+    int frameLimit = benchmarking ? benchmarkScript.getWarmupFrames() + benchmarkScript.getFrames()
+                   : window || input->isReplaying() ? -1 : headlessFrames;
+    std::vector<double> benchmarkFrameTimesMs;
+    while ((!window || !glfwWindowShouldClose(window)) && (frameLimit < 0 || renderedFrames < frameLimit)) {
+        CPU_PROFILE_SCOPE("Frame");
+        auto frameStart = std::chrono::steady_clock::now();
+        
+        // Calculate delta time (benchmarks advance the scene by a fixed step)
+        float currentFrame = benchmarking ? (renderedFrames + 1) * benchmarkScript.getDeltaTime()
+                           : window ? static_cast<float>(glfwGetTime())
+                           : std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+        if (processInput && !input->beginFrame(window, currentFrame)) {
+            std::cout << "Input replay finished after " << renderedFrames << " frames" << std::endl;
+            break;
+        }
         state.deltaTime = currentFrame - state.lastFrame;
         state.lastFrame = currentFrame;
         
@@ -132,18 +374,111 @@ int main() {
             state.fps = state.frameCount / state.fpsUpdateTimer;
             state.frameCount = 0;
             state.fpsUpdateTimer = 0.0f;
+            
+            // Culling statistics from the GPU-driven path, state switches from the sorted CPU path
+            if (graphics->isGpuCullingEnabled() && !state.useRaytracing) {
+                const OcclusionCullingStats& stats = graphics->getOcclusionStats();
+                std::cout << "Culling: " << stats.visibleCount << " visible, " << stats.frustumCulledCount
+                          << " outside frustum, " << stats.occludedCount << " occluded of " << stats.objectCount << std::endl;
+            } else if (!graphics->areSphereImpostorsEnabled() && !state.useRaytracing) {
+                const RenderQueueStats& stats = graphics->getRenderQueueStats();
+                std::cout << "Render queue: " << stats.drawCount << " draws, "
+                          << stats.programSwitches << " program / " << stats.materialSwitches << " material switches (unsorted "
+                          << stats.unsortedProgramSwitches << " / " << stats.unsortedMaterialSwitches << ")" << std::endl;
+            }
+            
+            const GLStateCacheStats& glStats = graphics->getGLStateStats();
+            std::cout << "GL state: " << glStats.issuedCalls << " calls issued, "
+                      << glStats.filteredCalls << " redundant calls filtered" << std::endl;
+
+            if (graphics->areShadowsEnabled() && !state.useRaytracing) {
+                const ShadowStats& shadowStats = graphics->getShadowStats();
+                std::cout << "Shadows: " << shadowStats.cascadesRendered << " cascades redrawn, "
+                          << shadowStats.cascadesReused << " reused, " << shadowStats.staticRebuilds << " static rebuilds, "
+                          << shadowStats.casterDraws << " caster draws" << std::endl;
+            }
+            if (graphics->arePointShadowsActive() && !state.useRaytracing) {
+                const PointShadowStats& pointStats = graphics->getPointShadowStats();
+                std::cout << "Point shadows: " << pointStats.tilesRendered << "/" << pointStats.budget << " tile budget, "
+                          << pointStats.tilesPending << " pending, " << pointStats.tilesReused << " reused, "
+                          << pointStats.shadowedLights << " lights in atlas (" << pointStats.tierTiles[0] << "/"
+                          << pointStats.tierTiles[1] << "/" << pointStats.tierTiles[2] << " per tier, "
+                          << static_cast<int>(pointStats.occupancy * 100.0f + 0.5f) << "% occupied), "
+                          << pointStats.unshadowedLights << " unshadowed" << std::endl;
+            }
+            
+            const StreamingBufferStats& streamStats = graphics->getStreamingStats();
+            std::cout << "Streaming: " << streamStats.frameBytes / 1024 << " KB/frame in " << streamStats.frameUploads
+                      << " uploads, " << static_cast<int>(streamStats.throughputMBps()) << " MB/s, "
+                      << streamStats.fenceWaits << " fence waits ("
+                      << (graphics->isStreamingPersistent() ? "persistent" : "unsynchronized") << ")" << std::endl;
+
+            if (graphics->getGpuProfiler().isSupported()) {
+                std::cout << graphics->getGpuProfiler().formatTimings() << std::endl;
+            }
         }
 
         // Update application
-        updateApplication(window, state);
+        if (benchmarking) {
+            applyBenchmarkFrame(benchmarkScript, state, state.lastFrame - state.deltaTime, state.lastFrame);
+        }
+        updateApplication(window, state, processInput);
         
         // Render application
         renderApplication(state);
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        // Headless frames end with glFinish so the measured frame time includes the GPU work
+        {
+            CPU_PROFILE_SCOPE("Swap buffers");
+            if (window) {
+                glfwSwapBuffers(window);
+            } else {
+                glFinish();
+            }
+        }
+        if (window) {
+            glfwPollEvents();
+        }
+        renderedFrames++;
+        
+        if (benchmarking) {
+            if (renderedFrames == benchmarkScript.getWarmupFrames()) {
+                graphics->resetGpuTimingTotals();
+            } else if (renderedFrames > benchmarkScript.getWarmupFrames()) {
+                benchmarkFrameTimesMs.push_back(
+                    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+            }
+        }
+    }
+    
+    if (benchmarking) {
+        FrameTimeSummary summary = BenchmarkScript::summarize(benchmarkFrameTimesMs);
+        std::string results = benchmarkScript.formatResults(summary, benchmarkFrameTimesMs.size(),
+                                                            graphics->getGpuProfiler(), renderMode, headless);
+        std::cout << results;
+        std::ofstream resultsFile(benchmarkOutputPath);
+        if (resultsFile.is_open() && (resultsFile << results)) {
+            std::cout << "Benchmark results written to " << benchmarkOutputPath << std::endl;
+        } else {
+            std::cerr << "Failed to write benchmark results to " << benchmarkOutputPath << std::endl;
+        }
+    }
+    
+    if (headless) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << "Headless run: " << renderedFrames << " frames in " << seconds << " s ("
+                  << (renderedFrames > 0 ? seconds * 1000.0 / renderedFrames : 0.0) << " ms/frame)" << std::endl;
+        if (!screenshotPath.empty()) {
+            headlessContext.writeScreenshot(screenshotPath);
+        }
     }
 
+#ifdef VIBE3D_PROFILING
+    if (state.exportTraceOnExit) {
+        CpuProfiler::exportChromeTrace(state.tracePath);
+    }
+#endif
+    
     // Cleanup
     cleanupApplication();
     glfwTerminate();
@@ -178,20 +513,69 @@ void cleanupApplication() {
     delete input;
 }
 
-void updateApplication(GLFWwindow* window, AppState& state) {
-    // Handle input
-    if (input->shouldExit(window)) {
-        glfwSetWindowShouldClose(window, true);
+void updateApplication(GLFWwindow* window, AppState& state, bool processInput) {
+    CPU_PROFILE_SCOPE("updateApplication");
+    
+    // Handle input (live or replayed; headless and benchmark runs otherwise have none)
+    if (processInput && !handleInput(window, state)) {
         return;
     }
     
+    // Update physics
+    physics->updatePhysics(state.deltaTime);
+    
+    // Update camera physics (only in non-raytracing mode for simplicity)
+    if (!state.useRaytracing) {
+        physics->updateCameraPhysics(state.cameraPos, state.verticalVelocity, state.isGrounded, state.deltaTime);
+    }
+    
+    // Update main object physics
+    physics->updateMainObject(state.mainObjectPos, state.deltaTime);
+    
+    // Update graphics lighting
+    graphics->setLightProperties(state.lightPos, state.lightColor);
+    updatePointLights(state);
+    graphics->setPointLights(state.pointLights);
+}
+
+// Rings of colored point lights above the floor; the scene time drives the orbiting ones, so
+// benchmark runs see the same motion
+void updatePointLights(AppState& state) {
+    state.pointLights.resize(state.pointLightCount);
+    for (int i = 0; i < state.pointLightCount; i++) {
+        float ring = static_cast<float>(i % 3);
+        float angle = glm::two_pi<float>() * i / state.pointLightCount + 0.4f * ring;
+        if (i % 4 == 3) {
+            angle += 0.5f * state.lastFrame;
+        }
+        float hue = static_cast<float>(i) / state.pointLightCount;
+        
+        PointLight& light = state.pointLights[i];
+        light.position = glm::vec3(std::cos(angle) * (2.5f + 2.0f * ring), 0.6f + 0.4f * (i % 2), std::sin(angle) * (2.5f + 2.0f * ring));
+        light.radius = 5.0f;
+        light.color = glm::vec3(0.5f + 0.5f * std::cos(glm::two_pi<float>() * hue),
+                                0.5f + 0.5f * std::cos(glm::two_pi<float>() * (hue + 1.0f / 3.0f)),
+                                0.5f + 0.5f * std::cos(glm::two_pi<float>() * (hue + 2.0f / 3.0f)));
+        light.intensity = 1.5f;
+    }
+}
+
+// Returns false once the user asked to exit
+bool handleInput(GLFWwindow* window, AppState& state) {
+    if (input->shouldExit()) {
+        if (window) {
+            glfwSetWindowShouldClose(window, true);
+        }
+        return false;
+    }
+    
     // Material cycling
-    if (input->shouldCycleMaterial(window)) {
+    if (input->shouldCycleMaterial()) {
         materials->cycleMaterial();
     }
     
     // Raytracing toggle
-    if (input->shouldToggleRaytracing(window)) {
+    if (input->shouldToggleRaytracing()) {
         if (graphics->isRaytracingSupported()) {
             state.useRaytracing = !state.useRaytracing;
             std::cout << "Raytracing " << (state.useRaytracing ? "enabled" : "disabled") << std::endl;
@@ -200,29 +584,64 @@ void updateApplication(GLFWwindow* window, AppState& state) {
         }
     }
     
+    // Sphere impostor toggle
+    if (input->shouldToggleImpostors()) {
+        graphics->setSphereImpostorsEnabled(!graphics->areSphereImpostorsEnabled());
+        std::cout << "Sphere impostors " << (graphics->areSphereImpostorsEnabled() ? "enabled" : "disabled") << std::endl;
+    }
+    
+    // GPU-driven culling toggle
+    if (input->shouldToggleGpuCulling()) {
+        if (graphics->isGpuCullingSupported()) {
+            graphics->setGpuCullingEnabled(!graphics->isGpuCullingEnabled());
+            std::cout << "GPU-driven culling " << (graphics->isGpuCullingEnabled() ? "enabled" : "disabled") << std::endl;
+        } else {
+            std::cout << "GPU-driven culling not supported on this system" << std::endl;
+        }
+    }
+    
+    // Hi-Z occlusion culling toggle (applies to GPU-driven culling)
+    if (input->shouldToggleOcclusionCulling()) {
+        if (graphics->isHiZOcclusionSupported()) {
+            graphics->setHiZOcclusionEnabled(!graphics->isHiZOcclusionEnabled());
+            std::cout << "Hi-Z occlusion culling " << (graphics->isHiZOcclusionEnabled() ? "enabled" : "disabled") << std::endl;
+        } else {
+            std::cout << "Hi-Z occlusion culling not supported on this system" << std::endl;
+        }
+    }
+    
+    // CPU trace export
+    if (input->shouldExportTrace()) {
+#ifdef VIBE3D_PROFILING
+        CpuProfiler::exportChromeTrace(state.tracePath);
+#else
+        std::cout << "CPU profiling scopes are compiled out (configure with -DVIBE3D_PROFILING=ON)" << std::endl;
+#endif
+    }
+    
     // Exposure controls
-    if (input->shouldIncreaseExposure(window)) {
+    if (input->shouldIncreaseExposure()) {
         state.exposure *= 1.02f;
         std::cout << "Exposure: " << state.exposure << std::endl;
     }
-    if (input->shouldDecreaseExposure(window)) {
+    if (input->shouldDecreaseExposure()) {
         state.exposure *= 0.98f;
         std::cout << "Exposure: " << state.exposure << std::endl;
     }
     
     // Camera movement
-    glm::vec3 cameraMovement = input->getCameraMovement(window, state.deltaTime);
+    glm::vec3 cameraMovement = input->getCameraMovement(state.deltaTime);
     state.cameraPos += cameraMovement;
     
     // Jumping mechanics
-    if (input->shouldJump(window) && state.isGrounded) {
+    if (input->shouldJump() && state.isGrounded) {
         state.verticalVelocity = 5.0f; // Jump force
         state.isGrounded = false;
     }
     
     // Shooting
-    if (input->shouldShoot(window)) {
-        float currentTime = static_cast<float>(glfwGetTime());
+    if (input->shouldShoot()) {
+        float currentTime = state.lastFrame;    // frame time, so replays fire identically
         if (physics->canShoot(currentTime)) {
             glm::vec3 bulletPos = state.cameraPos + input->getCameraFront() * 0.5f;
             physics->shootBullet(bulletPos, input->getCameraFront());
@@ -231,32 +650,71 @@ void updateApplication(GLFWwindow* window, AppState& state) {
     }
     
     // Spawn cubes
-    if (input->shouldSpawnCube(window)) {
+    if (input->shouldSpawnCube()) {
         glm::vec3 spawnPos = state.cameraPos + input->getCameraFront() * 3.0f;
         glm::vec3 spawnVel = input->getCameraFront() * 5.0f;
         physics->spawnCube(spawnPos, spawnVel);
     }
     
-    // Update physics
-    physics->updatePhysics(state.deltaTime);
-    
-    // Update camera physics (only in non-raytracing mode for simplicity)
-    if (!state.useRaytracing) {
-        physics->updateCameraPhysics(state.cameraPos, state.verticalVelocity, state.isGrounded, state.deltaTime);
+    return true;
+}
+
+// Scripted camera pose and the events between the previous and the current scene time
+void applyBenchmarkFrame(const BenchmarkScript& script, AppState& state, float previousTime, float time) {
+    float yaw, pitch;
+    if (script.sampleCamera(time, state.cameraPos, yaw, pitch)) {
+        input->setCameraOrientation(yaw, pitch);
     }
     
-    // Update main object physics
-    physics->updateMainObject(state.mainObjectPos, state.deltaTime);
-    
-    // Update graphics lighting
-    graphics->setLightProperties(state.lightPos, state.lightColor);
+    std::vector<BenchmarkEventType> events;
+    script.collectEvents(previousTime, time, events);
+    for (BenchmarkEventType event : events) {
+        switch (event) {
+        case BenchmarkEventType::SpawnCube:
+            physics->spawnCube(state.cameraPos + input->getCameraFront() * 3.0f, input->getCameraFront() * 5.0f);
+            break;
+        case BenchmarkEventType::Shoot:
+            physics->shootBullet(state.cameraPos + input->getCameraFront() * 0.5f, input->getCameraFront());
+            physics->updateLastShotTime(time);
+            break;
+        case BenchmarkEventType::CycleMaterial:
+            materials->cycleMaterial();
+            break;
+        }
+    }
+}
+
+// --render-mode: raytracing, forward or forward-plus
+bool applyRenderMode(const std::string& mode, AppState& state) {
+    if (mode == "raytracing") {
+        if (!graphics->isRaytracingSupported()) {
+            std::cerr << "Render mode raytracing needs compute shader support" << std::endl;
+            return false;
+        }
+        state.useRaytracing = true;
+    } else if (mode == "forward") {
+        state.useRaytracing = false;
+    } else if (mode == "forward-plus") {
+        if (!graphics->enableForwardPlus()) {
+            return false;
+        }
+        state.useRaytracing = false;
+    } else {
+        std::cerr << "Unknown render mode: " << mode << " (available: raytracing, forward, forward-plus)" << std::endl;
+        return false;
+    }
+    std::cout << "Render mode: " << mode << std::endl;
+    return true;
 }
 
 void renderApplication(const AppState& state) {
+    CPU_PROFILE_SCOPE("renderApplication");
+    
+    // Every mode draws (or counts) the same sphere list
+    std::vector<RTSphere> rtSpheres = buildRaytracingScene(state);
+    
     if (graphics->useModernRenderer()) {
         // Modern Vulkan-based Forward+ with Ray Tracing
-        std::vector<RTSphere> rtSpheres = buildRaytracingScene(state);
-        
         glm::vec3 cameraFront = input->getCameraFront();
         glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
         glm::vec3 cameraRight = glm::normalize(glm::cross(cameraFront, cameraUp));
@@ -267,8 +725,6 @@ void renderApplication(const AppState& state) {
                               state.mainObjectPos, materials->getCurrentMaterial());
     } else if (state.useRaytracing && graphics->isRaytracingSupported()) {
         // Legacy OpenGL raytracing mode
-        std::vector<RTSphere> rtSpheres = buildRaytracingScene(state);
-        
         glm::vec3 cameraFront = input->getCameraFront();
         glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
         glm::vec3 cameraRight = glm::normalize(glm::cross(cameraFront, cameraUp));
@@ -286,18 +742,27 @@ void renderApplication(const AppState& state) {
         glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
         
         // Use the Forward+ rendering pipeline (automatically falls back to traditional forward if not supported)
-        std::vector<RTSphere> rtSpheres = buildRaytracingScene(state); // Reuse for object data
         graphics->renderForwardPlusPass(view, projection, rtSpheres, physics->getCubes(), physics->getBullets(),
                                        state.mainObjectPos, materials->getCurrentMaterial());
-        
-        graphics->endFrame();
     }
     
-    // Render FPS overlay (always visible in all modes)
-    graphics->renderFPS(state.fps, state.deltaTime);
+    // Captured before the overlay so the images hold no timings and can be compared across runs
+    graphics->captureFrame();
+    
+    // Stats overlay (always visible in all modes); point lights only light the Forward+ path
+    OverlayStats overlayStats;
+    overlayStats.fps = state.fps;
+    overlayStats.deltaTime = state.deltaTime;
+    overlayStats.objectCount = rtSpheres.size();
+    overlayStats.lightCount = 1 + graphics->getPointLightCount();
+    graphics->renderStatsOverlay(overlayStats);
+    
+    graphics->endFrame();
 }
 
 std::vector<RTSphere> buildRaytracingScene(const AppState& state) {
+    CPU_PROFILE_SCOPE("buildRaytracingScene");
+    
     std::vector<RTSphere> rtSpheres;
     
     // Add main sphere
@@ -361,6 +826,10 @@ void printApplicationInfo() {
     std::cout << "Left Click - Shoot bullets" << std::endl;
     std::cout << "E - Spawn spheres" << std::endl;
     std::cout << "M - Cycle through materials" << std::endl;
+    std::cout << "I - Toggle ray-cast sphere impostors" << std::endl;
+    std::cout << "G - Toggle GPU-driven culling" << std::endl;
+    std::cout << "O - Toggle Hi-Z occlusion culling" << std::endl;
+    std::cout << "T - Export CPU trace (Chrome trace-event JSON)" << std::endl;
     
     if (graphics->isRaytracingSupported()) {
         std::cout << "R - Toggle raytracing mode" << std::endl;
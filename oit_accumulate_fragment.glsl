@@ -0,0 +1,41 @@
+#version 330 core
+
+// Weighted blended order-independent transparency (McGuire, Bavoil 2013), accumulation pass.
+// Blending is ONE/ONE on rgb and ZERO/ONE_MINUS_SRC_ALPHA on alpha for both targets:
+//   accumulation.rgb = sum(color * alpha * weight), accumulation.a = product(1 - alpha) (revealage)
+//   weightSum.r      = sum(alpha * weight)
+layout (location = 0) out vec4 accumulation;
+layout (location = 1) out vec4 weightSum;
+
+in vec3 FragPos;
+in vec3 Normal;
+flat in vec4 ObjectColor;
+
+uniform vec3 lightPos;
+uniform vec3 viewPos;
+uniform vec3 lightColor;
+
+void main()
+{
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    
+    vec3 ambient = 0.2 * lightColor;
+    vec3 diffuse = max(dot(norm, lightDir), 0.0) * lightColor;
+    vec3 specular = 0.8 * pow(max(dot(norm, halfwayDir), 0.0), 64.0) * lightColor;
+    vec3 color = (ambient + diffuse) * ObjectColor.rgb + specular;
+    
+    // Glass gets more opaque towards grazing angles
+    float fresnel = pow(1.0 - abs(dot(norm, viewDir)), 3.0);
+    float alpha = clamp(mix(ObjectColor.a, 1.0, fresnel * 0.6), 0.0, 1.0);
+    
+    // Depth weight (paper eq. 10): nearer and more opaque surfaces dominate the average.
+    // The clamp keeps the sums inside half-float range.
+    float z = gl_FragCoord.z;
+    float weight = clamp(pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - z * 0.9, 3.0), 1e-2, 3e3);
+    
+    accumulation = vec4(color * alpha * weight, alpha);
+    weightSum = vec4(alpha * weight);
+}
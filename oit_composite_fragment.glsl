@@ -0,0 +1,25 @@
+#version 330 core
+
+// Resolves the weighted blended accumulation over the opaque image
+// (blended with SRC_ALPHA / ONE_MINUS_SRC_ALPHA)
+out vec4 FragColor;
+
+uniform sampler2D accumulationTexture;
+uniform sampler2D weightTexture;
+
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    vec4 accumulation = texelFetch(accumulationTexture, texel, 0);
+    float revealage = accumulation.a;
+    
+    // No transparent surface covered this pixel
+    if (revealage >= 1.0) {
+        discard;
+    }
+    
+    float weightSum = texelFetch(weightTexture, texel, 0).r;
+    vec3 averageColor = accumulation.rgb / max(weightSum, 1e-5);
+    
+    FragColor = vec4(averageColor, 1.0 - revealage);
+}
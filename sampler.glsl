@@ -0,0 +1,105 @@
+// Random numbers for raytracing.comp, included after the uniforms it shares (frameIndex,
+// numSamples). A sample draws its numbers by dimension: the camera jitter takes the first
+// SAMPLER_CAMERA_DIMENSIONS, and bounce b starts its own block of SAMPLER_BOUNCE_DIMENSIONS,
+// so the same decision at the same depth always reads the same dimension across samples.
+//   White noise: PCG hash of pixel, sample and frame, dimensions ignored
+//   Sobol:       Owen-scrambled Sobol (0,2)-sequence per pair of dimensions, each pair and
+//                pixel shuffled with its own seed (Burley 2020); reseeded every frame
+//   Blue noise:  a tiled void-and-cluster pattern, offset per dimension by the R2 sequence
+//                and rotated per sample along R2, each pair of dimensions as one 2D point
+
+const int SAMPLER_WHITE_NOISE = 0;
+const int SAMPLER_SOBOL = 1;
+const int SAMPLER_BLUE_NOISE = 2;
+uniform int samplerType = SAMPLER_SOBOL;
+uniform sampler2D blueNoise;
+
+const int BLUE_NOISE_SIZE = 64;    // BlueNoiseTexture::SIZE
+const uint SAMPLER_CAMERA_DIMENSIONS = 2u;
+// Light sample 2, BSDF sample 2, lobe or Fresnel choice 1, Russian roulette 1, with room
+const uint SAMPLER_BOUNCE_DIMENSIONS = 8u;
+
+// Set by beginSample (initialized so the compiler sees no uninitialized reads)
+ivec2 samplerPixel = ivec2(0);
+uint samplerIndex = 0u;
+uint samplerDimension = 0u;
+uint samplerSeed = 0u;
+uint rngState = 0u;
+
+uint pcgHash(uint value) {
+    uint state = value * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+// Bijective hash that only carries into higher bits; on reversed bits it is an Owen scramble
+uint laineKarrasPermutation(uint x, uint seed) {
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return x;
+}
+
+uint nestedUniformScramble(uint x, uint seed) {
+    return bitfieldReverse(laineKarrasPermutation(bitfieldReverse(x), seed));
+}
+
+// Second Sobol dimension: its generator matrix is Pascal's triangle mod 2
+uint sobolSecondDimension(uint index) {
+    uint result = 0u;
+    for (uint direction = 0x80000000u; index != 0u; index >>= 1, direction ^= direction >> 1) {
+        if ((index & 1u) != 0u) {
+            result ^= direction;
+        }
+    }
+    return result;
+}
+
+float sobolSample(uint dimension) {
+    uint pairSeed = pcgHash(samplerSeed ^ pcgHash(dimension >> 1));
+    uint index = nestedUniformScramble(samplerIndex, pairSeed);
+    uint value = (dimension & 1u) == 0u ? bitfieldReverse(index) : sobolSecondDimension(index);
+    return float(nestedUniformScramble(value, pcgHash(pairSeed + 1u + (dimension & 1u))) >> 8) / 16777216.0;
+}
+
+float blueNoiseSample(uint dimension) {
+    // R2 offsets move every dimension to an unrelated part of the tile
+    vec2 offset = fract(vec2(float(dimension)) * vec2(0.7548776662, 0.5698402910));
+    ivec2 texel = (samplerPixel + ivec2(offset * float(BLUE_NOISE_SIZE))) & (BLUE_NOISE_SIZE - 1);
+    float value = texelFetch(blueNoise, texel, 0).r;
+    // R2 steps in 0.32 fixed point: blue over the screen, evenly spread over samples. A single
+    // golden-ratio step would move both dimensions of a pair along the same diagonal. Each pair
+    // takes the samples in its own order, the same for every pixel so a sample stays blue over
+    // the screen; in one shared order all pairs would step in lockstep and correlate across
+    // bounces. The scramble keeps the first 2^k indices, so power-of-two spp stay stratified.
+    uint sampleOrder = nestedUniformScramble(samplerIndex, pcgHash(uint(frameIndex) ^ pcgHash(dimension >> 1)));
+    uint sequenceIndex = uint(frameIndex) * uint(max(numSamples, 1)) + sampleOrder;
+    uint increment = (dimension & 1u) == 0u ? 3242174889u : 2447445414u;
+    return fract(value + float((sequenceIndex * increment) >> 8) / 16777216.0);
+}
+
+void beginSample(ivec2 pixel, int sampleIndex) {
+    samplerPixel = pixel;
+    samplerIndex = uint(sampleIndex);
+    samplerDimension = 0u;
+    samplerSeed = pcgHash(uint(pixel.x) + pcgHash(uint(pixel.y) + pcgHash(uint(frameIndex))));
+    rngState = pcgHash(samplerSeed + pcgHash(uint(sampleIndex)));
+}
+
+void beginBounce(int bounce) {
+    samplerDimension = SAMPLER_CAMERA_DIMENSIONS + uint(bounce) * SAMPLER_BOUNCE_DIMENSIONS;
+}
+
+float random() {
+    uint dimension = samplerDimension++;
+    if (samplerType == SAMPLER_SOBOL) {
+        return sobolSample(dimension);
+    }
+    if (samplerType == SAMPLER_BLUE_NOISE) {
+        return blueNoiseSample(dimension);
+    }
+    rngState = pcgHash(rngState);
+    return float(rngState >> 8) / 16777216.0;
+}
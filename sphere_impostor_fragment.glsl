@@ -0,0 +1,51 @@
+#version 430 core
+
+// Ray-cast depth is always behind the impostor quad
+layout (depth_greater) out float gl_FragDepth;
+out vec4 FragColor;
+
+in vec3 ViewPos;
+flat in vec4 SphereView;
+flat in vec3 Albedo;
+flat in vec4 Specular;
+
+uniform mat4 projection;
+uniform vec3 lightPosView;
+uniform vec3 lightColor;
+
+void main()
+{
+    // Analytic ray-sphere intersection in view space (eye at origin)
+    vec3 rayDir = normalize(ViewPos);
+    vec3 center = SphereView.xyz;
+    float radius = SphereView.w;
+    
+    float b = dot(rayDir, center);
+    float c = dot(center, center) - radius * radius;
+    float discriminant = b * b - c;
+    if (discriminant < 0.0) {
+        discard;
+    }
+    
+    float t = b - sqrt(discriminant);
+    vec3 hitPos = rayDir * t;
+    vec3 normal = (hitPos - center) / radius;
+    
+    // Write the depth of the actual surface point
+    vec4 clipPos = projection * vec4(hitPos, 1.0);
+    float ndcDepth = clipPos.z / clipPos.w;
+    gl_FragDepth = (gl_DepthRange.diff * ndcDepth + gl_DepthRange.near + gl_DepthRange.far) * 0.5;
+    
+    // Blinn-Phong shading
+    vec3 lightDir = normalize(lightPosView - hitPos);
+    vec3 viewDir = -rayDir;
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    
+    vec3 ambient = 0.1 * Albedo;
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor * Albedo;
+    float spec = pow(max(dot(normal, halfwayDir), 0.0), max(Specular.a, 1.0));
+    vec3 specular = spec * lightColor * Specular.rgb;
+    
+    FragColor = vec4(ambient + diffuse + specular, 1.0);
+}
@@ -0,0 +1,49 @@
+#version 430 core
+
+// Per-vertex: quad corner in [-1, 1]
+layout (location = 0) in vec2 aCorner;
+
+// Per-instance sphere data
+layout (location = 1) in vec4 aCenterRadius;  // World-space center, radius
+layout (location = 2) in vec4 aAlbedo;        // Albedo, unused
+layout (location = 3) in vec4 aSpecular;      // Specular color, shininess
+
+out vec3 ViewPos;
+flat out vec4 SphereView;
+flat out vec3 Albedo;
+flat out vec4 Specular;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    vec3 center = (view * vec4(aCenterRadius.xyz, 1.0)).xyz;
+    float radius = aCenterRadius.w;
+    float dist = length(center);
+    
+    SphereView = vec4(center, radius);
+    Albedo = aAlbedo.rgb;
+    Specular = aSpecular;
+    
+    // Camera inside the sphere: collapse the quad
+    if (dist <= radius * 1.001) {
+        ViewPos = vec3(0.0);
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+        return;
+    }
+    
+    // Quad faces the eye and touches the front of the sphere, so every depth the
+    // fragment shader writes is behind the quad (keeps conservative early-Z valid)
+    vec3 toCenter = center / dist;
+    vec3 up = abs(toCenter.y) < 0.999 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
+    vec3 right = normalize(cross(up, toCenter));
+    up = cross(toCenter, right);
+    
+    // Size the quad to the tangent cone from the eye at the front plane
+    float frontDist = dist - radius;
+    float halfSize = frontDist * radius / sqrt(dist * dist - radius * radius);
+    
+    ViewPos = toCenter * frontDist + (aCorner.x * right + aCorner.y * up) * halfSize;
+    gl_Position = projection * vec4(ViewPos, 1.0);
+}
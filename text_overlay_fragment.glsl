@@ -0,0 +1,17 @@
+#version 330 core
+in vec2 TexCoord;
+in vec4 Color;
+
+out vec4 FragColor;
+
+// R8 coverage: glyph pixels are 1, the rest 0 (rectangles sample a solid cell)
+uniform sampler2D fontAtlas;
+
+void main()
+{
+    float coverage = texture(fontAtlas, TexCoord).r;
+    if (coverage == 0.0) {
+        discard;
+    }
+    FragColor = vec4(Color.rgb, Color.a * coverage);
+}
@@ -45,6 +45,76 @@ layout(std430, binding = 2) readonly buffer LightListBuffer {
 };
 
 const uint MAX_LIGHTS_PER_TILE = 1024;
+// Light 0 is the main light, shadowed by the cascades; the point lights after it may hold
+// a tile in the point shadow atlas
+const uint MAIN_LIGHT_INDEX = 0u;
+
+// Cascaded shadow map of the main light (CascadedShadowMaps); no cascades means unshadowed
+const int MAX_SHADOW_CASCADES = 3;
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 shadowMatrices[MAX_SHADOW_CASCADES];
+uniform float shadowTexelSizes[MAX_SHADOW_CASCADES];
+uniform int shadowCascadeCount;
+
+// Fraction of the main light reaching worldPos, from the finest cascade that covers it
+float mainLightShadow(vec3 worldPos, vec3 normal) {
+    for (int cascade = 0; cascade < shadowCascadeCount; cascade++) {
+        // A normal offset of a texel and a half keeps curved surfaces free of acne
+        vec4 coord = shadowMatrices[cascade] * vec4(worldPos + normal * shadowTexelSizes[cascade] * 1.5, 1.0);
+        if (all(greaterThan(coord.xyz, vec3(0.0))) && all(lessThan(coord.xyz, vec3(1.0)))) {
+            // Four bilinear compare taps, 4x4 texel PCF footprint
+            float texel = 1.0 / float(textureSize(shadowMap, 0).x);
+            float lit = 0.0;
+            lit += texture(shadowMap, vec4(coord.xy + vec2(-texel, -texel), float(cascade), coord.z));
+            lit += texture(shadowMap, vec4(coord.xy + vec2( texel, -texel), float(cascade), coord.z));
+            lit += texture(shadowMap, vec4(coord.xy + vec2(-texel,  texel), float(cascade), coord.z));
+            lit += texture(shadowMap, vec4(coord.xy + vec2( texel,  texel), float(cascade), coord.z));
+            return lit * 0.25;
+        }
+    }
+    return 1.0;
+}
+
+// Point light shadows (PointShadowAtlas): one record per light, six cube faces in a 3x2 tile
+struct PointShadow {
+    mat4 faceMatrices[6];    // world to atlas coordinates and depth
+    vec4 tileRect;           // xy tile origin, zw size of one face
+    vec4 params;             // x 1 if the tile holds a shadow, y face texel angle
+};
+
+layout(std430, binding = 3) readonly buffer PointShadowBuffer {
+    PointShadow pointShadows[];
+};
+
+uniform sampler2DShadow pointShadowMap;
+uniform int pointShadowCount;
+
+// Fraction of point light lightIndex reaching worldPos; lights without a tile are unshadowed
+float pointLightShadow(uint lightIndex, vec3 lightPos, vec3 worldPos, vec3 normal) {
+    if (int(lightIndex) >= pointShadowCount || pointShadows[lightIndex].params.x == 0.0) {
+        return 1.0;
+    }
+    // Texels grow with distance along the face axis; offset by a texel and a half of that size
+    vec3 axis = abs(worldPos - lightPos);
+    float faceDistance = max(axis.x, max(axis.y, axis.z));
+    vec3 samplePos = worldPos + normal * (1.5 * pointShadows[lightIndex].params.y * faceDistance);
+
+    // Cube face by major axis, +X -X +Y -Y +Z -Z
+    vec3 toSample = samplePos - lightPos;
+    axis = abs(toSample);
+    int face = axis.x >= axis.y && axis.x >= axis.z ? (toSample.x > 0.0 ? 0 : 1)
+             : axis.y >= axis.z ? (toSample.y > 0.0 ? 2 : 3)
+             : (toSample.z > 0.0 ? 4 : 5);
+    vec4 coord = pointShadows[lightIndex].faceMatrices[face] * vec4(samplePos, 1.0);
+    coord.xyz /= coord.w;
+
+    // The bilinear footprint stays inside the face so it never reads a neighbouring face
+    vec4 tileRect = pointShadows[lightIndex].tileRect;
+    vec2 faceMin = tileRect.xy + vec2(float(face % 3), float(face / 3)) * tileRect.zw;
+    vec2 halfTexel = 0.5 / vec2(textureSize(pointShadowMap, 0));
+    coord.xy = clamp(coord.xy, faceMin + halfTexel, faceMin + tileRect.zw - halfTexel);
+    return texture(pointShadowMap, vec3(coord.xy, min(coord.z, 1.0)));
+}
 
 void main()
 {
@@ -67,6 +137,7 @@ void main()
     
     // Start with ambient lighting
     vec3 result = ambient * albedo;
+    float mainShadow = mainLightShadow(FragPos, norm);
     
     // Add contribution from each light in this tile
     for (uint i = 0; i < numLightsInTile && i < MAX_LIGHTS_PER_TILE; ++i) {
@@ -95,7 +166,9 @@ void main()
         vec3 specularContrib = spec * light.color * specular;
         
         // Add light contribution
-        result += (diffuse + specularContrib) * attenuation;
+        float shadow = lightIndex == MAIN_LIGHT_INDEX ? mainShadow
+                     : pointLightShadow(lightIndex, light.position, FragPos, norm);
+        result += (diffuse + specularContrib) * attenuation * shadow;
     }
     
     // If no lights in tile, add a basic light to avoid pure ambient